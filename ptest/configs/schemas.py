@@ -16,6 +16,19 @@ config_schema = {
                     "dependencies" : {"run_mode" : ["native"]}, 
                     "excludes" : ["port", "baud_rate"]
                 },
+                "virtual_clock" : {
+                    "type" : "boolean",
+                    "dependencies" : {"run_mode" : ["native"]}
+                },
+                "calibrate_offsets" : {
+                    "type" : "object",
+                    "properties" : {
+                        "cycles" : {"type" : "integer", "minimum" : 1},
+                        "header" : {"type" : "string"}
+                    },
+                    "required" : ["cycles", "header"],
+                    "dependencies" : {"run_mode" : ["native"]}
+                },
                 "port" : {
                     "type" : "string",
                     "dependencies" : {"run_mode" : ["teensy"]},
@@ -89,7 +89,13 @@ class SimulationRun(object):
                     if "CI" in os.environ:
                         cwd = os.path.join(os.path.dirname(os.path.realpath(__file__)), "..")
                         binary_filepath = os.path.join(cwd, binary_filepath)
-                    binary_process = subprocess.Popen(binary_filepath, stdout=master_fd, stderr=master_fd, stdin=master_fd)
+                    binary_args = [binary_filepath]
+                    if device.get('virtual_clock'):
+                        binary_args.append('--virtual-clock')
+                    if 'calibrate_offsets' in device:
+                        calibration = device['calibrate_offsets']
+                        binary_args += ['--calibrate', str(calibration['cycles']), calibration['header']]
+                    binary_process = subprocess.Popen(binary_args, stdout=master_fd, stderr=master_fd, stdin=master_fd)
                     self.binaries.append({
                         "device_name" : device["name"],
                         "subprocess": binary_process,
@@ -179,10 +179,9 @@ class Simulation(object):
         magnetometer_body = ",".join(["%.9f" % x[0] for x in sensor_readings["magnetometer_body"]])
 
         # Send values to flight software
-        flight_controller.write_state("piksi.time", str(current_gps_time))
-        flight_controller.write_state("piksi.pos", position_ecef)
-        flight_controller.write_state("adcs_monitor.ssa_vec", sat2sun_body)
-        flight_controller.write_state("adcs_monitor.mag_vec", magnetometer_body)
+        flight_controller.write_states(
+            ["piksi.time", "piksi.pos", "adcs_monitor.ssa_vec", "adcs_monitor.mag_vec"],
+            [str(current_gps_time), position_ecef, sat2sun_body, magnetometer_body])
 
     def read_adcs_estimator_outputs(self, flight_controller):
         """
@@ -192,8 +191,7 @@ class Simulation(object):
         by calling read_state.
         """
 
-        flight_controller.read_state("attitude_estimator.q_body_eci")
-        flight_controller.read_state("attitude_estimator.w_body")
+        flight_controller.read_states(["attitude_estimator.q_body_eci", "attitude_estimator.w_body"])
 
     def stop(self, data_dir):
         """
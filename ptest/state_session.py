@@ -58,6 +58,7 @@ class StateSession(object):
             # Queues used to manage interface between the check_msgs_thread and calls to read_state or write_state
             self.field_requests = queue.Queue()
             self.field_responses = queue.Queue()
+            self.bulk_responses = queue.Queue()
 
             self.datastore.start()
             self.logger.start()
@@ -96,6 +97,15 @@ class StateSession(object):
                     # The logline represents a debugging message created by Flight Software. Report the message to the logger.
                     logline = f"[{data['time']}] ({data['svrty']}) {data['msg']}"
                     self.logger.put(logline, add_time = False)
+                elif 'fields' in data:
+                    # Response to a bulk read or write. Record each field in the telemetry log
+                    # the same way as a response to a single read or write.
+                    for field, val in data['fields'].items():
+                        self.datastore.put({'t': data['t'], 'time': data['time'], 'field': field, 'val': val})
+                    for field, err in data.get('errs', {}).items():
+                        logline = f"[{data['time']}] (ERROR) Tried to access state value named \"{field}\" but encountered an error: {err}"
+                        self.logger.put(logline, add_time = False)
+                    self.bulk_responses.put(data)
                 elif 'telem' in data:
                     logline = f"[{data['time']}] Received requested telemetry from spacecraft.\n"
                     logline += data['telem']
@@ -157,6 +167,64 @@ class StateSession(object):
 
         return self._wait_for_state(field)
 
+    def _bulk_cmd(self, json_cmd, timeout = None):
+        '''
+        Sends a bulk read or write command, and waits for the response.
+
+        Returns a dict of the fields that were read or written to their values, or None
+        if there was no response.
+        '''
+        if not self.running_logger: return
+
+        json_cmd = json.dumps(json_cmd) + "\n"
+        if len(json_cmd) >= 512:
+            print("Error: Flight Software can't handle input buffers >= 512 bytes.")
+            return None
+
+        self.device_write_lock.acquire()
+        self.console.write(json_cmd.encode())
+        self.device_write_lock.release()
+        self.raw_logger.put("Sent:     " + json_cmd.rstrip())
+
+        try:
+            return self.bulk_responses.get(True, timeout)['fields']
+        except queue.Empty:
+            return None
+
+    def read_states(self, fields = None, group = None, timeout = None):
+        '''
+        Read several states in one round trip.
+
+        Reads the state fields with the given names, or if no names are given, every field
+        in the given group (e.g. "adcs_monitor"), or if there is no group, every readable
+        field. Returns a dict of field names to values; fields that couldn't be read are
+        left out.
+        '''
+        json_cmd = {'mode': ord('R')}
+        if fields is not None:
+            json_cmd['fields'] = [str(field) for field in fields]
+        elif group is not None:
+            json_cmd['group'] = str(group)
+        return self._bulk_cmd(json_cmd, timeout)
+
+    def write_states(self, fields, vals, timeout = None):
+        '''
+        Write several states in one round trip.
+
+        Overwrites the values of the state fields with the given names, except for fields
+        that are being overriden by the user. Returns a dict of the fields that were written
+        to their new values, as reported by the flight computer.
+        '''
+        field_val_pairs = [
+            (str(field), self._val_to_str(val) if type(val) in (list, tuple, bool) else str(val))
+            for field, val in zip(fields, vals)
+            if field not in self.overriden_variables
+        ]
+        if not field_val_pairs:
+            return {}
+        fields, vals = zip(*field_val_pairs)
+        return self._bulk_cmd({'mode': ord('W'), 'fields': list(fields), 'vals': list(vals)}, timeout)
+
     def _write_state_basic(self, fields, vals, timeout = None):
         '''
         Write multiple state fields to the device at once.
@@ -5,40 +5,49 @@ ReadableStateField<unsigned int> *Event::ccno = nullptr;
 Event::Event(const std::string& name,
           std::vector<ReadableStateFieldBase*>& _data_fields,
           const char* (*_print_fn)(const unsigned int, std::vector<ReadableStateFieldBase*>&)) :
+          Event(name, _data_fields, _print_fn, nullptr) {}
+
+Event::Event(const std::string& name,
+          std::vector<ReadableStateFieldBase*>& _data_fields,
+          const char* (*_print_fn)(const unsigned int, std::vector<ReadableStateFieldBase*>&),
+          bit_array* storage) :
           StateField<bool>(name, true, false),
           _name(name),
           data_fields(_data_fields),
+          field_data(storage),
           print_fn(_print_fn)
 {
-    unsigned int field_data_size_bits = 0;
-    for(const ReadableStateFieldBase* field : data_fields) {
-        field_data_size_bits += field->bitsize();
-    }
-    field_data.reset(new bit_array(32 + field_data_size_bits));
-    for(size_t i = 0; i < field_data->size(); i++) {
-        (*field_data)[i] = 0;
+    if (!field_data) {
+        owned_field_data.reset(new bit_array());
+        field_data = owned_field_data.get();
     }
+    field_data->resize(bitsize_of(data_fields));
+    field_data->set_int(0);
 }
 
 Event::Event(Event &&other) : StateField<bool>(other.name(), true, false),
+                              _name(other._name),
                               data_fields(other.data_fields),
-                              field_data(std::move(other.field_data)) {}
+                              owned_field_data(std::move(other.owned_field_data)),
+                              field_data(other.field_data),
+                              print_fn(other.print_fn) {}
 
-void Event::serialize() {
-    unsigned int field_data_ptr = 0;
-
-    std::bitset<32> ccno_serialized(ccno->get());
-    for(int i = 0; i < 32; i++) {
-        (*field_data)[i] = ccno_serialized[i];
+size_t Event::bitsize_of(const std::vector<ReadableStateFieldBase*>& fields) {
+    size_t field_data_size_bits = 32;
+    for(const ReadableStateFieldBase* field : fields) {
+        field_data_size_bits += field->bitsize();
     }
-    field_data_ptr += 32;
+    return field_data_size_bits;
+}
+
+void Event::serialize() {
+    field_data->set_ullong(0, 32, ccno->get());
+    size_t field_data_ptr = 32;
 
     for(ReadableStateFieldBase* field : data_fields) {
-        const bit_array& field_bits = field->get_bit_array();
         field->serialize();
-        for(size_t i = 0; i < field->bitsize(); i++, field_data_ptr++) {
-            (*field_data)[field_data_ptr] = field_bits[i];
-        }
+        field_data->set_bits(field_data_ptr, field->get_bit_array());
+        field_data_ptr += field->bitsize();
     }
 }
 
@@ -58,25 +67,25 @@ const char* Event::print() const {
     return print_fn(ccno->get(), data_fields);
 }
 
+memory_footprint Event::memory_use() const {
+    memory_footprint fp;
+    fp.names = memory_footprint::heap_size(_name)
+        + memory_footprint::heap_size(StateField<bool>::_name);
+    fp.events = sizeof(*this) + sizeof(bit_array);
+    fp.heap = fp.names + sizeof(bit_array);
+    return fp;
+}
+
 void Event::deserialize() 
 {
-    unsigned int field_data_ptr = 0;
-    std::bitset<32> ccno_serialized;
-    for (int i = 0; i < 32; i++)
-    {
-        ccno_serialized[i] = (*field_data)[i];
-    }
-    field_data_ptr += 32;
-    const unsigned int event_ccno = (int)(ccno_serialized.to_ulong());
-    ccno->set(event_ccno);
+    ccno->set(static_cast<unsigned int>(field_data->to_ullong(0, 32)));
+    size_t field_data_ptr = 32;
 
     for (ReadableStateFieldBase *field : data_fields)
     {
         bit_array &field_bits = const_cast<bit_array &>(field->get_bit_array());
-        for (unsigned int i = 0; i < field->bitsize(); i++, field_data_ptr++)
-        {
-            field_bits[i] = (*field_data)[field_data_ptr];
-        }
+        field_bits.set_bits(0, *field_data, field_data_ptr, field->bitsize());
+        field_data_ptr += field->bitsize();
         field->deserialize();
     }
 }
@@ -84,10 +93,7 @@ void Event::deserialize()
 void Event::set_bit_array(const bit_array &arr)
 {
     assert(arr.size() == field_data->size());
-    for (unsigned int i = 0; i < arr.size(); i++)
-    {
-        (*field_data)[i] = arr[i];
-    }
+    *field_data = arr;
 }
 
 bool Event::deserialize(const char *val) { return true; }
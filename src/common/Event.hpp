@@ -65,6 +65,22 @@ class Event : public ReadableStateFieldBase, public StateField<bool>, public Eve
           std::vector<ReadableStateFieldBase*>& _data_fields,
           const char* (*_print_fn)(const unsigned int, std::vector<ReadableStateFieldBase*>&));
 
+    /**
+     * @brief Construct a new Event object whose data is stored in a bit array owned by
+     * someone else, such as a record in the ring of an EventStorage.
+     *
+     * @param name Name of event.
+     * @param _data_fields Data fields related to the event.
+     * @param _print_fn Function for printing data about the event.
+     * @param storage Bit array that holds the event's data. It's resized to
+     *                bitsize_of(_data_fields) and must outlive the event. If it's null, the
+     *                event allocates its own.
+     */
+    Event(const std::string& name,
+          std::vector<ReadableStateFieldBase*>& _data_fields,
+          const char* (*_print_fn)(const unsigned int, std::vector<ReadableStateFieldBase*>&),
+          bit_array* storage);
+
    /**
      * @brief Move constructor, required for EventStorage.
      * 
@@ -96,13 +112,26 @@ class Event : public ReadableStateFieldBase, public StateField<bool>, public Eve
       unsigned int get_eeprom_repr() const override;
       void set_from_eeprom(unsigned int val) override;
 
+      /**
+       * @brief Memory used by the event. The whole event, including its data, is
+       * counted as an event.
+       */
+      memory_footprint memory_use() const override;
+
    static ReadableStateField<unsigned int> *ccno;
 
+    /**
+     * @brief Number of bits in the data of an event with the given data fields: the
+     * 32-bit control cycle count followed by each field's serialized bits.
+     */
+    static size_t bitsize_of(const std::vector<ReadableStateFieldBase*>& fields);
+
     virtual ~Event() {}
 
   private:
     std::vector<ReadableStateFieldBase*>& data_fields;
-    std::unique_ptr<bit_array> field_data;
+    std::unique_ptr<bit_array> owned_field_data;
+    bit_array* field_data;
     const char* (*print_fn)(const unsigned int, std::vector<ReadableStateFieldBase*>&);
 
     // Disable state field functions.
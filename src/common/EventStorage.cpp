@@ -7,6 +7,9 @@ EventStorage::EventStorage(const std::string &name,
                            const char *(*_print_fn)(const unsigned int, std::vector<ReadableStateFieldBase *> &))
 {
     assert(storage_size <= 99 && storage_size >= 0); // So that the suffixed event count doesn't have more than 2 digits
+    // Every sub-event stores its data in a record of one contiguous ring, rather than
+    // in a bit array of its own.
+    records.resize(storage_size);
     sub_events.reserve(storage_size);
     for (unsigned char i = 1; i <= storage_size; i++)
     {
@@ -15,7 +18,7 @@ EventStorage::EventStorage(const std::string &name,
         x[0] = '.';
         sprintf(x, ".%d", i % 100);
         sub_events.emplace_back(name + std::string(x),
-                                _data_fields, _print_fn);
+                                _data_fields, _print_fn, &records[i - 1]);
     }
 }
 
@@ -4,6 +4,14 @@
 #include "Event.hpp"
 #include <common/StateFieldRegistry.hpp>
 
+/**
+ * @brief Ring of events that share the same data fields. Each signal() stores the
+ * fields' data into the next record of the ring, overwriting the oldest one.
+ *
+ * The records are bit arrays in one contiguous, preallocated vector, and each sub-event
+ * reads and writes its own record. So signaling costs a few word copies, and the
+ * downlink reads the sub-events' data straight from the ring.
+ */
 class EventStorage : public EventBase
 {
 public:
@@ -42,6 +50,12 @@ public:
   void signal() override;
 
 private:
+  /**
+     * @brief Ring of records that hold the data of the sub-events. Record i belongs to
+     * sub-event i.
+     */
+  std::vector<bit_array> records;
+
   /**
      * @brief Stores the sub-events that comprise the event storage.
      */
@@ -84,4 +84,17 @@ void Fault::process_commands(){
 unsigned int Fault::get_num_consecutive_signals(){
     return num_consecutive_signals;
 }
-#endif
\ No newline at end of file
+#endif
+memory_footprint Fault::memory_use() const {
+    const size_t fields_size =
+        sizeof(suppress_f) + sizeof(override_f) + sizeof(unsignal_f) + sizeof(persistence_f);
+    const size_t serializers_size = sizeof(fault_bool_sr) + sizeof(persist_sr);
+    memory_footprint fp = memory_use_of(sizeof(*this) - fields_size - serializers_size);
+    fp.serializers += serializers_size;
+
+    // The fault keeps its own copy of its name
+    const size_t name_size = memory_footprint::heap_size(_name);
+    fp.names += name_size;
+    fp.heap += name_size;
+    return fp;
+}
@@ -54,6 +54,12 @@ class Fault : public WritableStateField<bool> {
      */
     bool is_faulted();
 
+    /**
+     * @brief Memory used by the fault. The state fields that control the fault are
+     * added to the registry on their own, so they're left out.
+     */
+    memory_footprint memory_use() const override;
+
     #ifdef UNIT_TEST
     /**
      * @brief a debug return that tells the current consecutive signals
@@ -3,9 +3,20 @@
 
 #include <libsbp/navigation.h>
 #include "constant_tracker.hpp"
+#include <cstdint>
 
-TRACKED_CONSTANT_SC(unsigned long, NANOSECONDS_IN_WEEK, 7 * 24 * 60 * 60 * static_cast<unsigned long>(1000000000));
+TRACKED_CONSTANT_SC(int64_t, NANOSECONDS_IN_WEEK, 7 * 24 * 60 * 60 * static_cast<int64_t>(1000000000));
+TRACKED_CONSTANT_SC(int64_t, NANOSECONDS_IN_MILLISECOND, 1000000);
 
+/**
+ * @brief GPS time, stored as the week number, the time of week in milliseconds and the
+ * remaining nanoseconds, like the Piksi reports it.
+ *
+ * The canonical value of a GPS time is the number of nanoseconds since the GPS epoch, as
+ * a 64-bit integer returned by to_ns(). Comparisons and arithmetic are done on that
+ * value, so they don't overflow on targets where unsigned long has 32 bits, and the
+ * comparisons don't branch on whether the times are set.
+ */
 struct gps_time_t {
     unsigned short wn;
     unsigned int tow;
@@ -13,77 +24,80 @@ struct gps_time_t {
     bool is_set;
 
     /** Default constructor **/
-    gps_time_t() {
-        is_set = false;
-        wn = 0;
-        tow = 0;
-        ns = 0;
-    }
+    constexpr gps_time_t() : wn(0), tow(0), ns(0), is_set(false) {}
 
     /** Argumented constructor **/
-    gps_time_t(unsigned short wn, unsigned int tow, unsigned long ns) {
-        is_set = true;
-        this->wn = wn;
-        this->tow = tow;
-        this->ns = ns;
-    }
+    constexpr gps_time_t(unsigned short wn, unsigned int tow, unsigned long ns)
+        : wn(wn), tow(tow), ns(ns), is_set(true) {}
 
     /** Copy constructor **/
-    explicit gps_time_t(const unsigned long t) {
-        is_set = true;
-        wn = t / NANOSECONDS_IN_WEEK;
-        tow = (t - (wn * NANOSECONDS_IN_WEEK)) / 1000000;
-        ns = (t - (wn * NANOSECONDS_IN_WEEK)) % 1000000;
+    explicit constexpr gps_time_t(const unsigned long t)
+        : gps_time_t(from_ns(static_cast<int64_t>(t))) {}
+
+    constexpr gps_time_t(const msg_gps_time_t &t) : wn(t.wn), tow(t.tow), ns(t.ns), is_set(true) {}
+
+    /**
+     * @brief Construct a set GPS time from a number of nanoseconds since the GPS
+     * epoch, which must not be negative.
+     */
+    static constexpr gps_time_t from_ns(const int64_t t) {
+        return gps_time_t(static_cast<unsigned short>(t / NANOSECONDS_IN_WEEK),
+            static_cast<unsigned int>(t % NANOSECONDS_IN_WEEK / NANOSECONDS_IN_MILLISECOND),
+            static_cast<unsigned long>(t % NANOSECONDS_IN_MILLISECOND));
     }
 
-    gps_time_t(const msg_gps_time_t &t) {
-        is_set = true;
-        wn = t.wn;
-        tow = t.tow;
-        ns = t.ns;
+    /**
+     * @brief Number of nanoseconds since the GPS epoch, whether or not the time is set.
+     * Times after week 15250, in 2262, don't fit and wrap around, as they did when this
+     * was an unsigned long.
+     */
+    constexpr int64_t to_ns() const {
+        return static_cast<int64_t>(wn * static_cast<uint64_t>(NANOSECONDS_IN_WEEK)
+            + tow * static_cast<uint64_t>(NANOSECONDS_IN_MILLISECOND)
+            + static_cast<uint64_t>(static_cast<int64_t>(ns)));
     }
 
+    /**
+     * @brief Signed number of nanoseconds from t to this time. Unlike operator-, the
+     * result may be negative, and it's computed whether or not the times are set.
+     */
+    constexpr int64_t ns_since(const gps_time_t &t) const { return to_ns() - t.to_ns(); }
+
     /** Cast to integer operator **/
-    explicit operator unsigned long() const {
-        return wn * NANOSECONDS_IN_WEEK + tow * 1000000 + ns;
+    explicit constexpr operator unsigned long() const {
+        return static_cast<unsigned long>(to_ns());
     }
 
-    /** A bunch of equality and comparison operators. **/
-    bool operator==(const unsigned long t) const {
-        if (!is_set) return false;
-        return static_cast<unsigned long>(*this) == t;
+    /** A bunch of equality and comparison operators. A time that isn't set is neither
+     *  equal to nor less than any other time. **/
+    constexpr bool operator==(const unsigned long t) const {
+        return is_set & (to_ns() == static_cast<int64_t>(t));
     }
-    bool operator==(const gps_time_t &t)   const {
-        if (!t.is_set) return false;
-        const unsigned long t_ns = static_cast<unsigned long>(t);
-        return *this == t_ns;
+    constexpr bool operator==(const gps_time_t &t)   const {
+        return is_set & t.is_set & (to_ns() == t.to_ns());
     }
-    bool operator<(const unsigned long t)  const {
-        if (!is_set) return false;
-        return static_cast<unsigned long>(*this) < t;
+    constexpr bool operator<(const unsigned long t)  const {
+        return is_set & (to_ns() < static_cast<int64_t>(t));
     }
-    bool operator<(const gps_time_t &t)    const {
-        if (!t.is_set) return false;
-        const unsigned long t_ns = static_cast<unsigned long>(t);
-        return *this < t_ns;
+    constexpr bool operator<(const gps_time_t &t)    const {
+        return is_set & t.is_set & (to_ns() < t.to_ns());
     }
-    bool operator!=(const unsigned long t) const { return !(*this == t); }
-    bool operator!=(const gps_time_t &t)   const { return !(*this == t); }
-    bool operator>(const unsigned long t)  const { return !(*this < t || *this == t ); }
-    bool operator>(const gps_time_t &t)    const { return !(*this < t || *this == t ); }
-    bool operator<=(const unsigned long t) const { return !(*this > t); }
-    bool operator<=(const gps_time_t &t)   const { return !(*this > t); }
-    bool operator>=(const unsigned long t) const { return !(*this < t); }
-    bool operator>=(const gps_time_t &t)   const { return !(*this < t); }
+    constexpr bool operator!=(const unsigned long t) const { return !(*this == t); }
+    constexpr bool operator!=(const gps_time_t &t)   const { return !(*this == t); }
+    constexpr bool operator>(const unsigned long t)  const { return !(*this < t || *this == t ); }
+    constexpr bool operator>(const gps_time_t &t)    const { return !(*this < t || *this == t ); }
+    constexpr bool operator<=(const unsigned long t) const { return !(*this > t); }
+    constexpr bool operator<=(const gps_time_t &t)   const { return !(*this > t); }
+    constexpr bool operator>=(const unsigned long t) const { return !(*this < t); }
+    constexpr bool operator>=(const gps_time_t &t)   const { return !(*this < t); }
 
     /** Addition operators **/
     gps_time_t& operator+=(const unsigned long t) {
-        is_set = true;
-        *this = static_cast<gps_time_t>(static_cast<unsigned long>(*this) + t);
+        *this = from_ns(to_ns() + static_cast<int64_t>(t));
         return *this;
     }
     gps_time_t& operator+=(const gps_time_t &t) {
-        *this += static_cast<unsigned long>(t);
+        *this = from_ns(to_ns() + t.to_ns());
         return *this;
     }
 
@@ -95,15 +109,19 @@ struct gps_time_t {
             return *this;
         }
 
-        is_set = true;
-        *this = static_cast<gps_time_t>(static_cast<unsigned long>(*this) - t);
+        *this = from_ns(to_ns() - static_cast<int64_t>(t));
         return *this;
     }
 
     /** Subtraction operator. Requires t1 is less than "this" or else
      *  the current object becomes unset. **/
     gps_time_t& operator-=(const gps_time_t &t) {
-        *this -= static_cast<unsigned long>(t);
+        if (is_set & (to_ns() < t.to_ns())) {
+            is_set = false;
+            return *this;
+        }
+
+        *this = from_ns(to_ns() - t.to_ns());
         return *this;
     }
 };
@@ -19,6 +19,27 @@
 class SerializerType {
    public:
     static const std::vector<std::string> serializable_types;
+
+    /**
+     * @brief Size of the buffer that serializers print into.
+     *
+     * Values are only printed by the debug console and the ground software, which use
+     * the printed string right away, so all serializers on a thread share this buffer
+     * instead of each holding its own. The string returned by print() is only valid until
+     * the next call to print() on any serializer on the same thread. Strings that don't
+     * fit are truncated.
+     *
+     * On desktop, each thread has its own buffer, since the ground software parses
+     * downlinks on several threads at once.
+     */
+    static constexpr size_t print_buffer_size = 128;
+
+   protected:
+#ifdef DESKTOP
+    static thread_local char printed_val[print_buffer_size];
+#else
+    static char printed_val[print_buffer_size];
+#endif
 };
 
 /**
@@ -32,11 +53,6 @@ class SerializerType {
  */
 template <typename T>
 class SerializerBase : public SerializerType {
-   private:
-     /**
-      * @brief Length of string returned by print().
-      */
-     size_t strlength;
    protected:
     /**
      * @brief Minima and maxima used for fixed-point compression of objects.
@@ -54,11 +70,6 @@ class SerializerBase : public SerializerType {
      */
     bit_array serialized_val;
 
-    /**
-     * @brief Container for printed value of serialized object.
-     */
-    char* printed_val = nullptr;
-
     /**
      * @brief Argumented constructor. This is protected to prevent construction of this
      * implementation-less base class.
@@ -67,17 +78,13 @@ class SerializerBase : public SerializerType {
      * serializer for a vector serializer), return from the constructor and do not resize the
      * serialized bit array.
      */
-    SerializerBase(T min, T max, size_t compressed_size, size_t _strlength) :
-        strlength(_strlength),
+    SerializerBase(T min, T max, size_t compressed_size) :
         _min(min),
         _max(max),
         serialized_val()
     {
         if (static_cast<signed int>(compressed_size) < 0) return;
         serialized_val.resize(compressed_size);
-
-        this->printed_val = new char[strlength];
-        memset(printed_val, '\0', strlength);
     }
 
     /**
@@ -95,12 +102,6 @@ class SerializerBase : public SerializerType {
         _max = rhs._max;
         serialized_val.resize(rhs.serialized_val.size());
         serialized_val = rhs.serialized_val;
-
-        delete[] printed_val;
-        strlength = rhs.strlength;
-        printed_val = new char[strlength];
-        memcpy(printed_val, rhs.printed_val, strlength);
-
         return *this;
     }
 
@@ -115,16 +116,7 @@ class SerializerBase : public SerializerType {
      * @brief Move assignment operator.
      */
     SerializerBase& operator=(SerializerBase&& rhs) {
-        _min = rhs._min;
-        _max = rhs._max;
-        serialized_val.resize(rhs.serialized_val.size());
-        serialized_val = std::move(rhs.serialized_val);
-
-        delete[] printed_val;
-        strlength = rhs.strlength;
-        printed_val = rhs.printed_val;
-        rhs.printed_val = nullptr;
-        return *this;
+        return *this = rhs;
     }
 
    public:
@@ -164,14 +156,12 @@ class SerializerBase : public SerializerType {
 
     /**
      * @brief Outputs a string representation of the source value into
-     * the given destination string.
-     *
-     * In order to enable good use of memory, the maximum length of the string
-     * representation can be found in the member variable "str_len".
+     * the shared print buffer.
      *
      * @param src  Source value
      *
-     * @return C-style string containing printed value.
+     * @return C-style string containing printed value, which is valid until the next
+     *         call to print() on any serializer.
      */
     virtual const char* print(const T& src) const = 0;
 
@@ -206,20 +196,18 @@ class SerializerBase : public SerializerType {
     /**
      * @brief Destructor.
      */
-    virtual ~SerializerBase();
+    virtual ~SerializerBase() = default;
 };
 
-template <typename T>
-SerializerBase<T>::~SerializerBase() {
-    delete[] printed_val;
-}
-
 /**
  * @brief Public facing, constructible version of SerializerBase.
  *
  * @tparam T Type of value to serialize.
+ * @tparam compressed_size Width of the serialized value, in bits, for the fixed-width
+ *         serializers of floats and doubles. Zero for all other serializers, whose width is
+ *         given to their constructor.
  */
-template <typename T> class Serializer;
+template <typename T, size_t compressed_size = 0> class Serializer;
 
 #include "SerializerTypes.inl"
 
@@ -11,3 +11,10 @@ const std::vector<std::string> SerializerType::serializable_types = {
     "bool", "f_quat", "f_vec", "d_quat", "d_vec", "gpstime", "int", "uint", "float", "double"};
 
 const gps_time_t Serializer<gps_time_t>::dummy_gpstime;
+
+constexpr size_t SerializerType::print_buffer_size;
+#ifdef DESKTOP
+thread_local char SerializerType::printed_val[SerializerType::print_buffer_size];
+#else
+char SerializerType::printed_val[SerializerType::print_buffer_size];
+#endif
@@ -17,9 +17,8 @@ template <>
 class Serializer<bool> : public SerializerBase<bool> {
   public:
     TRACKED_CONSTANT_SC(size_t, bool_sz, 1);
-    TRACKED_CONSTANT_SC(size_t, print_sz, 6); // "false" has length 5. +1 for null terminator
 
-    Serializer() : SerializerBase<bool>(false, true, 1, print_sz) {}
+    Serializer() : SerializerBase<bool>(false, true, 1) {}
 
     Serializer(const Serializer<bool>& other) : SerializerBase<bool>(other) {}
 
@@ -67,14 +66,14 @@ class IntegerSerializer : public SerializerBase<T> {
         return i;
     }
 
-    IntegerSerializer(T min, T max, size_t compressed_size, size_t print_size)
-        : SerializerBase<T>(min, max, std::min(compressed_size, 8*sizeof(T)), print_size)
+    IntegerSerializer(T min, T max, size_t compressed_size)
+        : SerializerBase<T>(min, max, std::min(compressed_size, 8*sizeof(T)))
     {
         assert(min <= max);
     }
 
-    IntegerSerializer(T min, T max, size_t print_size)
-        : SerializerBase<T>(min, max, log2i(max - min), print_size)
+    IntegerSerializer(T min, T max)
+        : SerializerBase<T>(min, max, log2i(max - min))
     {
         assert(min <= max);
     }
@@ -122,7 +121,7 @@ class IntegerSerializer : public SerializerBase<T> {
     }
 
     const char* print(const T& src) const override {
-        sprintf(this->printed_val, "%d", src);
+        snprintf(this->printed_val, this->print_buffer_size, "%d", src);
         return this->printed_val;
     }
 };
@@ -133,15 +132,13 @@ class IntegerSerializer : public SerializerBase<T> {
 template <>
 class Serializer<signed char> : public IntegerSerializer<signed char> {
   public:
-    TRACKED_CONSTANT_SC(size_t, print_size, 5); // -2^3 - 1 has 4 characters. +1 for NULL
-
-    Serializer() : IntegerSerializer<signed char>(-128, 127, print_size) {}
+    Serializer() : IntegerSerializer<signed char>(-128, 127) {}
 
     Serializer(signed char min, signed char max, size_t compressed_size)
-        : IntegerSerializer<signed char>(min, max, compressed_size, print_size) {}
+        : IntegerSerializer<signed char>(min, max, compressed_size) {}
 
     Serializer(signed char min, signed char max)
-        : IntegerSerializer<signed char>(min, max, print_size) {}
+        : IntegerSerializer<signed char>(min, max) {}
 };
 
 /**
@@ -150,17 +147,15 @@ class Serializer<signed char> : public IntegerSerializer<signed char> {
 template <>
 class Serializer<unsigned char> : public IntegerSerializer<unsigned char> {
   public:
-    TRACKED_CONSTANT_SC(size_t, print_size, 4); // 2^8 - 1 has 10 characters. +1 for NULL
-
-    Serializer() : IntegerSerializer<unsigned char>(0, 255, print_size) {}
+    Serializer() : IntegerSerializer<unsigned char>(0, 255) {}
 
-    Serializer(unsigned char max) : IntegerSerializer<unsigned char>(0, max, print_size) {}
+    Serializer(unsigned char max) : IntegerSerializer<unsigned char>(0, max) {}
 
     Serializer(unsigned char min, unsigned char max, size_t compressed_size)
-        : IntegerSerializer<unsigned char>(min, max, compressed_size, print_size) {}
+        : IntegerSerializer<unsigned char>(min, max, compressed_size) {}
 
     Serializer(unsigned char min, unsigned char max)
-        : IntegerSerializer<unsigned char>(min, max, print_size) {}
+        : IntegerSerializer<unsigned char>(min, max) {}
 };
 
 /**
@@ -169,17 +164,15 @@ class Serializer<unsigned char> : public IntegerSerializer<unsigned char> {
 template <>
 class Serializer<unsigned int> : public IntegerSerializer<unsigned int> {
   public:
-    TRACKED_CONSTANT_SC(size_t, print_size, 11); // 2^32 - 1 has 10 characters. +1 for NULL
-
-    Serializer() : IntegerSerializer<unsigned int>(0, 4294967295, print_size) {}
+    Serializer() : IntegerSerializer<unsigned int>(0, 4294967295) {}
 
-    Serializer(unsigned int max) : IntegerSerializer<unsigned int>(0, max, print_size) {}
+    Serializer(unsigned int max) : IntegerSerializer<unsigned int>(0, max) {}
 
     Serializer(unsigned int min, unsigned int max, size_t compressed_size)
-        : IntegerSerializer<unsigned int>(min, max, compressed_size, print_size) {}
+        : IntegerSerializer<unsigned int>(min, max, compressed_size) {}
 
     Serializer(unsigned int min, unsigned int max)
-        : IntegerSerializer<unsigned int>(min, max, print_size) {}
+        : IntegerSerializer<unsigned int>(min, max) {}
 };
 
 /**
@@ -189,15 +182,14 @@ template <>
 class Serializer<signed int> : public IntegerSerializer<signed int> {
   public:
     TRACKED_CONSTANT_SC(size_t, temp_sz, 30); // Size of a temperature field
-    TRACKED_CONSTANT_SC(size_t, print_size, 12); // -2^31 - 1 has 11 characters. +1 for NULL
 
-    Serializer() : IntegerSerializer<signed int>(-2147483648, 2147483647, print_size) {}
+    Serializer() : IntegerSerializer<signed int>(-2147483648, 2147483647) {}
 
     Serializer(signed int min, signed int max, size_t compressed_size)
-        : IntegerSerializer<signed int>(min, max, compressed_size, print_size) {}
+        : IntegerSerializer<signed int>(min, max, compressed_size) {}
 
     Serializer(signed int min, signed int max)
-        : IntegerSerializer<signed int>(min, max, print_size) {}
+        : IntegerSerializer<signed int>(min, max) {}
 };
 
 /**
@@ -211,29 +203,76 @@ class FloatDoubleSerializer : public SerializerBase<T> {
   protected:
     template<typename U, size_t N, size_t qsz, size_t vcsz, size_t qcsz>
     friend class VectorSerializer;
+    template<typename U, size_t compressed_size>
+    friend class FixedWidthSerializer;
 
-    TRACKED_CONSTANT_SC(size_t, print_size, 14); // 6 digits before and after the decimal point, and a NULL character.
+    /**
+     * @brief Size of an interval of the fixed-point encoding, and the number of intervals
+     * per unit. These only depend on the bounds and the size, so they're computed when the
+     * serializer is constructed.
+     *
+     * @{
+     */
+    T resolution;
+    T scale;
+    /**
+     * @}
+     */
 
     FloatDoubleSerializer(T min, T max, size_t compressed_size)
-        : SerializerBase<T>(min, max, compressed_size, print_size)
+        : SerializerBase<T>(min, max, compressed_size)
     {
         assert(min <= max);
         if (min > max) this->_min = max;
+
+        resolution = resolution_of(this->_min, this->_max, compressed_size);
+        scale = 0;
+        if (this->_max > this->_min)
+            scale = num_intervals_of(compressed_size) / (this->_max - this->_min);
     }
 
-  public:
-    void serialize(const T& src) override {
-        const unsigned int num_intervals = (0b1 << this->serialized_val.size()) - 1;
+    /**
+     * @brief Number of intervals in a fixed-point encoding of the given number of bits.
+     * Encodings of more than 32 bits have as many intervals as 32-bit ones.
+     */
+    static constexpr unsigned int num_intervals_of(size_t size) {
+        return size < 32 ? (1u << size) - 1 : 4294967295u; // 2^32 - 1
+    }
 
-        T src_copy = src;
-        if (src_copy > this->_max) src_copy = this->_max;
-        if (src_copy < this->_min) src_copy = this->_min;
+    static T resolution_of(T min, T max, size_t size) {
+        const unsigned int num_intervals = num_intervals_of(size);
 
         T resolution = 0;
-        if (num_intervals > 0) resolution = (this->_max - this->_min) / num_intervals;
+        if (num_intervals > 0) resolution = (max - min) / num_intervals;
+        return resolution;
+    }
 
-        const unsigned int result_int = static_cast<unsigned int>((src_copy - this->_min) / resolution);
-        this->serialized_val.set_int(result_int);
+    /**
+     * @brief Fixed-point encoding of a value in [min, max] into an integer of at most
+     * num_intervals, and its inverse. The vector serializers use these to encode their
+     * components without owning a serializer for each one.
+     */
+    static unsigned int encode(T src, T min, T max, T resolution, unsigned int num_intervals) {
+        // Clamp so that NaNs end up at the minimum.
+        T clamped = src > min ? src : min;
+        clamped = clamped < max ? clamped : max;
+        if (!(resolution > 0)) return 0;
+
+        // The quotient can round up past the last interval when the size is larger than
+        // the precision of T.
+        const unsigned long long result = static_cast<unsigned long long>(
+            (clamped - min) / resolution);
+        return static_cast<unsigned int>(std::min<unsigned long long>(result, num_intervals));
+    }
+
+    static T decode(unsigned int bits, T min, T resolution) {
+        return min + resolution * bits;
+    }
+
+  public:
+    void serialize(const T& src) override {
+        this->serialized_val.set_int(encode(src, this->_min, this->_max, resolution,
+            num_intervals_of(this->bitsize())));
     }
 
     bool deserialize(const char* val, T* dest) override {
@@ -252,20 +291,11 @@ class FloatDoubleSerializer : public SerializerBase<T> {
     }
 
     void deserialize(T* dest) const override {
-        const unsigned int num_intervals = (0b1 << this->serialized_val.size()) - 1;
-
-        const unsigned int f_bits = this->serialized_val.to_uint();
-        T resolution;
-        if (num_intervals > 0)
-            resolution = (this->_max - this->_min) / num_intervals;
-        else
-            resolution = 0;
-
-        *dest = this->_min + resolution * f_bits;
+        *dest = decode(this->serialized_val.to_uint(), this->_min, resolution);
     }
 
     const char* print(const T& src) const override {
-        sprintf(this->printed_val, "%6.6f", src);
+        snprintf(this->printed_val, this->print_buffer_size, "%6.6f", src);
         return this->printed_val;
     }
 };
@@ -290,6 +320,81 @@ class Serializer<double> : public FloatDoubleSerializer<double> {
         : FloatDoubleSerializer<double>(min, max, size) {}
 };
 
+/**
+ * @brief Base class for the fixed-width specializations of Serializer for floats and
+ * doubles, i.e. Serializer<float, compressed_size> and Serializer<double, compressed_size>.
+ *
+ * Since the width is a template parameter, the number of intervals and the mask of the
+ * encoded value are compile-time constants, and serializing a value is a clamp, a
+ * multiplication and a store, with no division or branching. Deserialization is the same as
+ * for Serializer<T>, so a value can be decoded by a Serializer<T> with the same bounds and
+ * width, e.g. on the ground. The two encodings only differ in how they round values that lie
+ * within rounding error of the boundary between two intervals.
+ *
+ * The bounds are constructor arguments, since floating-point values can't be template
+ * arguments; the scale and resolution are computed from them when the serializer is
+ * constructed.
+ *
+ * A fixed-width serializer is a Serializer<T>, so it can be used anywhere one is. State
+ * fields only use the fixed-width encoding if they are declared as FixedReadableStateField
+ * or FixedWritableStateField.
+ */
+template <typename T, size_t compressed_size>
+class FixedWidthSerializer : public Serializer<T> {
+  static_assert(compressed_size > 0 && compressed_size <= 32,
+                "Fixed-width serializers must be between 1 and 32 bits wide.");
+
+  public:
+    static constexpr unsigned int num_intervals =
+        FloatDoubleSerializer<T>::num_intervals_of(compressed_size);
+
+    FixedWidthSerializer(T min, T max) : Serializer<T>(min, max, compressed_size) {}
+
+    /**
+     * @brief Serialize a value into a serializer with the same width, using the fixed-width
+     * encoding. State fields with fixed-width serializers use this to serialize their
+     * values into the serializer that they hold.
+     *
+     * @param dest Serializer whose bit array the encoded value is stored into.
+     * @param src  Value to serialize.
+     */
+    static void serialize(Serializer<T>& dest, const T& src) {
+        // Clamp so that NaNs end up at the minimum.
+        T clamped = src > dest._min ? src : dest._min;
+        clamped = clamped < dest._max ? clamped : dest._max;
+
+        // The product can round up past the last interval when the width is larger than
+        // the precision of T.
+        const unsigned long long result = static_cast<unsigned long long>(
+            (clamped - dest._min) * dest.scale);
+        dest.serialized_val.set_ullong(0, compressed_size,
+            std::min<unsigned long long>(result, num_intervals));
+    }
+
+    void serialize(const T& src) override { serialize(*this, src); }
+};
+
+template <typename T, size_t compressed_size>
+constexpr unsigned int FixedWidthSerializer<T, compressed_size>::num_intervals;
+
+/**
+ * @brief Fixed-width specialization of Serializer for floats.
+ */
+template <size_t compressed_size>
+class Serializer<float, compressed_size> : public FixedWidthSerializer<float, compressed_size> {
+  public:
+    Serializer(float min, float max) : FixedWidthSerializer<float, compressed_size>(min, max) {}
+};
+
+/**
+ * @brief Fixed-width specialization of Serializer for doubles.
+ */
+template <size_t compressed_size>
+class Serializer<double, compressed_size> : public FixedWidthSerializer<double, compressed_size> {
+  public:
+    Serializer(double min, double max) : FixedWidthSerializer<double, compressed_size>(min, max) {}
+};
+
 /**
  * @brief Base class for float/double vector/quaternion specializations of serializer.
  * 
@@ -301,7 +406,8 @@ class Serializer<double> : public FloatDoubleSerializer<double> {
  * - Since the unit vector has a magnitude of size 1, we only need the two smallest components
  *   to specify the direction of the unit vector. We allow two bits to store the index of
  *   the largest component in the unit vector, and then we serialize the two smallest components
- *   in the bounds +/- sqrt(2) and with bitsize 9.
+ *   in the bounds +/- sqrt(2)/2 and with bitsize 9. A final bit stores the sign of the
+ *   largest component.
  * 
  * For quaternions:
  * - Since the quaternion has a magnitude of size 1, we only need the three smallest components
@@ -309,6 +415,9 @@ class Serializer<double> : public FloatDoubleSerializer<double> {
  *   the largest component in the quaternion, and then we serialize the three smallest components
  *   in the bounds +/- sqrt(2)/2 and with bitsize 9.
  * 
+ * The fields are encoded straight into the serializer's bit array, in the order above, using
+ * the same fixed-point encoding as FloatDoubleSerializer. The serializer owns no other
+ * buffers, so it can be copied without allocating.
  */
 template <typename T,
           size_t N,
@@ -322,51 +431,26 @@ class VectorSerializer : public SerializerBase<std::array<T, N>> {
       "Serializers for float arrays can only be used for arrays of size 3 or 4.");
 
   private:
-    void construct_vector_serializer(T min, T max, T size) {
-        size_t magnitude_bitsize;
-        if (N == 3) magnitude_bitsize = size - vec_min_sz;
-        else magnitude_bitsize = quat_magnitude_sz;
-        magnitude_serializer = std::make_unique<Serializer<T>>(min, max, magnitude_bitsize);
-
-        max_component.resize(2);
-
-        //needs to be intialized or else compiler warning-error
-        max_component.set_int(0);
-
-        sign_of_max_comp.resize(1);
-
-        size_t component_sz = 0;
-        if (N == 3) { component_sz = vec_component_sz; }
-        else { component_sz = quat_component_sz; }
-
-        for (size_t i = 0; i < N - 1; i++) {
-            component_scaled_values[i].resize(component_sz);
-            vector_element_serializers[i] = std::make_unique<Serializer<T>>(
-                // components must be able to be negative, thus range from -sqrt(2)/2 to sqrt(2)/2
-                -sqrtf(2.0f) / 2, sqrtf(2.0f) / 2 , component_sz);
+    using Encoder = FloatDoubleSerializer<T>;
 
+    /**
+     * @brief Write a fixed-point value into a field of the bit array. If the value doesn't
+     * fit in the field, which happens when it isn't a number, the field is left as it was.
+     * Fields can be wider than 64 bits, in which case the bits past the first 64 are zeroed.
+     */
+    void write_field(size_t start, size_t len, unsigned int val) {
+        if (len < 64 && (static_cast<unsigned long long>(val) >> len) != 0) return;
+        for (size_t i = 0; i < len; i += 64) {
+            this->serialized_val.set_ullong(start + i, std::min<size_t>(len - i, 64),
+                i == 0 ? val : 0);
         }
     }
 
     /**
-     * @brief Do the vector-specific parts of copying one serializer from another. We need
-     * this in order to prevent duplication of code across the asisgnment operator and the
-     * copy constructor.
-     * 
-     * @param other Serializer to copy from.
+     * @brief Bounds of the normalized components; they must be able to be negative.
      */
-    void copy_vector_values(const Serializer<std::array<T, N>>& other) {
-        this->magnitude_min = other.magnitude_min;
-        this->magnitude_max = other.magnitude_max;
-        this->magnitude_serializer = std::make_unique<Serializer<T>>(*other.magnitude_serializer);
-        for(size_t i = 0; i < vector_element_serializers.size(); i++) {
-            this->vector_element_serializers[i] =
-                std::make_unique<Serializer<T>>(*other.vector_element_serializers[i]);
-        }
-        this->max_component = other.max_component;
-        this->component_scaled_values = other.component_scaled_values;
-        this->sign_of_max_comp = other.sign_of_max_comp;
-    }
+    static T component_max() { return sqrtf(2.0f) / 2; }
+    static T component_min() { return -sqrtf(2.0f) / 2; }
 
   protected:
     /**
@@ -378,38 +462,31 @@ class VectorSerializer : public SerializerBase<std::array<T, N>> {
     T magnitude_max;
     static std::array<T, N> dummy_vector;
 
-    /**
-     * @brief Serializer for vector magnitude.
-     */
-    std::shared_ptr<Serializer<T>> magnitude_serializer;
+    TRACKED_CONSTANT_SC(size_t, quat_magnitude_sz, (quat_sz - 3 * quat_component_sz));
+    TRACKED_CONSTANT_SC(size_t, vec_min_sz, 2 + 2 * vec_component_sz + 1); // + 1 for the sign serializer
 
     /**
-     * @brief Serializer for vector components.
+     * @brief Layout of the serialized vector. The magnitude field, which only vectors
+     * have, comes right after the index of the largest component.
      */
-    std::array<std::shared_ptr<Serializer<T>>, N - 1> vector_element_serializers;
+    static constexpr size_t index_sz = 2;
+    static constexpr size_t component_sz = N == 3 ? vec_component_sz : quat_component_sz;
 
     /**
-     * @brief Bit array that stores which element of the vector is maximal.
+     * @brief Size of the magnitude field. Zero for quaternions.
      */
-    bit_array max_component;
+    size_t magnitude_sz;
 
     /**
-     * @brief Bit array that stores sign of max. component of a vector
-     * 
-     * Only has bitsize() == 1;
+     * @brief Resolutions of the fixed-point encodings of the magnitude and the components.
+     *
+     * @{
      */
-    bit_array sign_of_max_comp;
-
+    T magnitude_resolution;
+    T component_resolution;
     /**
-     * @brief Bit arrays that store the scaled-down representations of each vector component.
+     * @}
      */
-    std::array<bit_array, N - 1> component_scaled_values;
-
-    TRACKED_CONSTANT_SC(size_t, quat_magnitude_sz, (quat_sz - 3 * quat_component_sz));
-    TRACKED_CONSTANT_SC(size_t, vec_min_sz, 2 + 2 * vec_component_sz + 1); // + 1 for the sign serializer
-
-    TRACKED_CONSTANT_SC(size_t, print_size, 13 * N + (N - 1) + 1); // 13 characters per value in the array,
-                                                                   // N - 1 commas, 1 null character
 
     /**
      * @brief Construct a new Serializer object.
@@ -420,128 +497,96 @@ class VectorSerializer : public SerializerBase<std::array<T, N>> {
      *             than the minimum possible size for float/double vectors, construction will fail.
      */
     VectorSerializer(T min, T max, T size)
-        : SerializerBase<std::array<T, N>>(dummy_vector, dummy_vector, size, print_size),
+        : SerializerBase<std::array<T, N>>(dummy_vector, dummy_vector, size),
           magnitude_min(min),
-          magnitude_max(max)
+          magnitude_max(max),
+          magnitude_sz(size - vec_min_sz),
+          component_resolution(Encoder::resolution_of(component_min(), component_max(), component_sz))
     {
         static_assert(N == 3, "An argumented constructor can only be used for a vector.");
         // Store min and max information for access by the telemetry info generator
         this->_min[0] = min;
         this->_max[0] = max;
-        construct_vector_serializer(min, max, size);
+
+        assert(min <= max);
+        if (min > max) magnitude_min = max;
+        magnitude_resolution = Encoder::resolution_of(magnitude_min, magnitude_max, magnitude_sz);
     }
 
     /**
      * @brief Default constructor, appropriate for quaternions.
      */
-    VectorSerializer() : SerializerBase<std::array<T, N>>(dummy_vector, dummy_vector, quat_sz, print_size),
+    VectorSerializer() : SerializerBase<std::array<T, N>>(dummy_vector, dummy_vector, quat_sz),
         magnitude_min(0),
-        magnitude_max(1)
+        magnitude_max(1),
+        magnitude_sz(0),
+        magnitude_resolution(0),
+        component_resolution(Encoder::resolution_of(component_min(), component_max(), component_sz))
     {
         static_assert(N == 4, "Default constructor may only be used for quaternions.");
-        construct_vector_serializer(0, 1, quat_sz);
-    }
-
-    VectorSerializer<T, N, quat_sz, vec_component_sz, quat_component_sz>& 
-    operator=(const VectorSerializer<T, N, quat_sz, vec_component_sz, quat_component_sz>& other) {
-        SerializerBase<std::array<T, N>>::operator=(other);
-        copy_vector_values(other);
-        return *this;
     }
 
   public:
     void serialize(const std::array<T, N>& src) override {
-        bit_array::iterator serialized_position = this->serialized_val.begin();
-
-        lin::Vector<T, N> normd; // short for normalized; normd = normalized
         std::array<T, N> src_norm(src);
 
         // src should already be normalized, but normalize again just in case
         // this block of code normalizes iff N == 4
         // otherwise, when N == 3, src_norm is not normalized
-        if(N == 4) {
-            normd = {src[0], src[1], src[2], src[3]};
-        
-            normd = normd / lin::norm(normd);
-            
-            for(unsigned int i = 0; i<N; i++){
-                src_norm[i] = normd(i);
-            }
+        if (N == 4) {
+            T norm_sq = 0;
+            for (size_t i = 0; i < N; i++) norm_sq += src[i] * src[i];
+            const T norm = std::sqrt(norm_sq);
+            for (size_t i = 0; i < N; i++) src_norm[i] = src[i] / norm;
         }
-        
+
         // Get and store index of maximum-valued component
-        std::array<T, N> v_mags;
         T max_element_mag = 0;
         unsigned int max_component_idx = 0;
         for (size_t i = 0; i < N; i++) {
-            v_mags[i] = std::abs(src_norm[i]);
-            if (max_element_mag < v_mags[i]) {
-                max_element_mag = v_mags[i];
+            const T element_mag = std::abs(src_norm[i]);
+            if (max_element_mag < element_mag) {
+                max_element_mag = element_mag;
                 max_component_idx = i;
             }
         }
-
-        max_component.set_int(max_component_idx);
-        std::copy(max_component.begin(), max_component.end(), serialized_position);
-        std::advance(serialized_position, max_component.size());
-        
-        // Store serialized magnitude
-        T mag = 0.0f;
-        if (N == 4)
-            mag = 1.0f;
-        else {
-            for (size_t i = 0; i < 3; i++) {
-                mag += src_norm[i] * src_norm[i];
-            }
-        }
-
-        // actually turns mag^2 to mag
-        mag = std::sqrt(mag);
-
-        // only serialize the magnitude if N == 3
-        if(N == 3){
-            magnitude_serializer->serialize(mag);
-            std::copy(magnitude_serializer->get_bit_array().begin(), 
-                    magnitude_serializer->get_bit_array().end(),
-                    serialized_position);
-            std::advance(serialized_position, magnitude_serializer->bitsize());
+        size_t position = 0;
+        write_field(position, index_sz, max_component_idx);
+        position += index_sz;
+
+        // Store serialized magnitude; only vectors have one
+        T mag = 1;
+        if (N == 3) {
+            mag = 0;
+            for (size_t i = 0; i < N; i++) mag += src_norm[i] * src_norm[i];
+            mag = std::sqrt(mag);
+
+            write_field(position, magnitude_sz,
+                Encoder::encode(mag, magnitude_min, magnitude_max, magnitude_resolution,
+                    Encoder::num_intervals_of(magnitude_sz)));
+            position += magnitude_sz;
         }
 
-        // will only ever be true for N == 4 and max_comp being negative
-        bool flip_vals = false;
-        if(N == 4 && src[max_component_idx] < 0)
-            flip_vals = true;
+        // the negative of a quaternion is the same quaternion
+        // thus to indicate sign of the largest component, negate all other components
+        const bool flip_vals = N == 4 && src[max_component_idx] < 0;
 
         // Store serialized non-maximal components
-        size_t component_number = 0;
         for (size_t i = 0; i < N; i++) {
-            if (i != max_component_idx) {
-                T element_scaled = src_norm[i] / mag;
+            if (i == max_component_idx) continue;
 
-                // the negative of a quaternion is the same quaternion
-                // thus to indicate sign of the largest component, negate all other components
-                if(flip_vals)
-                    element_scaled *= -1;
+            T element_scaled = src_norm[i] / mag;
+            if (flip_vals) element_scaled *= -1;
 
-                vector_element_serializers[component_number]->serialize(element_scaled);
-
-                std::copy(vector_element_serializers[component_number]->get_bit_array().begin(),
-                          vector_element_serializers[component_number]->get_bit_array().end(),
-                          serialized_position);
-                std::advance(serialized_position, vector_element_serializers[component_number]->bitsize());
-                component_number++;
-            }
+            write_field(position, component_sz,
+                Encoder::encode(element_scaled, component_min(), component_max(), component_resolution,
+                    Encoder::num_intervals_of(component_sz)));
+            position += component_sz;
         }
 
-        // if it's a vector, you must use an additional bit 
+        // if it's a vector, you must use an additional bit
         // to determine the sign of the largest component
-        if(N == 3){
-            if(src_norm[max_component_idx] < 0){
-                sign_of_max_comp.set_int(1);
-            }
-            std::copy(sign_of_max_comp.begin(), sign_of_max_comp.end(), serialized_position);
-            std::advance(serialized_position, sign_of_max_comp.size());
-        }        
+        if (N == 3) this->serialized_val[position] = src_norm[max_component_idx] < 0;
     }
 
     bool deserialize(const char* val, std::array<T, N>* dest) override {
@@ -567,90 +612,63 @@ class VectorSerializer : public SerializerBase<std::array<T, N>> {
     }
 
     void deserialize(std::array<T, N>* dest) const override {
-        // a counter to keep track of the current serialized val index to process
-        unsigned int idx_pointer = 0;
-
-        // read which component index is highest into a bitset for later use
-        std::bitset<2> max_comp_bitset(0);
-        for(size_t i = 0; i<max_component.size(); i++){
-            max_comp_bitset[i] = this->serialized_val[idx_pointer];
-            //max_component[i] = this->serialized_val[idx_pointer];
-            idx_pointer++;
+        size_t position = 0;
+        const unsigned int max_component_idx =
+            this->serialized_val.to_ullong(position, index_sz);
+        position += index_sz;
+
+        T magnitude = 1;
+        if (N == 3) {
+            magnitude = Encoder::decode(this->serialized_val.to_ullong(position, magnitude_sz),
+                magnitude_min, magnitude_resolution);
+            position += magnitude_sz;
         }
-        
-        // if there's a magnitude serializer, save data into the member variable
-        if(N == 3){
-            bit_array& local_arr_ref = const_cast <bit_array&>(magnitude_serializer->get_bit_array());
-            for(size_t i = 0; i < magnitude_serializer->bitsize(); i++){
-                local_arr_ref[i] = this->serialized_val[idx_pointer];
-                idx_pointer++;
-            }
-            magnitude_serializer->set_bit_array(local_arr_ref);
-        }
-
-        // loop through each serializer
-        for(unsigned int i = 0; i<(N-1); i++){
-            bit_array& local_arr_ref = const_cast <bit_array&>(vector_element_serializers[i]->get_bit_array());
-            // loop through each bit belonging to the serializer
-            for(size_t j = 0; j < vector_element_serializers[i]->bitsize(); j++){       
-                local_arr_ref[j] = this->serialized_val[idx_pointer];
-                idx_pointer++;
-            }
-
-            vector_element_serializers[i]->set_bit_array(local_arr_ref);
-        }
-
-        // set to true if N == 3 and max. comp is negative
-        bool max_comp_is_negative = false;
-        if (N == 3){
-            max_comp_is_negative = this->serialized_val[idx_pointer];
-            idx_pointer++;
-        }    
-
-        T magnitude = 0.0;
-        if(N == 3)
-            magnitude_serializer->deserialize(&magnitude);
-        else
-            magnitude = 1.0;
-
-        // completely bypass member bit_array max_component;
-        unsigned int deser_max_idx = max_comp_bitset.to_ulong();
 
-        (*dest)[deser_max_idx] = 1.0;
-        int j = 0;  // Index of current component being processed
+        (*dest)[max_component_idx] = 1.0;
         for (size_t i = 0; i < N; i++) {
-            if (i != deser_max_idx) {
-                vector_element_serializers[j]->deserialize(&(*dest)[i]);
+            if (i == max_component_idx) continue;
 
-                // at this point in the code, (*dest)[i] contains x/r, y/r
-                // assuming z is largest magnitude
+            (*dest)[i] = Encoder::decode(this->serialized_val.to_ullong(position, component_sz),
+                component_min(), component_resolution);
+            position += component_sz;
 
-                (*dest)[deser_max_idx] -= (*dest)[i] * (*dest)[i]; // subtract off; z^2/r^2 = 1 - x^2/r^2 ...
-                j++;
-            }
+            // at this point in the code, (*dest)[i] contains x/r, y/r
+            // assuming z is largest magnitude
+            (*dest)[max_component_idx] -= (*dest)[i] * (*dest)[i]; // subtract off; z^2/r^2 = 1 - x^2/r^2 ...
         }
-        (*dest)[deser_max_idx] = sqrt((*dest)[deser_max_idx]);
+        (*dest)[max_component_idx] = std::sqrt((*dest)[max_component_idx]);
 
         // multiply by magnitude, only actually does anything for N == 3
         for (size_t i = 0; i < N; i++) (*dest)[i] *= magnitude;
 
         // flip sign of max comp of vector if necessary
-        if(N == 3){
-            if(max_comp_is_negative == 1){
-                (*dest)[deser_max_idx] *= -1;
-            }
-        }
+        if (N == 3 && this->serialized_val[position]) (*dest)[max_component_idx] *= -1;
     }
 
     const char* print(const std::array<T, N>& src) const override {
         size_t str_idx = 0;
-        for (size_t i = 0; i < N; i++) {
-            str_idx += sprintf(this->printed_val + str_idx, "%6.6f,", src[i]);
+        for (size_t i = 0; i < N && str_idx < this->print_buffer_size; i++) {
+            str_idx += snprintf(this->printed_val + str_idx, this->print_buffer_size - str_idx,
+                "%6.6f,", src[i]);
         }
         return this->printed_val;
     }
 };
 
+template<typename T,
+         size_t N,
+         size_t qsz,
+         size_t vcsz,
+         size_t qcsz>
+constexpr size_t VectorSerializer<T, N, qsz, vcsz, qcsz>::index_sz;
+
+template<typename T,
+         size_t N,
+         size_t qsz,
+         size_t vcsz,
+         size_t qcsz>
+constexpr size_t VectorSerializer<T, N, qsz, vcsz, qcsz>::component_sz;
+
 template<typename T,
          size_t N,
          size_t qsz,
@@ -762,7 +780,7 @@ class Serializer<lin::Vector<T, N>> : public SerializerBase<lin::Vector<T, N>> {
         SerializerBase<lin::Vector<T, N>>(
             lin::zeros<T, N, 1>(),
             lin::zeros<T, N, 1>(),
-            0, 0),
+            0),
         _arr_sr(min, max, size)
     {
         // Store min and max information for access by the telemetry info generator
@@ -775,7 +793,7 @@ class Serializer<lin::Vector<T, N>> : public SerializerBase<lin::Vector<T, N>> {
         SerializerBase<lin::Vector<T, N>>(
             lin::zeros<T, N, 1>(),
             lin::zeros<T, N, 1>(),
-            0, 0),
+            0),
         _arr_sr()
     {
         static_assert(N == 4, "A default constructor can only be used for a quaternion.");
@@ -810,38 +828,68 @@ class Serializer<lin::Vector<T, N>> : public SerializerBase<lin::Vector<T, N>> {
 
 /**
  * @brief Specialization of Serializer for GPS time.
+ *
+ * The first bit says whether the time is set. By default, the rest holds the week
+ * number, the time of week in milliseconds and the nanoseconds past the millisecond.
+ * In delta mode, it instead holds the number of nanoseconds since an epoch, which takes
+ * fewer bits for the range of times that a mission will see. Times before the epoch or
+ * past the largest delta are clamped, like other serializers clamp to their bounds.
  */
 template <>
 class Serializer<gps_time_t> : public SerializerBase<gps_time_t> {
   public:
     TRACKED_CONSTANT_SC(size_t, gps_time_sz, 68);
+    TRACKED_CONSTANT_SC(size_t, gps_wn_sz, 16);
+    TRACKED_CONSTANT_SC(size_t, gps_tow_sz, 31);
+    TRACKED_CONSTANT_SC(size_t, gps_ns_sz, 20);
     static const gps_time_t dummy_gpstime;
 
-    TRACKED_CONSTANT_SC(size_t, print_size, 25); // wn: 5, tow: 10, ns: 7, 2 commas, 1 NULL character. 
-
     Serializer()
-        : SerializerBase<gps_time_t>(dummy_gpstime, dummy_gpstime, gps_time_sz, print_size)
+        : SerializerBase<gps_time_t>(dummy_gpstime, dummy_gpstime, gps_time_sz),
+          epoch(), delta_size(0), max_delta(0)
     {}
 
+    /**
+     * @brief Construct a serializer in delta mode.
+     *
+     * @param _epoch      Time that is serialized as a delta of zero.
+     * @param _delta_size Number of bits in the delta, between 1 and 62. 56 bits cover a
+     *                    little over two years.
+     */
+    Serializer(const gps_time_t& _epoch, size_t _delta_size)
+        : SerializerBase<gps_time_t>(_epoch,
+              gps_time_t::from_ns(_epoch.to_ns() + ((static_cast<int64_t>(1) << _delta_size) - 1)),
+              _delta_size + 1),
+          epoch(_epoch), delta_size(_delta_size),
+          max_delta((static_cast<int64_t>(1) << _delta_size) - 1)
+    {
+        assert(_delta_size >= 1 && _delta_size <= 62);
+    }
+
     void serialize(const gps_time_t& src) override {
-        if (!src.is_set) {
-            serialized_val[0] = false;
+        serialized_val.set_ullong(0, 1, src.is_set);
+        if (!src.is_set) return;
+
+        if (delta_size > 0) {
+            const int64_t delta = src.ns_since(epoch);
+            serialized_val.set_ullong(1, delta_size,
+                delta < 0 ? 0 : (delta > max_delta ? max_delta : delta));
             return;
         }
-        serialized_val[0] = true;
-        std::bitset<16> wn((unsigned short int)src.wn);
-        std::bitset<32> tow(src.tow);
-        std::bitset<20> ns(src.ns);
-        for (size_t i = 0; i < wn.size(); i++) serialized_val[i + 1] = wn[i];
-        for (size_t i = 0; i < tow.size(); i++) serialized_val[i + 1 + wn.size()] = tow[i];
-        for (size_t i = 0; i < ns.size(); i++)
-            serialized_val[i + 1 + wn.size() + tow.size()] = ns[i];
+
+        // Normalize the time so that the nanoseconds aren't negative, as they can be
+        // when they come from the Piksi.
+        const gps_time_t t = gps_time_t::from_ns(src.to_ns());
+        serialized_val.set_ullong(1, gps_wn_sz, t.wn);
+        serialized_val.set_ullong(1 + gps_wn_sz, gps_tow_sz, t.tow);
+        serialized_val.set_ullong(1 + gps_wn_sz + gps_tow_sz, gps_ns_sz, t.ns);
     }
 
     bool deserialize(const char* val, gps_time_t* dest) override {
         size_t num_values_found = sscanf(val, "%hu,%d,%d", &(dest->wn),
                                          &(dest->tow), &(dest->ns));
         if (num_values_found != 3) return false;
+        dest->is_set = true;
 
         serialize(*dest);
         return true;
@@ -852,22 +900,30 @@ class Serializer<gps_time_t> : public SerializerBase<gps_time_t> {
             dest->is_set = false;
             return;
         }
-        else {
-            dest->is_set = true;
+
+        if (delta_size > 0) {
+            *dest = gps_time_t::from_ns(epoch.to_ns()
+                + static_cast<int64_t>(serialized_val.to_ullong(1, delta_size)));
+            return;
         }
-        std::bitset<16> wn;
-        std::bitset<32> tow;
-        std::bitset<20> ns;
-        for (size_t i = 0; i < 16; i++) wn.set(i, serialized_val[i + 1]);
-        for (size_t i = 0; i < 32; i++) tow.set(i, serialized_val[wn.size() + i + 1]);
-        for (size_t i = 0; i < 20; i++) ns.set(i, serialized_val[wn.size() + tow.size() + i + 1]);
-        dest->wn = (unsigned int)wn.to_ulong();
-        dest->tow = (unsigned int)tow.to_ulong();
-        dest->ns = (unsigned int)ns.to_ulong();
+
+        *dest = gps_time_t(
+            static_cast<unsigned short>(serialized_val.to_ullong(1, gps_wn_sz)),
+            static_cast<unsigned int>(serialized_val.to_ullong(1 + gps_wn_sz, gps_tow_sz)),
+            static_cast<unsigned long>(serialized_val.to_ullong(1 + gps_wn_sz + gps_tow_sz, gps_ns_sz)));
     }
 
     const char* print(const gps_time_t& src) const override {
-        sprintf(this->printed_val, "%hu,%d,%d", src.wn, src.tow, src.ns);
+        snprintf(this->printed_val, this->print_buffer_size, "%hu,%d,%d", src.wn, src.tow, src.ns);
         return this->printed_val;
     }
+
+  protected:
+    /**
+     * @brief Epoch of the delta mode, and the number of bits in the delta and the
+     * largest delta. The delta size is zero if the serializer isn't in delta mode.
+     */
+    gps_time_t epoch;
+    size_t delta_size;
+    int64_t max_delta;
 };
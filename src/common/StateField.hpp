@@ -65,6 +65,19 @@ class StateField : public virtual StateFieldBase {
     /**
      * @}
      */
+
+   protected:
+    /**
+     * @brief Memory used by a field whose most derived class has the given size.
+     */
+    memory_footprint memory_use_of(size_t size) const {
+        memory_footprint fp;
+        fp.values = sizeof(T);
+        fp.names = memory_footprint::heap_size(_name);
+        fp.other = size - sizeof(T);
+        fp.heap = fp.names;
+        return fp;
+    }
 };
 
 #include "StateFieldTypes.inl"
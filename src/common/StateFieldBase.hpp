@@ -2,6 +2,7 @@
 #define STATE_FIELD_BASE_HPP_
 
 #include "Nameable.hpp"
+#include "memory_footprint.hpp"
 
 /**
  * @brief Dummy class so that we can create pointers of type StateFieldBase that point to objects of
@@ -12,6 +13,11 @@ class StateFieldBase : public Nameable {
     virtual bool is_readable() const = 0;
     virtual bool is_writable() const = 0;
    public:
+    /**
+     * @brief Memory used by the field. See memory_footprint.
+     */
+    virtual memory_footprint memory_use() const = 0;
+
     virtual ~StateFieldBase() {};
 };
 
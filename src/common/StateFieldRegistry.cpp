@@ -2,65 +2,99 @@
 
 StateFieldRegistry::StateFieldRegistry() {}
 
+/**
+ * @brief Get the item at a position in a list of fields, or a null pointer if the
+ * position is out of range.
+ */
+template<typename T>
+static T* get_by_id(const std::vector<T*>& items, size_t id) {
+    return id < items.size() ? items[id] : nullptr;
+}
+
+/**
+ * @brief Find an item by name in an indexed list of fields, or return a null pointer
+ * if there is no such item.
+ */
+template<typename T>
+static T* find_by_name(const std::vector<T*>& items, const name_index<T>& index,
+                       const std::string &name) {
+    return get_by_id(items, index.find(items, name));
+}
+
 InternalStateFieldBase*
 StateFieldRegistry::find_internal_field(const std::string &name) const {
-    for (InternalStateFieldBase* field : internal_fields) {
-        if (name == field->name()) {
-            return field;
-        }
-    }
-
-    return nullptr;
+    return find_by_name(internal_fields, internal_fields_index, name);
 }
 
 ReadableStateFieldBase*
 StateFieldRegistry::find_readable_field(const std::string &name) const {
-    for (ReadableStateFieldBase* field : readable_fields) {
-        if (name == field->name()) return field;
-    }
-
-    return nullptr;
+    return find_by_name(readable_fields, readable_fields_index, name);
 }
 
 WritableStateFieldBase*
 StateFieldRegistry::find_writable_field(const std::string &name) const {
-    for (WritableStateFieldBase* field : writable_fields) {
-        if (name == field->name()) return field;
-    }
-
-    return nullptr;
+    return find_by_name(writable_fields, writable_fields_index, name);
 }
 
 SerializableStateFieldBase*
 StateFieldRegistry::find_eeprom_saved_field(const std::string &name) const {
-    for (ReadableStateFieldBase* field : eeprom_saved_fields) {
-        if (name == field->name()) return field;
-    }
-
-    return nullptr;
+    return find_by_name(eeprom_saved_fields, eeprom_saved_fields_index, name);
 }
 
 Event*
 StateFieldRegistry::find_event(const std::string &name) const {
-    for (Event* event : events) {
-        if (name == event->name()) return event;
-    }
-
-    return nullptr;
+    return find_by_name(events, events_index, name);
 }
 
 Fault*
 StateFieldRegistry::find_fault(const std::string &name) const {
-    for (Fault* fault : faults) {
-        if (name == fault->name()) return fault;
-    }
+    return find_by_name(faults, faults_index, name);
+}
+
+size_t StateFieldRegistry::find_internal_field_id(const std::string &name) const {
+    return internal_fields_index.find(internal_fields, name);
+}
+
+size_t StateFieldRegistry::find_readable_field_id(const std::string &name) const {
+    return readable_fields_index.find(readable_fields, name);
+}
+
+size_t StateFieldRegistry::find_writable_field_id(const std::string &name) const {
+    return writable_fields_index.find(writable_fields, name);
+}
+
+size_t StateFieldRegistry::find_event_id(const std::string &name) const {
+    return events_index.find(events, name);
+}
+
+size_t StateFieldRegistry::find_fault_id(const std::string &name) const {
+    return faults_index.find(faults, name);
+}
 
-    return nullptr;
+InternalStateFieldBase* StateFieldRegistry::get_internal_field(size_t id) const {
+    return get_by_id(internal_fields, id);
+}
+
+ReadableStateFieldBase* StateFieldRegistry::get_readable_field(size_t id) const {
+    return get_by_id(readable_fields, id);
+}
+
+WritableStateFieldBase* StateFieldRegistry::get_writable_field(size_t id) const {
+    return get_by_id(writable_fields, id);
+}
+
+Event* StateFieldRegistry::get_event(size_t id) const {
+    return get_by_id(events, id);
+}
+
+Fault* StateFieldRegistry::get_fault(size_t id) const {
+    return get_by_id(faults, id);
 }
 
 bool StateFieldRegistry::add_internal_field(InternalStateFieldBase* field) {
     if (find_internal_field(field->name())) return false;
     internal_fields.push_back(field);
+    internal_fields_index.insert_last(internal_fields);
     return true;
 }
 
@@ -68,9 +102,13 @@ bool StateFieldRegistry::add_readable_field(ReadableStateFieldBase* field) {
     if (find_readable_field(field->name())) return false;
     if (field->eeprom_save_period() > 0) {
         if (find_eeprom_saved_field(field->name())) return false;
-        else eeprom_saved_fields.push_back(field);
+        else {
+            eeprom_saved_fields.push_back(field);
+            eeprom_saved_fields_index.insert_last(eeprom_saved_fields);
+        }
     }
     readable_fields.push_back(field);
+    readable_fields_index.insert_last(readable_fields);
     return true;
 }
 
@@ -78,12 +116,14 @@ bool StateFieldRegistry::add_writable_field(WritableStateFieldBase* field) {
     if (!add_readable_field(field)) return false;
     if (find_writable_field(field->name())) return false;
     writable_fields.push_back(field);
+    writable_fields_index.insert_last(writable_fields);
     return true;
 }
 
 bool StateFieldRegistry::add_event(Event* event) {
     if (find_event(event->name())) return false;
     events.push_back(event);
+    events_index.insert_last(events);
     return true;
 }
 
@@ -96,5 +136,6 @@ bool StateFieldRegistry::add_fault(Fault* fault) {
     if (!add_writable_field(&fault->persistence_f)) return false;
 
     faults.push_back(fault);
+    faults_index.insert_last(faults);
     return true;
 }
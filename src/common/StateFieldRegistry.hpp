@@ -6,12 +6,22 @@
 #include "StateField.hpp"
 #include "Event.hpp"
 #include "Fault.hpp"
+#include "field_handle.hpp"
+#include "name_index.hpp"
 
 /**
  * @brief Registry of state fields and which tasks have read/write access to
  * the fields. StateField objects use this registry to verify valid access to
- * their values. Essentially, this class is a lightweight wrapper around
- * multimap.
+ * their values.
+ *
+ * Each list of fields is indexed by name, so lookups by name take constant time. Each
+ * field also has a dense integer ID, which is its position within its list. IDs do
+ * not change once a field is added, so code that runs often can find a field by name
+ * once, keep its ID or pointer, and never compare names again. The ID of a writable
+ * field is one less than its index in uplink packets.
+ *
+ * Fields that are listed in the field manifest can also be bound to their typed
+ * handle, after which they can be looked up by handle without a name lookup or a cast.
  */
 class StateFieldRegistry {
   public:
@@ -24,6 +34,11 @@ class StateFieldRegistry {
 
     StateFieldRegistry();
 
+    /**
+     * @brief Returned by the find_*_id() functions if there is no field with the given name.
+     */
+    static constexpr size_t invalid_id = static_cast<size_t>(-1);
+
     /**
      * @brief Find a field of a given name within the state registry and return a pointer to it.
      *
@@ -78,6 +93,40 @@ class StateFieldRegistry {
      */
     Fault* find_fault(const std::string &name) const;
 
+    /**
+     * @brief Find the ID of a field, event or fault of a given name within the state registry.
+     *
+     * @param[in] name Name of state field.
+     * @return ID of the field, or invalid_id if the field doesn't exist.
+     *
+     * @{
+     */
+    size_t find_internal_field_id(const std::string &name) const;
+    size_t find_readable_field_id(const std::string &name) const;
+    size_t find_writable_field_id(const std::string &name) const;
+    size_t find_event_id(const std::string &name) const;
+    size_t find_fault_id(const std::string &name) const;
+    /**
+     * @}
+     */
+
+    /**
+     * @brief Get the field, event or fault with a given ID.
+     *
+     * @param[in] id ID of state field.
+     * @return Pointer to field, or null pointer if there is no field with that ID.
+     *
+     * @{
+     */
+    InternalStateFieldBase* get_internal_field(size_t id) const;
+    ReadableStateFieldBase* get_readable_field(size_t id) const;
+    WritableStateFieldBase* get_writable_field(size_t id) const;
+    Event* get_event(size_t id) const;
+    Fault* get_fault(size_t id) const;
+    /**
+     * @}
+     */
+
     /**
      * @brief Adds a field to the registry.
      *
@@ -114,6 +163,49 @@ class StateFieldRegistry {
      * @param fault Data fault
      */
     bool add_fault(Fault* fault);
+
+    /**
+     * @brief Bind a field to its handle from the field manifest. The field must also be
+     * added to the registry as usual, since the handle only provides a faster lookup.
+     *
+     * @param handle Handle of the field.
+     * @param field  State field.
+     */
+    template<typename FieldType>
+    void bind_field(const field_handle<FieldType>& handle, FieldType* field) {
+        if (bound_fields.size() <= handle.id) bound_fields.resize(handle.id + 1, nullptr);
+        bound_fields[handle.id] = field;
+    }
+
+    /**
+     * @brief Get the field that is bound to a handle from the field manifest.
+     *
+     * @param handle Handle of the field.
+     * @return Pointer to field, or null pointer if no field is bound to the handle.
+     */
+    template<typename FieldType>
+    FieldType* get_field(const field_handle<FieldType>& handle) const {
+        if (handle.id >= bound_fields.size()) return nullptr;
+        return static_cast<FieldType*>(bound_fields[handle.id]);
+    }
+
+  protected:
+    /**
+     * @brief Name indices of each list of fields.
+     */
+    name_index<InternalStateFieldBase> internal_fields_index;
+    name_index<ReadableStateFieldBase> readable_fields_index;
+    name_index<WritableStateFieldBase> writable_fields_index;
+    name_index<ReadableStateFieldBase> eeprom_saved_fields_index;
+    name_index<Event> events_index;
+    name_index<Fault> faults_index;
+
+    /**
+     * @brief Fields bound to each handle in the field manifest, indexed by handle ID. A
+     * slot can only be filled by bind_field() with a handle of the same field type as the
+     * one used by get_field(), so the pointers can be stored untyped.
+     */
+    std::vector<void*> bound_fields;
 };
 
 #endif
@@ -19,6 +19,8 @@ class InternalStateField : public StateField<T>, public InternalStateFieldBase {
     InternalStateField(const std::string &name) : 
         StateField<T>(name, false, false) {}
 
+    memory_footprint memory_use() const override { return this->memory_use_of(sizeof(*this)); }
+
     virtual ~InternalStateField() {}
 };
 
@@ -192,6 +194,16 @@ class SerializableStateField : public StateField<T>, virtual public Serializable
 
     virtual ~SerializableStateField() {}
 
+  protected:
+    /**
+     * @brief Memory used by a field whose most derived class has the given size.
+     */
+    memory_footprint memory_use_of(size_t size) const {
+        memory_footprint fp = StateField<T>::memory_use_of(size - sizeof(_serializer));
+        fp.serializers = sizeof(_serializer);
+        return fp;
+    }
+
   private:
     unsigned int __eeprom_save_period;
 };
@@ -217,6 +229,8 @@ class ReadableStateField : public SerializableStateField<T>, public ReadableStat
     ReadableStateField(const std::string &name, const Serializer<T> &s, unsigned int eeprom_save_period)
         : SerializableStateField<T>(name, false, s, eeprom_save_period) {}
 
+    memory_footprint memory_use() const override { return this->memory_use_of(sizeof(*this)); }
+
     /**
      * @brief Dummy function used by RTTI in telemetry information generation.
      */
@@ -244,8 +258,50 @@ class WritableStateField : public SerializableStateField<T>, public WritableStat
     WritableStateField(const std::string &name, const Serializer<T> &s, unsigned int eeprom_save_period)
         : SerializableStateField<T>(name, false, s, eeprom_save_period) {}
 
+    memory_footprint memory_use() const override { return this->memory_use_of(sizeof(*this)); }
+
     /**
      * @brief Dummy function used by RTTI in telemetry information generation.
      */
     virtual bool is_writable_field() const { return true; }
 };
+
+/**
+ * @brief A readable state field with a fixed-width serializer, which serializes the
+ * field's value without any division or branching. See FixedWidthSerializer.
+ *
+ * The field is a ReadableStateField<T>, so it's found and used like any other readable
+ * field. Moving a field over only requires changing its declaration, e.g.
+ * ReadableStateField<float> with Serializer<float>(0, 10, 16) becomes
+ * FixedReadableStateField<float, 16> with Serializer<float, 16>(0, 10).
+ *
+ * @tparam T Type of state field. Must be float or double.
+ * @tparam compressed_size Size, in bits, of field when its value is compressed.
+ */
+template <typename T, size_t compressed_size>
+class FixedReadableStateField : public ReadableStateField<T> {
+  public:
+    FixedReadableStateField(const std::string &name, const Serializer<T, compressed_size> &s)
+        : ReadableStateField<T>(name, s) {}
+
+    void serialize() override {
+        Serializer<T, compressed_size>::serialize(this->_serializer, this->_val);
+    }
+};
+
+/**
+ * @brief A writable state field with a fixed-width serializer. See FixedReadableStateField.
+ *
+ * @tparam T Type of state field. Must be float or double.
+ * @tparam compressed_size Size, in bits, of field when its value is compressed.
+ */
+template <typename T, size_t compressed_size>
+class FixedWritableStateField : public WritableStateField<T> {
+  public:
+    FixedWritableStateField(const std::string &name, const Serializer<T, compressed_size> &s)
+        : WritableStateField<T>(name, s) {}
+
+    void serialize() override {
+        Serializer<T, compressed_size>::serialize(this->_serializer, this->_val);
+    }
+};
@@ -0,0 +1,137 @@
+#ifndef BIT_READER_HPP_
+#define BIT_READER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include "fixed_array.hpp"
+
+/**
+ * @brief Reads a sequence of bits out of a byte buffer, most significant bit of each byte
+ * first. This is the counterpart of bit_writer, and reads back exactly what a bit_writer
+ * with the same packet size wrote.
+ *
+ * The reader is a cursor over the buffer: it neither copies nor modifies the buffer, and
+ * reads up to 56 bits at a time, so the cost of a read is proportional to the number of
+ * words read rather than the number of bits.
+ *
+ * If a packet size is provided, the one-bit header at the beginning of every packet is
+ * skipped as it is reached, so that reads only return the payload of the packets. Fields
+ * that straddle a packet boundary are joined automatically.
+ */
+class bit_reader {
+  public:
+    /**
+     * @brief Construct a new bit reader.
+     *
+     * @param src         Source buffer.
+     * @param size        Size of the source buffer in bytes.
+     * @param packet_size Size of a packet in bits, including its header bit. If zero,
+     *                    the input is not split into packets. Otherwise it must be
+     *                    at least two.
+     */
+    bit_reader(const char* src, size_t size, size_t packet_size = 0) :
+        src(reinterpret_cast<const uint8_t*>(src)),
+        size_bytes(size),
+        packet_size(packet_size),
+        pos(0),
+        end(8 * size) {}
+
+    /**
+     * @brief Number of bits that are left to be read, not counting packet headers.
+     */
+    size_t remaining() const {
+        if (packet_size == 0) return end - pos;
+        return (end - pos) - (headers_before(end) - headers_before(pos));
+    }
+
+    /**
+     * @brief Read bits from the buffer. The caller must check that enough bits remain.
+     *
+     * @param num_bits Number of bits to read. Must be at most 64.
+     * @return The bits that were read. Bit 0 is the first bit that was read.
+     */
+    unsigned long long read(size_t num_bits) {
+        uint64_t val = 0;
+        size_t num_read = 0;
+        while (num_read < num_bits) {
+            if (packet_size > 0 && pos % packet_size == 0) pos++;
+
+            size_t n = num_bits - num_read;
+            if (n > max_chunk) n = max_chunk;
+            if (packet_size > 0 && n > packet_size - pos % packet_size)
+                n = packet_size - pos % packet_size;
+
+            val |= (reverse(load(pos / 8) << (pos % 8)) & low_mask(n)) << num_read;
+            pos += n;
+            num_read += n;
+        }
+        return val;
+    }
+
+    /**
+     * @brief Read one bit from the buffer. The caller must check that a bit remains.
+     */
+    bool read_bit() { return read(1) != 0; }
+
+    /**
+     * @brief Fill a bit array with bits read from the buffer. The caller must check that
+     * at least arr.size() bits remain.
+     */
+    void read(bit_array& arr) {
+        size_t start = 0;
+        for (; start + 64 <= arr.size(); start += 64) arr.set_ullong(start, 64, read(64));
+        if (start < arr.size()) arr.set_ullong(start, arr.size() - start, read(arr.size() - start));
+    }
+
+  private:
+    /**
+     * @brief Largest number of bits that is read from a loaded word at once. The read may
+     * start at any bit of the first byte that is loaded, so this leaves room for a read
+     * never to run past the eight loaded bytes.
+     */
+    static constexpr size_t max_chunk = 56;
+
+    static uint64_t low_mask(size_t n) {
+        return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+    }
+
+    /**
+     * @brief Reverses the order of the bits in a 64-bit word.
+     */
+    static uint64_t reverse(uint64_t x) {
+        x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+        x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+        return (x >> 32) | (x << 32);
+    }
+
+    /**
+     * @brief Load eight bytes starting at the given byte into a word, with the first byte
+     * in the most significant byte of the word. Bytes past the end of the buffer are zero.
+     */
+    uint64_t load(size_t byte) const {
+        uint64_t word = 0;
+        for (size_t i = 0; i < 8; i++) {
+            word <<= 8;
+            if (byte + i < size_bytes) word |= src[byte + i];
+        }
+        return word;
+    }
+
+    /**
+     * @brief Number of packet headers at bit positions less than the given position.
+     */
+    size_t headers_before(size_t bit) const {
+        return (bit + packet_size - 1) / packet_size;
+    }
+
+    const uint8_t* src;
+    const size_t size_bytes;
+    const size_t packet_size;
+    size_t pos;
+    const size_t end;
+};
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef BIT_WRITER_HPP_
+#define BIT_WRITER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include "fixed_array.hpp"
+
+/**
+ * @brief Writes a sequence of bits into a byte buffer, most significant bit of each byte
+ * first. This is the bit order used by downlink snapshots, and it matches the order
+ * produced by bit_array::to_string().
+ *
+ * Bits are collected in a word-sized accumulator and are only stored to the buffer once
+ * a whole byte is available, so the cost of a write is proportional to the number of
+ * words written rather than the number of bits.
+ *
+ * The writer can optionally split its output into fixed-size packets. If a packet size is
+ * provided, a one-bit header is inserted at the beginning of every packet: a 1 for the
+ * first packet written and a 0 for every subsequent packet. Fields that straddle a packet
+ * boundary are split around the header automatically.
+ *
+ * Like bitstream, the writer does not allocate; the destination buffer must be large
+ * enough to hold everything that is written to it.
+ */
+class bit_writer {
+  public:
+    /**
+     * @brief Construct a new bit writer.
+     *
+     * @param dst         Destination buffer.
+     * @param packet_size Size of a packet in bits, including its header bit. If zero,
+     *                    the output is not split into packets. Otherwise it must be
+     *                    at least two.
+     */
+    explicit bit_writer(char* dst, size_t packet_size = 0) :
+        dst(reinterpret_cast<uint8_t*>(dst)),
+        packet_size(packet_size),
+        bits_to_boundary(0),
+        byte_offset(0),
+        acc(0),
+        acc_bits(0),
+        num_bits_written(0) {}
+
+    /**
+     * @brief Append the lowest num_bits bits of val to the buffer, least significant
+     * bit first.
+     *
+     * @param val      Bits to write. Bit 0 is written first.
+     * @param num_bits Number of bits to write. Must be at most 64.
+     */
+    void write(unsigned long long val, size_t num_bits) {
+        while (num_bits > 0) {
+            if (packet_size > 0 && bits_to_boundary == 0) {
+                push(num_bits_written == 0 ? 1 : 0, 1);
+                bits_to_boundary = packet_size - 1;
+            }
+
+            size_t n = num_bits;
+            if (n > max_chunk) n = max_chunk;
+            if (packet_size > 0 && n > bits_to_boundary) n = bits_to_boundary;
+
+            push(reverse(val) >> (64 - n), n);
+            val >>= n;
+            num_bits -= n;
+            if (packet_size > 0) bits_to_boundary -= n;
+        }
+    }
+
+    /**
+     * @brief Append the elements [start, end) of a bit array to the buffer.
+     */
+    void write(const bit_array& arr, size_t start, size_t end) {
+        for (; start + 64 <= end; start += 64) write(arr.to_ullong(start, 64), 64);
+        if (start < end) write(arr.to_ullong(start, end - start), end - start);
+    }
+
+    /**
+     * @brief Append a bit array to the buffer.
+     */
+    void write(const bit_array& arr) { write(arr, 0, arr.size()); }
+
+    /**
+     * @brief Store any buffered bits, padding the last byte with zeroes.
+     *
+     * @return Number of bytes of the buffer that were written.
+     */
+    size_t flush() {
+        if (acc_bits > 0) {
+            dst[byte_offset++] = static_cast<uint8_t>(acc << (8 - acc_bits));
+            acc = 0;
+            acc_bits = 0;
+        }
+        return byte_offset;
+    }
+
+    /**
+     * @brief Number of bits written so far, including packet headers.
+     */
+    size_t size() const { return num_bits_written; }
+
+  private:
+    /**
+     * @brief Largest number of bits that is pushed into the accumulator at once. After a
+     * push the accumulator holds fewer than eight unflushed bits, so this leaves room for
+     * the accumulator never to overflow.
+     */
+    static constexpr size_t max_chunk = 56;
+
+    /**
+     * @brief Reverses the order of the bits in a 64-bit word.
+     */
+    static uint64_t reverse(uint64_t x) {
+        x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+        x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+        return (x >> 32) | (x << 32);
+    }
+
+    /**
+     * @brief Append n bits to the accumulator, most significant bit first, and store
+     * all complete bytes.
+     */
+    void push(uint64_t bits, size_t n) {
+        acc = (acc << n) | bits;
+        acc_bits += n;
+        num_bits_written += n;
+        while (acc_bits >= 8) store_byte();
+    }
+
+    void store_byte() {
+        acc_bits -= 8;
+        dst[byte_offset++] = static_cast<uint8_t>(acc >> acc_bits);
+    }
+
+    uint8_t* dst;
+    const size_t packet_size;
+    size_t bits_to_boundary;
+    size_t byte_offset;
+
+    uint64_t acc;
+    size_t acc_bits;
+    size_t num_bits_written;
+};
+
+#endif
@@ -1,7 +1,80 @@
 #include "bitstream.h"
+#include <algorithm>
 #include <cstring>
 #include "fixed_array.hpp"
 
+namespace {
+
+/**
+ * @brief Returns a word whose lowest n bits are set. n must be at most 64.
+ */
+inline uint64_t low_mask(size_t n)
+{
+  return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+}
+
+/**
+ * @brief Loads up to eight bytes as a word, with the first byte in the lowest
+ * bits of the word. Bytes past the first num_bytes are zero.
+ */
+inline uint64_t load_word(const uint8_t* src, size_t num_bytes)
+{
+  uint64_t val = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (num_bytes >= 8) memcpy(&val, src, 8);
+  else memcpy(&val, src, num_bytes);
+#else
+  for (size_t i = 0; i < num_bytes && i < 8; ++i)
+    val |= static_cast<uint64_t>(src[i]) << (8*i);
+#endif
+  return val;
+}
+
+/**
+ * @brief Stores the lowest num_bytes bytes of a word, with the lowest bits of
+ * the word in the first byte. At most eight bytes are stored.
+ */
+inline void store_word(uint8_t* dst, size_t num_bytes, uint64_t val)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (num_bytes >= 8) memcpy(dst, &val, 8);
+  else memcpy(dst, &val, num_bytes);
+#else
+  for (size_t i = 0; i < num_bytes && i < 8; ++i)
+    dst[i] = static_cast<uint8_t>(val >> (8*i));
+#endif
+}
+
+/**
+ * @brief Slices of bit arrays as words, for reading and writing bit arrays a
+ * word at a time.
+ */
+inline uint64_t get_bits(const bit_array& bit_arr, size_t start, size_t len)
+{
+  return bit_arr.to_ullong(start, len);
+}
+
+inline uint64_t get_bits(const std::vector<bool>& bit_arr, size_t start, size_t len)
+{
+  uint64_t val = 0;
+  for (size_t i = 0; i < len; ++i)
+    val |= static_cast<uint64_t>(bit_arr[start + i]) << i;
+  return val;
+}
+
+inline void set_bits(bit_array& bit_arr, size_t start, size_t len, uint64_t val)
+{
+  bit_arr.set_ullong(start, len, val);
+}
+
+inline void set_bits(std::vector<bool>& bit_arr, size_t start, size_t len, uint64_t val)
+{
+  for (size_t i = 0; i < len; ++i, val >>= 1)
+    bit_arr[start + i] = val & 1;
+}
+
+}
+
 bitstream::bitstream(char* input, uint32_t stream_size) :
   bit_offset(0),
   stream(reinterpret_cast<uint8_t*>(input)),
@@ -16,13 +89,7 @@ bitstream::bitstream(const std::vector<bool>& bit_array, char* res) :
 {
   size_t stream_size = (bit_array.size() + 7)/8;
   for (size_t i = 0; i < stream_size; ++i)
-  {
-    res[i] = 0;
-    for (int j = 0; j < 8; ++j)
-    {
-      res[i] |= ( (bit_array[i*8 + j]) <<  j );
-    }
-  }
+    res[i] = static_cast<char>(get_bits(bit_array, i*8, std::min<size_t>(8, bit_array.size() - i*8)));
   max_len = stream_size;
   stream = reinterpret_cast<uint8_t*>(res);
 }
@@ -32,68 +99,99 @@ bool bitstream::has_next()
   return byte_offset < max_len;
 }
 
-size_t bitstream::next(size_t num_bits, uint8_t* u8)
+size_t bitstream::position() const
+{
+  return 8*static_cast<size_t>(byte_offset) + bit_offset;
+}
+
+size_t bitstream::remaining() const
 {
-  if (num_bits > 8) return 0;
-  uint8_t bits_read = 0;
-  uint8_t val = *reinterpret_cast<uint8_t*>(stream + byte_offset);
-  val >>= bit_offset;
-  
-  // Read until the next byte starts
-  size_t amt = 8 - bit_offset;
-  for (; bits_read < amt && bits_read < num_bits; val >>= 1, ++bits_read)
-    *u8 = bit_array::modify_bit(*u8, bits_read, val&1);
+  const size_t len = 8*static_cast<size_t>(max_len);
+  return position() < len ? len - position() : 0;
+}
+
+uint64_t bitstream::load_bits(size_t pos, size_t num_bits) const
+{
+  if (num_bits == 0) return 0;
+  const size_t byte = pos/8;
+  const size_t shift = pos%8;
+  uint64_t val = load_word(stream + byte, max_len - byte) >> shift;
+  // A read that starts partway into a byte may reach into a ninth byte
+  if (shift + num_bits > 64)
+    val |= static_cast<uint64_t>(stream[byte + 8]) << (64 - shift);
+  return val & low_mask(num_bits);
+}
 
-  // See if there is a next byte to write
-  if (byte_offset + 1 < max_len && bits_read < num_bits)
+void bitstream::store_bits(size_t pos, size_t num_bits, uint64_t val)
+{
+  if (num_bits == 0) return;
+  const size_t byte = pos/8;
+  const size_t shift = pos%8;
+  const size_t num_bytes = std::min<size_t>(8, max_len - byte);
+  const uint64_t mask = low_mask(num_bits) << shift;
+  const uint64_t old = load_word(stream + byte, num_bytes);
+  store_word(stream + byte, num_bytes, (old & ~mask) | ((val << shift) & mask));
+  // A write that starts partway into a byte may reach into a ninth byte
+  if (shift + num_bits > 64)
   {
-    val = *reinterpret_cast<uint8_t*>(stream + byte_offset + 1);
-    // Read to the beginning of the next byte
-    for (size_t i = 0; i < bit_offset && bits_read < num_bits; ++i, val >>= 1, ++bits_read)
-      *u8 = bit_array::modify_bit(*u8, bits_read, val&1);
+    const uint8_t high_mask = static_cast<uint8_t>(low_mask(shift + num_bits - 64));
+    stream[byte + 8] = (stream[byte + 8] & ~high_mask) | ((val >> (64 - shift)) & high_mask);
   }
-  seekG(bits_read, bs_end);
-  return bits_read;
 }
 
 size_t bitstream::nextN(size_t num_bits, uint8_t* res)
 {
   memset(res, 0, (num_bits + 7)/8);
-  size_t bits_written = 0;
-
-  size_t num_iters = num_bits/8;
-  for (size_t i = 0; i < num_iters && has_next(); ++i)
+  const size_t bits_read = std::min(num_bits, remaining());
+  size_t i = 0;
+  if (bit_offset == 0)
   {
-    bits_written  += next(8, res + i);
+    // Byte-aligned: copy the whole bytes, then read the remaining bits
+    i = bits_read - bits_read%8;
+    memcpy(res, stream + byte_offset, i/8);
   }
-  size_t modulo = num_bits%8;
-  if (modulo != 0 && has_next())
+  for (; i < bits_read; i += 64)
   {
-    bits_written += next(modulo, res + num_iters);
+    const size_t len = std::min<size_t>(64, bits_read - i);
+    store_word(res + i/8, (len + 7)/8, load_bits(position() + i, len));
   }
-  return bits_written;
+  seekG(bits_read, bs_end);
+  return bits_read;
 }
 
 size_t bitstream::nextN(size_t num_bits, std::vector<bool>& bit_arr)
+{
+  return next_bits(num_bits, bit_arr);
+}
+
+size_t bitstream::nextN(size_t num_bits, bit_array& bit_arr)
+{
+  return next_bits(num_bits, bit_arr);
+}
+
+size_t bitstream::nextN(size_t num_bits, uint64_t& res)
+{
+  if (num_bits > 64) return 0;
+  const size_t bits_read = std::min(num_bits, remaining());
+  res = load_bits(position(), bits_read);
+  seekG(bits_read, bs_end);
+  return bits_read;
+}
+
+template<typename BitArray>
+size_t bitstream::next_bits(size_t num_bits, BitArray& bit_arr)
 {
   size_t arr_size = bit_arr.size();
   if (arr_size < num_bits)
     return 0;
-  for (size_t i = 0; i < arr_size; ++i) bit_arr[i] = 0;
-  size_t bits_written = 0;
-  uint8_t u8 = 0;
-  for (; bits_written < num_bits && has_next(); ++bits_written)
+  const size_t bits_read = std::min(num_bits, remaining());
+  for (size_t i = 0; i < arr_size; i += 64)
   {
-    if ( next(1, &u8) )
-    {
-      bit_arr[bits_written] = u8;
-    }
-    else
-    {
-      break; // leave if there are no more bits available
-    }
+    const size_t len = std::min<size_t>(64, arr_size - i);
+    set_bits(bit_arr, i, len, i < bits_read ? load_bits(position() + i, std::min(len, bits_read - i)) : 0);
   }
-  return bits_written;
+  seekG(bits_read, bs_end);
+  return bits_read;
 }
 
 size_t bitstream::peekN(size_t num_bits, uint8_t* res)
@@ -114,6 +212,24 @@ size_t bitstream::peekN(size_t num_bits, std::vector<bool>& bit_arr)
   return bits_peeked;
 }
 
+size_t bitstream::peekN(size_t num_bits, bit_array& bit_arr)
+{
+  size_t bits_peeked = 0;
+
+  bits_peeked = nextN(num_bits, bit_arr);
+  seekG(bits_peeked, bs_beg);
+  return bits_peeked;
+}
+
+size_t bitstream::peekN(size_t num_bits, uint64_t& res)
+{
+  size_t bits_peeked = 0;
+
+  bits_peeked = nextN(num_bits, res);
+  seekG(bits_peeked, bs_beg);
+  return bits_peeked;
+}
+
 size_t bitstream::seekG(size_t amt, int dir)
 {
   if (dir != -1 && dir != 1)
@@ -136,65 +252,69 @@ size_t bitstream::seekG(size_t amt, int dir)
   return amt;
 }
 
-size_t bitstream::edit(size_t num_bits, uint8_t* val)
-{
-  uint8_t old = *reinterpret_cast<uint8_t*>(stream + byte_offset);
-  uint8_t u8 = *val;
-  uint8_t bits_written = 0;
-  // Write until the next byte starts
-  size_t amt = 8 - bit_offset;
-  for (size_t i = 0; i < amt && bits_written < num_bits; ++i, u8 >>= 1, ++bits_written)
-    old = bit_array::modify_bit(old, bit_offset + i, u8&1);
-  
-  // Write the lower bits
-  *reinterpret_cast<uint8_t*>(stream + byte_offset) = old;
-  
-  // See if there is a next byte to write
-  if (byte_offset + 1 < max_len && bits_written < num_bits)
+size_t bitstream::editN(size_t num_bits, uint8_t* new_val)
+{
+  const size_t bits_written = std::min(num_bits, remaining());
+  size_t i = 0;
+  if (bit_offset == 0)
   {
-    old = *reinterpret_cast<uint8_t*>(stream + byte_offset + 1);
-    // Write to the beginning of the next byte
-    for (size_t i = 0; i < bit_offset && bits_written < num_bits; ++i, u8 >>= 1, ++bits_written)
-    {
-      old = bit_array::modify_bit(old, i, u8&1);
-    }
-    // Write the rest of the upper bits
-    *reinterpret_cast<uint8_t*>(stream + byte_offset + 1) = old;
+    // Byte-aligned: copy the whole bytes, then write the remaining bits
+    i = bits_written - bits_written%8;
+    memcpy(stream + byte_offset, new_val, i/8);
+  }
+  for (; i < bits_written; i += 64)
+  {
+    const size_t len = std::min<size_t>(64, bits_written - i);
+    store_bits(position() + i, len, load_word(new_val + i/8, (len + 7)/8));
   }
   seekG(bits_written, bs_end);
   return bits_written;
 }
 
-size_t bitstream::editN(size_t num_bits, uint8_t* new_val)
+size_t bitstream::editN(size_t num_bits, bitstream& bs_other)
 {
-  size_t num_iters = num_bits/8;
-  if (num_iters > byte_offset + max_len)
-    num_iters = max_len - byte_offset;
-  size_t modulo = num_bits%8;
-  size_t bits_written = 0;
-  for (size_t i = 0; i < num_iters; ++i)
-  {
-    bits_written += edit(8, new_val + i);
-  }
-  if (modulo != 0)
+  // Consume up to [num_bits] from bs_other, and write as many of them as fit
+  const size_t bits_read = std::min(num_bits, bs_other.remaining());
+  const size_t bits_written = std::min(bits_read, remaining());
+  for (size_t i = 0; i < bits_written; i += 64)
   {
-    bits_written += edit(modulo, new_val + num_iters);
+    const size_t len = std::min<size_t>(64, bits_written - i);
+    store_bits(position() + i, len, bs_other.load_bits(bs_other.position() + i, len));
   }
+  bs_other.seekG(bits_read, bs_end);
+  seekG(bits_written, bs_end);
   return bits_written;
 }
 
-size_t bitstream::editN(size_t num_bits, bitstream& bs_other)
+size_t bitstream::editN(size_t num_bits, const std::vector<bool>& bit_arr)
 {
-  size_t arr_size = (num_bits + 7)/8;
-  uint8_t tmp[arr_size];
-  memset(tmp, 0, arr_size);
+  return edit_bits(num_bits, bit_arr);
+}
 
-  size_t bits_written = 0;
+size_t bitstream::editN(size_t num_bits, const bit_array& bit_arr)
+{
+  return edit_bits(num_bits, bit_arr);
+}
 
-  // Attempt to read [num_bits] from bs_other
-  bits_written = bs_other.nextN(num_bits, tmp);
-  // Write those bits to this bitstream
-  bits_written = editN(bits_written, tmp);
+size_t bitstream::editN(size_t num_bits, const uint64_t& new_val)
+{
+  if (num_bits > 64) return 0;
+  const size_t bits_written = std::min(num_bits, remaining());
+  store_bits(position(), bits_written, new_val);
+  seekG(bits_written, bs_end);
+  return bits_written;
+}
+
+template<typename BitArray>
+size_t bitstream::edit_bits(size_t num_bits, const BitArray& bit_arr)
+{
+  const size_t bits_written = std::min(std::min(num_bits, bit_arr.size()), remaining());
+  for (size_t i = 0; i < bits_written; i += 64)
+  {
+    const size_t len = std::min<size_t>(64, bits_written - i);
+    store_bits(position() + i, len, get_bits(bit_arr, i, len));
+  }
+  seekG(bits_written, bs_end);
   return bits_written;
 }
 
@@ -206,19 +326,25 @@ void bitstream::reset()
 
 bitstream& operator >>(bitstream& bs, uint32_t& res)
 {
-  bs.nextN(32, reinterpret_cast<uint8_t*>(&res));
+  uint64_t val = 0;
+  bs.nextN(32, val);
+  res = static_cast<uint32_t>(val);
   return bs;
 }
 
 bitstream& operator >>(bitstream& bs, uint16_t& res)
 {
-  bs.nextN(16, reinterpret_cast<uint8_t*>(&res));
+  uint64_t val = 0;
+  bs.nextN(16, val);
+  res = static_cast<uint16_t>(val);
   return bs;
 }
 
 bitstream& operator >>(bitstream& bs, uint8_t& res)
 {
-  bs.nextN(8, &res);
+  uint64_t val = 0;
+  bs.nextN(8, val);
+  res = static_cast<uint8_t>(val);
   return bs;
 }
 
@@ -230,19 +356,19 @@ bitstream& operator >>(bitstream& bs, std::vector<bool>& bit_arr)
 
 bitstream& operator <<(uint32_t& u32, bitstream& bs)
 { 
-  bs.editN(32, reinterpret_cast<uint8_t*>(&u32));
+  bs.editN(32, static_cast<uint64_t>(u32));
   return bs;
 }
 
 bitstream& operator <<(uint16_t& u16, bitstream& bs)
 {
-  bs.editN(16, reinterpret_cast<uint8_t*>(&u16));
+  bs.editN(16, static_cast<uint64_t>(u16));
   return bs;
 }
 
 bitstream& operator <<(uint8_t& u8, bitstream& bs)
 {
-  bs.editN(8, &u8);
+  bs.editN(8, static_cast<uint64_t>(u8));
   return bs;
 }
 
@@ -15,10 +15,14 @@
  * edit the stream
  * bitstream does not allocate any data, so it must be initialized with data
  * that stays in scope during the lifetime of the bitstream
+ *
+ * Bits are read and written up to 64 at a time, by shifting and masking words
+ * that are loaded from the stream. Byte-aligned spans are copied with memcpy.
  */
 #include <vector>
 #include <cstdint>
 #include <cstddef>
+#include "fixed_array.hpp"
 
 #define bs_beg -1 // bit stream in the direction towards the beginning
 #define bs_end 1 // bit stream in the direction towards end of the stream
@@ -86,6 +90,16 @@ class bitstream{
  * @param return 0 if bit_arr is not big enough else the number of bits read
  */
   size_t nextN(size_t num_bits, std::vector<bool>& bit_arr);
+  size_t nextN(size_t num_bits, bit_array& bit_arr);
+
+/**
+ * @brief Attempts to consume a specified number of bits from the current position
+ * and returns them in res. The first bit read is bit 0 of res.
+ * @param num_bits the number of bits to read. Maximum is 64
+ * @param res the unsigned int to store the consumed bits
+ * @return 0 if num_bits > 64, else the number of bits read
+ */
+  size_t nextN(size_t num_bits, uint64_t& res);
 
 /**
  * @brief Same as nextN but does not consume the bits
@@ -102,6 +116,8 @@ class bitstream{
  * @return the number of bits read
  */
   size_t peekN(size_t num_bits, std::vector<bool>& bit_arr);
+  size_t peekN(size_t num_bits, bit_array& bit_arr);
+  size_t peekN(size_t num_bits, uint64_t& res);
 
 /**
  * @brief Moves the position of the byte and bit pointer to a given offset
@@ -129,6 +145,25 @@ class bitstream{
  */
   size_t editN(size_t num_bits, bitstream& bs_other);
 
+/**
+ * @brief Write a number of bits from a bit array to this bitstream
+ * @param num_bits The number of bits to write. At most bit_arr.size() bits are
+ * written
+ * @param bit_arr The data source to read from
+ * @return the number of bits written
+ */
+  size_t editN(size_t num_bits, const std::vector<bool>& bit_arr);
+  size_t editN(size_t num_bits, const bit_array& bit_arr);
+
+/**
+ * @brief Write a number of bits from an unsigned int to this bitstream. Bit 0 of
+ * new_val is written first.
+ * @param num_bits The number of bits to write. Maximum is 64
+ * @param new_val The data source to read from
+ * @return 0 if num_bits > 64, else the number of bits written
+ */
+  size_t editN(size_t num_bits, const uint64_t& new_val);
+
 /**
  * @brief sets the byte_offset and bit_offset to 0
  */
@@ -137,23 +172,45 @@ class bitstream{
   private: //These functions are private because they are unsafe
 
 /**
- * @brief Attempts to consume a specified number of bits from the current position
- *  and returns them in u8
- * @param num_bits the number of bits to read. Maximum is 8
- * @param u8 a pointer to the unsigned int to write to
- * @return 0 if num_bits > 8, else the number of bits read
+ * @brief Returns the absolute bit offset of the current position
+ */
+  size_t position() const;
+
+/**
+ * @brief Returns the number of bits between the current position and the end of
+ * the stream
+ */
+  size_t remaining() const;
+
+/**
+ * @brief Reads bits from the stream without moving the current position
+ * @param pos absolute bit offset of the first bit to read
+ * @param num_bits the number of bits to read. Maximum is 64, and the bits must
+ * lie within the stream
+ * @return the bits read, with the first bit read as bit 0
+ */
+  uint64_t load_bits(size_t pos, size_t num_bits) const;
+
+/**
+ * @brief Writes bits to the stream without moving the current position
+ * @param pos absolute bit offset of the first bit to write
+ * @param num_bits the number of bits to write. Maximum is 64, and the bits must
+ * lie within the stream
+ * @param val the bits to write, with the first bit to write as bit 0
+ */
+  void store_bits(size_t pos, size_t num_bits, uint64_t val);
+
+/**
+ * @brief Implementation of nextN for std::vector<bool> and bit_array
  */
-  size_t next(size_t num_bits, uint8_t* u8);
+  template<typename BitArray>
+  size_t next_bits(size_t num_bits, BitArray& bit_arr);
 
 /**
- * @brief Writes a specified number of bits of the given unsigned byte to the
- * current position of the bitstream. The stream is "consumed", so bit_offset
- * and byte_offset will move to reflect the number of bits written
- * @param u8 8 bit unsigned int to write to the current position in the stream
- * @param num_bits the number of bits to write from u8
- * @return The number of bits written
+ * @brief Implementation of editN for std::vector<bool> and bit_array
  */
-  size_t edit(size_t num_bits, uint8_t* u8);
+  template<typename BitArray>
+  size_t edit_bits(size_t num_bits, const BitArray& bit_arr);
 
 };
 
@@ -1,10 +1,13 @@
 #include "debug_console.hpp"
 #include <ArduinoJson.h>
+#include <algorithm>
 #include <array>
 #include <cstdarg>
 
 #ifdef DESKTOP
+    #include <cstring>
     #include <iostream>
+    #include <unistd.h>
 #else
     #include <Arduino.h>
 #endif
@@ -31,6 +34,22 @@ std::map<debug_console::state_cmd_mode, const char*> debug_console::state_cmd_mo
 };
 
 bool debug_console::is_initialized = false;
+constexpr size_t debug_console::max_bulk_fields;
+#ifdef DESKTOP
+constexpr unsigned char debug_console::binary_sync;
+constexpr unsigned char debug_console::binary_more_flag;
+constexpr unsigned int debug_console::binary_error_flag;
+constexpr size_t debug_console::binary_header_size;
+constexpr size_t debug_console::max_binary_frame_size;
+spsc_ring<1 << 16> debug_console::input_ring;
+size_t debug_console::waiting_input_size = 0;
+std::mutex debug_console::input_mutex;
+std::condition_variable debug_console::input_cv;
+std::array<unsigned char, debug_console::max_binary_frame_size> debug_console::binary_in;
+std::array<unsigned char, debug_console::max_binary_frame_size> debug_console::binary_out;
+size_t debug_console::binary_out_len = 0;
+#endif
+bool debug_console::output_pending = false;
 #ifndef DESKTOP
 unsigned int debug_console::_start_time = 0;
 #else
@@ -168,16 +187,43 @@ void debug_console::process_commands(const StateFieldRegistry& registry) {
     char buf[SERIAL_BUF_SIZE] = {0};
 
 #ifdef DESKTOP
-    std::string input;
-    bool found_input = unprocessed_inputs.try_dequeue(input);
-    if (!found_input) return;
-    input.copy(buf, sizeof(buf));
+    // Process every message that has fully arrived. The rest of a message that has
+    // only partly arrived is waited for on the next call.
+    while (input_ring.size() > 0) {
+        unsigned char first_byte;
+        input_ring.peek(&first_byte, 1);
+        if (first_byte == binary_sync) {
+            if (!_process_binary_frame(registry)) break;
+            continue;
+        }
+
+        // JSON messages are sent one line at a time. A line that's too long for the
+        // buffer is processed in pieces, as if it had been several lines.
+        const size_t len = input_ring.peek(buf, SERIAL_BUF_SIZE - 1);
+        const char* newline = static_cast<const char*>(std::memchr(buf, '\n', len));
+        if (!newline && len < SERIAL_BUF_SIZE - 1) break;
+        const size_t line_len = newline ? newline - buf : len;
+        std::memset(buf + line_len, 0, SERIAL_BUF_SIZE - line_len);
+        input_ring.discard(newline ? line_len + 1 : line_len);
+        _process_json_msgs(registry, buf, SERIAL_BUF_SIZE);
+    }
+
+    waiting_input_size = input_ring.size();
+
+    if (output_pending) {
+        std::cout.flush();
+        output_pending = false;
+    }
 #else
     for (size_t i = 0; i < SERIAL_BUF_SIZE && Serial.available(); i++) {
         buf[i] = Serial.read();
     }
+    _process_json_msgs(registry, buf, SERIAL_BUF_SIZE);
 #endif
+}
 
+void debug_console::_process_json_msgs(const StateFieldRegistry& registry, char* buf,
+                                       size_t len) {
     TRACKED_CONSTANT_C(size_t, MAX_NUM_JSON_MSGS, 5);
 
     // Get all chunks of the buffer that are complete JSON messages. Read at
@@ -185,29 +231,44 @@ void debug_console::process_commands(const StateFieldRegistry& registry) {
     // can fit within a 512 byte buffer)
     size_t json_msg_starts[MAX_NUM_JSON_MSGS] = {0};
     size_t num_json_msgs_found = 0;
-    for (size_t i = 0; i < SERIAL_BUF_SIZE && num_json_msgs_found < MAX_NUM_JSON_MSGS; i++) {
+    for (size_t i = 0; i < len && num_json_msgs_found < MAX_NUM_JSON_MSGS; i++) {
         if (buf[i] == '{') {
             json_msg_starts[num_json_msgs_found] = i;
             num_json_msgs_found++;
         }
     }
 
-    // Deserialize all found JSON messages and check their validity
-    std::array<StaticJsonDocument<100>, MAX_NUM_JSON_MSGS> msgs;
-    std::array<bool, MAX_NUM_JSON_MSGS> msg_ok;
+    // Deserialize and process the messages one at a time, so that they can share a
+    // document that's large enough for a bulk command.
+#ifdef DESKTOP
+    StaticJsonDocument<4096> msg;
+#else
+    StaticJsonDocument<1024> msg;
+#endif
     for (size_t i = 0; i < num_json_msgs_found; i++) {
-        auto result = deserializeJson(msgs[i], &buf[json_msg_starts[i]]);
-        if (result == DeserializationError::Ok) {
-            msg_ok[i] = true;
+        auto result = deserializeJson(msg, &buf[json_msg_starts[i]]);
+        if (result != DeserializationError::Ok) continue;
+        JsonVariant msg_mode = msg["mode"];
+        JsonVariant field = msg["field"];
+
+        // Bulk commands list their fields instead of naming one
+        if (msg_mode.is<unsigned char>()) {
+            const unsigned char mode = msg_mode.as<unsigned char>();
+            if (mode == 'R' || mode == 'W') {
+                const char* fields[max_bulk_fields];
+                const char* vals[max_bulk_fields];
+                JsonArray field_list = msg["fields"];
+                JsonArray val_list = msg["vals"];
+                const size_t num_fields = std::min(field_list.size(), max_bulk_fields);
+                const size_t num_vals = std::min(val_list.size(), max_bulk_fields);
+                for (size_t j = 0; j < num_fields; j++) fields[j] = field_list[j].as<const char*>();
+                for (size_t j = 0; j < num_vals; j++) vals[j] = val_list[j].as<const char*>();
+                _process_bulk_cmd(registry, mode, fields, num_fields,
+                                  mode == 'W' ? vals : nullptr, num_vals,
+                                  msg["group"].as<const char*>());
+                continue;
+            }
         }
-    }
-
-    // For all valid messages, modify or print the relevant item in the state
-    // field registry
-    for (size_t i = 0; i < num_json_msgs_found; i++) {
-        if (!msg_ok[i]) continue;
-        JsonVariant msg_mode = msgs[i]["mode"];
-        JsonVariant field = msgs[i]["field"];
 
         // Check sanity of data
         if (field.isNull()) continue;
@@ -237,7 +298,7 @@ void debug_console::process_commands(const StateFieldRegistry& registry) {
                 }
             } break;
             case 'w': {
-                JsonVariant field_val = msgs[i]["val"];
+                JsonVariant field_val = msg["val"];
                 if (field_val.isNull()) {
                     _print_error_state_field(field_name, write_mode, missing_field_val);
                     break;
@@ -268,12 +329,279 @@ void debug_console::process_commands(const StateFieldRegistry& registry) {
     }
 }
 
+namespace {
+/**
+ * Writes part of a response to the console. Bulk responses are written as they're
+ * built instead of as a JSON document, so that their size isn't limited.
+ */
+void console_write(const char* str) {
 #ifdef DESKTOP
+    std::cout << str;
+#else
+    Serial.print(str);
+#endif
+}
+
+/**
+ * Writes a string to the console as a JSON string.
+ */
+void console_write_json_string(const char* str) {
+    console_write("\"");
+    const char* run = str;
+    for (const char* c = str; *c; c++) {
+        if (*c != '"' && *c != '\\' && static_cast<unsigned char>(*c) >= 0x20) continue;
+        char escaped[8];
+        snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(*c));
+#ifdef DESKTOP
+        std::cout.write(run, c - run);
+#else
+        Serial.write(run, c - run);
+#endif
+        console_write(escaped);
+        run = c + 1;
+    }
+    console_write(run);
+    console_write("\"");
+}
+
+/**
+ * Writes "name":"value" to the console, preceded by a comma unless it's the first
+ * member of an object.
+ */
+void console_write_member(const char* name, const char* val, bool& first) {
+    if (!first) console_write(",");
+    first = false;
+    console_write_json_string(name);
+    console_write(":");
+    console_write_json_string(val);
+}
+
+/**
+ * True if the field is in the group, i.e. its name is "<group>.<...>".
+ */
+bool in_group(const std::string& name, const char* group) {
+    const size_t len = strlen(group);
+    return name.size() > len && name.compare(0, len, group) == 0 && name[len] == '.';
+}
+}
+
+void debug_console::_process_bulk_cmd(const StateFieldRegistry& registry, unsigned char mode,
+                                      const char* const* fields, size_t num_fields,
+                                      const char* const* vals, size_t num_vals,
+                                      const char* group) {
+    // Errors are written after the values, so they're remembered until then
+    constexpr unsigned char no_error = 0xff;
+    unsigned char errors[max_bulk_fields];
+    assert(num_fields <= max_bulk_fields);
+
+    char t[16];
+    snprintf(t, sizeof(t), "%u", _get_elapsed_time());
+    console_write("{\"t\":");
+    console_write(t);
+    console_write(",\"fields\":{");
+
+    bool first = true;
+    bool any_errors = false;
+    if (num_fields > 0 || mode == 'W') {
+        for (size_t i = 0; i < num_fields; i++) {
+            errors[i] = no_error;
+            ReadableStateFieldBase* field_ptr =
+                fields[i] ? registry.find_readable_field(fields[i]) : nullptr;
+            if (!field_ptr) {
+                errors[i] = invalid_field_name;
+            }
+            // We allow writing to readable state fields in the debug console, so
+            // that input values can be simmed.
+            else if (mode == 'W' && (i >= num_vals || !vals[i])) {
+                errors[i] = missing_field_val;
+            }
+            else if (mode == 'W' && !field_ptr->deserialize(vals[i])) {
+                errors[i] = invalid_field_val;
+            }
+            else {
+                console_write_member(fields[i], field_ptr->print(), first);
+            }
+            any_errors |= errors[i] != no_error;
+        }
+    }
+    else {
+        for (ReadableStateFieldBase* field_ptr : registry.readable_fields) {
+            if (group && !in_group(field_ptr->name(), group)) continue;
+            console_write_member(field_ptr->name().c_str(), field_ptr->print(), first);
+        }
+    }
+    console_write("}");
+
+    if (any_errors) {
+        console_write(",\"errs\":{");
+        first = true;
+        for (size_t i = 0; i < num_fields; i++) {
+            if (errors[i] == no_error) continue;
+            console_write_member(fields[i] ? fields[i] : "",
+                state_field_error_strs[static_cast<state_field_error>(errors[i])], first);
+        }
+        console_write("}");
+    }
+
+#ifdef DESKTOP
+    console_write("}\n");
+    output_pending = true;
+#else
+    console_write("}");
+    Serial.println();
+#endif
+}
+
+#ifdef DESKTOP
+bool debug_console::_process_binary_frame(const StateFieldRegistry& registry) {
+    unsigned char* frame = binary_in.data();
+    if (input_ring.peek(frame, binary_header_size) < binary_header_size) return false;
+    const size_t frame_len = binary_header_size + (frame[2] | (frame[3] << 8));
+    if (frame_len > max_binary_frame_size) {
+        // This can't be a frame, so skip the sync byte and look for the next message.
+        input_ring.discard(1);
+        return true;
+    }
+    if (input_ring.peek(frame, frame_len) < frame_len) return false;
+    input_ring.discard(frame_len);
+
+    const unsigned char op = frame[1];
+    switch (op) {
+        case 'l':
+            _binary_list_fields(registry);
+            break;
+        case 'r':
+        case 'w':
+            _binary_read_write(registry, op, frame + binary_header_size,
+                               frame_len - binary_header_size);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+void debug_console::_binary_list_fields(const StateFieldRegistry& registry) {
+    _begin_binary_response('l');
+    for (size_t id = 0; id < registry.readable_fields.size(); id++) {
+        const ReadableStateFieldBase* field = registry.readable_fields[id];
+        const std::string& name = field->name();
+        unsigned char* out = _reserve_binary_response(4 + name.size() + 1);
+        out[0] = id & 0xff;
+        out[1] = id >> 8;
+        out[2] = field->bitsize() & 0xff;
+        out[3] = field->bitsize() >> 8;
+        std::memcpy(out + 4, name.c_str(), name.size() + 1);
+    }
+    _end_binary_response();
+}
+
+void debug_console::_binary_read_write(const StateFieldRegistry& registry, unsigned char op,
+                                       const unsigned char* payload, size_t len) {
+    _begin_binary_response('r');
+    if (op == 'r' && len == 0) {
+        for (size_t id = 0; id < registry.readable_fields.size(); id++)
+            _binary_response_field(id, *registry.readable_fields[id]);
+    }
+    size_t i = 0;
+    while (i + 2 <= len) {
+        const size_t id = payload[i] | (payload[i + 1] << 8);
+        i += 2;
+        ReadableStateFieldBase* field = registry.get_readable_field(id);
+        if (!field) {
+            _binary_response_error(id, invalid_field_name);
+            if (op == 'w') break;
+            continue;
+        }
+
+        if (op == 'w') {
+            // We allow writing to readable state fields in the debug console, so
+            // that input values can be simmed.
+            const size_t bitsize = field->bitsize();
+            const size_t val_len = (bitsize + 7) / 8;
+            if (i + val_len > len) {
+                _binary_response_error(id, missing_field_val);
+                break;
+            }
+            bit_array bits(bitsize);
+            for (size_t bit = 0; bit < bitsize; bit += 8)
+                bits.set_ullong(bit, std::min<size_t>(8, bitsize - bit), payload[i + bit / 8]);
+            i += val_len;
+            field->set_bit_array(bits);
+            field->deserialize();
+        }
+        _binary_response_field(id, *field);
+    }
+    _end_binary_response();
+}
+
+void debug_console::_binary_response_field(size_t id, const ReadableStateFieldBase& field) {
+    const bit_array& bits = field.get_bit_array();
+    const size_t bitsize = bits.size();
+    unsigned char* out = _reserve_binary_response(2 + (bitsize + 7) / 8);
+    out[0] = id & 0xff;
+    out[1] = id >> 8;
+    for (size_t bit = 0; bit < bitsize; bit += 8)
+        out[2 + bit / 8] = bits.to_ullong(bit, std::min<size_t>(8, bitsize - bit));
+}
+
+void debug_console::_binary_response_error(size_t id, state_field_error error) {
+    const size_t flagged_id = id | binary_error_flag;
+    unsigned char* out = _reserve_binary_response(3);
+    out[0] = flagged_id & 0xff;
+    out[1] = (flagged_id >> 8) & 0xff;
+    out[2] = error;
+}
+
+void debug_console::_begin_binary_response(unsigned char op) {
+    binary_out[0] = binary_sync;
+    binary_out[1] = op;
+    binary_out_len = binary_header_size;
+}
+
+unsigned char* debug_console::_reserve_binary_response(size_t n) {
+    if (binary_out_len + n > max_binary_frame_size) {
+        const unsigned char op = binary_out[1];
+        _end_binary_response(true);
+        _begin_binary_response(op);
+    }
+    unsigned char* out = &binary_out[binary_out_len];
+    binary_out_len += n;
+    return out;
+}
+
+void debug_console::_end_binary_response(bool more) {
+    const size_t payload_len = binary_out_len - binary_header_size;
+    if (more) binary_out[1] |= binary_more_flag;
+    binary_out[2] = payload_len & 0xff;
+    binary_out[3] = payload_len >> 8;
+    std::cout.write(reinterpret_cast<const char*>(binary_out.data()), binary_out_len);
+    output_pending = true;
+}
+
+void debug_console::wait_for_input(unsigned int timeout_ms) {
+    std::unique_lock<std::mutex> lock(input_mutex);
+    input_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                      [this] { return input_ring.size() > waiting_input_size; });
+}
+
 void debug_console::_reader() {
     while(running) {
-        std::string input;
-        std::getline(std::cin, input);
-        unprocessed_inputs.enqueue(input);
+        unsigned char* region;
+        const size_t free = input_ring.write_region(region);
+        if (free == 0) {
+            // Wait for process_commands() to catch up
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        const ssize_t n = ::read(STDIN_FILENO, region, free);
+        if (n <= 0) break;
+        input_ring.commit(n);
+
+        // Taking the lock ensures that a waiting thread either sees the new input or
+        // is already asleep and gets woken up.
+        { std::lock_guard<std::mutex> lock(input_mutex); }
+        input_cv.notify_one();
     }
 }
 #endif
@@ -7,10 +7,13 @@
 #include "StateFieldRegistry.hpp"
 
 #ifdef DESKTOP
+    #include <array>
     #include <chrono>
+    #include <condition_variable>
     #include <memory>
+    #include <mutex>
     #include <thread>
-    #include <concurrentqueue.h>
+    #include "spsc_ring.hpp"
 #else
     #include <Arduino.h>
 #endif
@@ -41,6 +44,42 @@ class debug_console {
     enum state_cmd_mode { unspecified_mode, read_mode, write_mode };
     static std::map<state_cmd_mode, const char *> state_cmd_mode_strs;
 
+#ifdef DESKTOP
+    /**
+     * @brief Binary framing of state field commands, an alternative to JSON for
+     * simulation computers that read and write many fields every control cycle.
+     * Commands in either format can be sent at any time; a binary frame is told apart
+     * from a JSON message by its first byte.
+     *
+     * A frame is a four-byte header followed by a payload. The header is the sync byte,
+     * an opcode, and the length of the payload as a little-endian 16-bit integer. In the
+     * payload, fields are identified by their IDs in the registry's list of readable
+     * fields, as little-endian 16-bit integers, and values are a field's serialized bits,
+     * packed into (bitsize + 7) / 8 bytes with the first bit in the least significant
+     * bit of the first byte.
+     *
+     * - 'l': The payload is empty. The response lists every readable field as its ID,
+     *        its bitsize as a 16-bit integer, and its NUL-terminated name.
+     * - 'r': The payload is a list of IDs. The response ('r') is each field's ID and value.
+     *        An empty list reads every readable field.
+     * - 'w': The payload is a list of IDs, each followed by a value to write to the field.
+     *        The response ('r') is each field's ID and value after the write.
+     *
+     * A field that couldn't be read or written appears in the response as its ID with
+     * binary_error_flag set, followed by a state_field_error as one byte. Since values
+     * can't be skipped without knowing the field, a write stops at the first error. A
+     * response that doesn't fit into one frame is split across several, and every frame
+     * but the last has binary_more_flag set in its opcode.
+     *
+     * Responses are not flushed until all of the commands that have arrived are processed.
+     */
+    static constexpr unsigned char binary_sync = 0xA5;
+    static constexpr unsigned char binary_more_flag = 0x80;
+    static constexpr unsigned int binary_error_flag = 0x8000;
+    static constexpr size_t binary_header_size = 4;
+    static constexpr size_t max_binary_frame_size = 4096;
+#endif
+
     debug_console();
 
     /**
@@ -75,6 +114,17 @@ class debug_console {
      */
     void process_commands(const StateFieldRegistry &registry);
 
+#ifdef DESKTOP
+    /**
+     * @brief Blocks until input arrives that process_commands() hasn't seen yet, or
+     * until the timeout passes. Lets a caller that polls for commands sleep instead of
+     * spinning.
+     *
+     * @param timeout_ms Maximum time to wait, in milliseconds.
+     */
+    void wait_for_input(unsigned int timeout_ms = 100);
+#endif
+
     /**
      * @brief Helper method to write state fields to the console. State fields might
      * be written to the console if they were requested by the computer or if they're
@@ -130,12 +180,96 @@ class debug_console {
     void _print_error_state_field(const char *field_name, const state_cmd_mode mode,
                                   const state_field_error error);
 
+    /**
+     * @brief Processes the JSON messages in a buffer of input.
+     */
+    void _process_json_msgs(const StateFieldRegistry &registry, char *buf, size_t len);
+
+    /**
+     * @brief Reads ('R') or writes ('W') several state fields at once, and prints the
+     * result as a single message.
+     *
+     * A read gets the listed fields, or if no fields are listed, every readable field
+     * whose name is in the given group (i.e. is "<group>.<...>"), or if there is no
+     * group, every readable field. A write sets each listed field to the value at the
+     * same position in vals.
+     *
+     * The response is {"t": ..., "fields": {<name>: <value>, ...}}, with the values
+     * after any write, plus "errs": {<name>: <error>, ...} if some fields couldn't be
+     * read or written. It is written out as it is built, so it can be any size.
+     *
+     * @param fields Names of the fields. At most max_bulk_fields are processed.
+     * @param vals   Values to write, or null for a read.
+     * @param group  Group to read, or null.
+     */
+    void _process_bulk_cmd(const StateFieldRegistry &registry, unsigned char mode,
+                           const char *const *fields, size_t num_fields,
+                           const char *const *vals, size_t num_vals, const char *group);
+
+    /**
+     * @brief Maximum number of fields that a bulk command can list.
+     */
+    static constexpr size_t max_bulk_fields = 64;
+
 #ifdef DESKTOP
     /**
-     * @brief Thread-safe queue for inputs found by reader thread.
+     * @brief Lock-free ring for input read from stdin by the reader thread. The input
+     * state is static, like is_initialized, since every control task is a debug console
+     * but there's only one reader thread.
+     */
+    static spsc_ring<1 << 16> input_ring;
+
+    /**
+     * @brief Number of bytes that process_commands() left in the input ring, because
+     * they're the start of a message that hasn't fully arrived.
+     */
+    static size_t waiting_input_size;
+
+    /**
+     * @brief Signaled by the reader thread whenever it adds input to the ring.
+     */
+    static std::mutex input_mutex;
+    static std::condition_variable input_cv;
+
+    /**
+     * @brief Processes the binary frame at the front of the input ring.
+     *
+     * @return False if the frame hasn't fully arrived yet.
+     */
+    bool _process_binary_frame(const StateFieldRegistry &registry);
+
+    /**
+     * @brief Responds to binary commands. See binary_sync for the format.
+     */
+    void _binary_list_fields(const StateFieldRegistry &registry);
+    void _binary_read_write(const StateFieldRegistry &registry, unsigned char op,
+                            const unsigned char *payload, size_t len);
+
+    /**
+     * @brief Builds binary response frames in binary_out, and writes a frame to stdout
+     * whenever the next entry wouldn't fit in it.
+     */
+    void _begin_binary_response(unsigned char op);
+    unsigned char *_reserve_binary_response(size_t n);
+    void _end_binary_response(bool more = false);
+
+    /**
+     * @brief Appends a field's ID and value, or an error, to the binary response.
      */
-    moodycamel::ConcurrentQueue<std::string> unprocessed_inputs;
+    void _binary_response_field(size_t id, const ReadableStateFieldBase &field);
+    void _binary_response_error(size_t id, state_field_error error);
 
+    static std::array<unsigned char, max_binary_frame_size> binary_in;
+    static std::array<unsigned char, max_binary_frame_size> binary_out;
+    static size_t binary_out_len;
+#endif
+
+    /**
+     * @brief True if responses have been written since the console output was last flushed.
+     */
+    static bool output_pending;
+
+#ifdef DESKTOP
     /**
      * @brief True if debug console is currently running.
      */
@@ -143,7 +277,7 @@ class debug_console {
 
     /**
      * @brief Collects input from stdin and passes it to process_commands via
-     * a thread-safe queue.
+     * the input ring.
      */
     void _reader();
 
@@ -0,0 +1,64 @@
+#ifndef FIELD_HANDLE_HPP_
+#define FIELD_HANDLE_HPP_
+
+#include <cstddef>
+
+/**
+ * @brief Typed reference to a state field that is listed in the field manifest.
+ *
+ * Handles are generated at compile time from src/field_manifest.csv by
+ * src/field_manifest_generator.py, and are defined in field_manifest.hpp. A control task
+ * that owns a field binds the field to its handle when it adds the field to the registry,
+ * and control tasks that use the field look it up with the same handle. The type of the
+ * field is part of the type of the handle, so binding or looking up a field with the wrong
+ * type does not compile, and the lookup needs neither a name comparison nor a cast that
+ * depends on RTTI.
+ *
+ * @tparam FieldType Type of the state field, e.g. ReadableStateField<unsigned int>.
+ */
+template<typename FieldType>
+struct field_handle {
+    /**
+     * @brief Position of the field in the manifest.
+     */
+    size_t id;
+
+    /**
+     * @brief Name of the field in the registry.
+     */
+    const char* name;
+
+    /**
+     * @brief Number of bits in the serialized field, or zero for internal fields.
+     */
+    size_t bitsize;
+};
+
+/**
+ * @brief Kinds of state field that can be listed in the field manifest.
+ */
+enum class field_kind : unsigned char {
+    internal,
+    readable,
+    writable
+};
+
+/**
+ * @brief Untyped description of a field in the field manifest, for code that needs to
+ * iterate over every field in the manifest.
+ */
+struct field_info {
+    const char* name;
+    field_kind kind;
+    const char* type;
+
+    /**
+     * @brief Serializer bounds and size. All three are zero for internal fields, which
+     * are not serialized.
+     */
+    double min;
+    double max;
+    size_t bitsize;
+};
+
+#endif
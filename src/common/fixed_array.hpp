@@ -4,7 +4,11 @@
 #include <algorithm>
 #include <array>
 #include <bitset>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <vector>
 
 /**
@@ -17,9 +21,8 @@
  * size as a template argument for the serializer (like we would have to if we used std::bitset).
  *
  * Notice that this class is not publicly constructible; we rely on fixed_array below to provide a
- * public interface. This is so that we can share implementation of a fixed array between generic
- * fixed arrays and the specialized boolean fixed array (below), which is the bitset used in
- * serialization/deserialization.
+ * public interface. The boolean fixed array (below), which is the bitset used in
+ * serialization/deserialization, does not use this class; it packs its bits into words instead.
  *
  * @tparam T Type held within array.
  */
@@ -123,17 +126,125 @@ class fixed_array : public fixed_array_base<T> {
 
 /**
  * @brief Acts like a stripped-down bitset.
+ *
+ * Unlike the generic fixed array, the bits are packed into an inline array of 64-bit words
+ * rather than being held in an std::vector. This means that a bit array never allocates
+ * memory, and that integers can be stored to and loaded from it a word at a time, which keeps
+ * set_int() and to_ullong() cheap for the serializers.
+ *
+ * The size of a bit array is bounded above by max_size; larger sizes are clamped to it. Bits
+ * past the end of the array are always kept at zero.
  */
 template <>
-class fixed_array<bool> : public fixed_array_base<bool> {
+class fixed_array<bool> {
    public:
     /**
-     * Same constructors as fixed_array_base, but made public.
+     * @brief Largest number of bits that a bit array can hold. This is larger than the
+     * largest serializer or event in flight software.
      */
-    fixed_array() : fixed_array_base<bool>() {}
-    explicit fixed_array(const size_t size) : fixed_array_base<bool>(size) {}
-    fixed_array(const fixed_array<bool>& arr) : fixed_array_base<bool>(arr) {}
-    fixed_array(const std::vector<bool>& arr) : fixed_array_base<bool>(arr) {}
+    static constexpr size_t max_size = 256;
+
+   private:
+    static constexpr size_t bits_per_word = 64;
+    static constexpr size_t num_words = max_size / bits_per_word;
+
+    /**
+     * @brief Returns a word whose lowest n bits are set. n must be at most 64.
+     */
+    static uint64_t low_mask(size_t n) {
+        return n >= bits_per_word ? ~0ULL : (1ULL << n) - 1;
+    }
+
+    size_t _size;
+    std::array<uint64_t, num_words> words;
+
+   public:
+    /**
+     * @brief Proxy for a single bit of the array, like std::vector<bool>::reference.
+     */
+    class reference {
+       public:
+        reference(uint64_t& word, size_t bit) : word(word), mask(1ULL << bit) {}
+        reference(const reference& other) = default;
+
+        operator bool() const { return (word & mask) != 0; }
+
+        reference& operator=(bool b) {
+            if (b) word |= mask;
+            else word &= ~mask;
+            return *this;
+        }
+
+        // Assigns the value of the other bit, rather than rebinding the reference.
+        reference& operator=(const reference& other) {
+            return *this = static_cast<bool>(other);
+        }
+
+       private:
+        uint64_t& word;
+        const uint64_t mask;
+    };
+
+    /**
+     * @brief Iterator over the bits of the array.
+     *
+     * @tparam Array Either fixed_array<bool> or const fixed_array<bool>.
+     * @tparam Ref Type returned upon dereferencing the iterator.
+     */
+    template <typename Array, typename Ref>
+    class basic_iterator {
+       public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef bool value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef Ref reference;
+
+        basic_iterator(Array* arr, size_t i) : arr(arr), i(i) {}
+
+        Ref operator*() const { return (*arr)[i]; }
+        basic_iterator& operator++() {
+            i++;
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            basic_iterator prev(*this);
+            i++;
+            return prev;
+        }
+        bool operator==(const basic_iterator& other) const { return i == other.i; }
+        bool operator!=(const basic_iterator& other) const { return i != other.i; }
+
+       private:
+        Array* arr;
+        size_t i;
+    };
+
+    typedef basic_iterator<fixed_array<bool>, reference> iterator;
+    typedef basic_iterator<const fixed_array<bool>, bool> const_iterator;
+
+    /**
+     * @brief Default constructor. Constructs an empty bit array.
+     */
+    fixed_array() : _size(0) { words.fill(0); }
+
+    /**
+     * @brief Construct a new bit array, with all bits set to zero.
+     *
+     * @param size (Unchanged) size of the array. Sizes past max_size are clamped to it.
+     */
+    explicit fixed_array(const size_t size) : fixed_array() { resize(size); }
+
+    /**
+     * @brief Copy constructor. Constructs the bit array to be of the same size as the argument.
+     */
+    fixed_array(const fixed_array<bool>& arr) : _size(arr._size), words(arr.words) {}
+
+    /**
+     * @brief Explicit copy constructor for an STL vector. Constructs the bit array to be of the
+     * same size as the argument.
+     */
+    fixed_array(const std::vector<bool>& arr) : fixed_array(arr.size()) { *this = arr; }
 
     /**
      * @brief Explicit copy constructor for a bitset. Constructs the fixed array to be of the same
@@ -143,10 +254,31 @@ class fixed_array<bool> : public fixed_array_base<bool> {
      * @param set
      */
     template <size_t sz>
-    explicit fixed_array(const std::bitset<sz>& set) : fixed_array_base<bool>(sz) {
+    explicit fixed_array(const std::bitset<sz>& set) : fixed_array(sz) {
+        static_assert(sz <= max_size, "Bitset is too large for a bit array.");
         *this = set;
     }
 
+    /**
+     * @brief Allows assignment-by-value using another bit array. If the arrays are not of the
+     * same length, nothing happens.
+     */
+    fixed_array& operator=(const fixed_array<bool>& arr) {
+        if (arr._size != _size) return *this;
+        words = arr.words;
+        return *this;
+    }
+
+    /**
+     * @brief Allows assignment-by-value using an STL vector. If the arrays are not of the
+     * same length, nothing happens.
+     */
+    fixed_array& operator=(const std::vector<bool>& arr) {
+        if (arr.size() != _size) return *this;
+        for (size_t i = 0; i < _size; i++) (*this)[i] = arr[i];
+        return *this;
+    }
+
     /**
      * @brief Allows assignment-by-value using a bitset. Does not copy the bitset if it is a
      * different size than the fixed array.
@@ -162,6 +294,48 @@ class fixed_array<bool> : public fixed_array_base<bool> {
         return *this;
     }
 
+    /**
+     * @brief Sets the size of the array. Bits that are added to the array are set to zero.
+     * This is only meant to be used while constructing the owner of the array.
+     *
+     * @param size New size of the array. Sizes past max_size are clamped to it.
+     * @return Whether the array could be given the requested size.
+     */
+    bool resize(const size_t size) {
+        const size_t new_size = size < max_size ? size : max_size;
+        for (size_t i = new_size; i < _size; i++) (*this)[i] = 0;
+        _size = new_size;
+        return new_size == size;
+    }
+
+    size_t size() const { return _size; }
+
+    /**
+     * @brief Two bit arrays are equal if they have the same size and the same bits. Bits
+     * past the end of an array are always zero, so whole words can be compared.
+     */
+    bool operator==(const fixed_array<bool>& other) const {
+        return _size == other._size && words == other.words;
+    }
+    bool operator!=(const fixed_array<bool>& other) const { return !(*this == other); }
+
+    reference operator[](const size_t i) { return reference(words[i / bits_per_word], i % bits_per_word); }
+    bool operator[](const size_t i) const { return (words[i / bits_per_word] >> (i % bits_per_word)) & 1; }
+
+    reference at(const size_t i) {
+        assert(i < _size);
+        return (*this)[i];
+    }
+    bool at(const size_t i) const {
+        assert(i < _size);
+        return (*this)[i];
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, _size); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, _size); }
+
     /**
      * @brief Sets fixed array to an integer value, if there is enough space in the bitset to
      * do so. If there is not, the old value is preserved.
@@ -170,26 +344,10 @@ class fixed_array<bool> : public fixed_array_base<bool> {
      * @return Whether or not it was possible to store the integer into this bitset.
      */
     bool set_int(unsigned int val) {
-        size_t val_num_bits = 32;
-        for (size_t i = 0; i < 32; i++) {
-            if (pow(2, i) > val) {
-                val_num_bits = i;
-                break;
-            }
-        }
-        if (val_num_bits > size()) return false;
-
-        for (size_t i = 0; i < size(); i++) {
-            (*this)[i] = 0;
-        }
-
-        int i = 0;
-        while (val > 0) {
-            (*this)[i] = val % 2;
-            val /= 2;
-            i++;
-        }
+        if (_size < bits_per_word && (static_cast<uint64_t>(val) >> _size) != 0) return false;
 
+        words.fill(0);
+        words[0] = val;
         return true;
     }
 
@@ -208,20 +366,71 @@ class fixed_array<bool> : public fixed_array_base<bool> {
     unsigned long to_ulong() const { return static_cast<unsigned long>(to_ullong()); }
 
     /**
-     * @brief Converts bitset to integer.
+     * @brief Converts bitset to integer. If the bitset is longer than 64 bits, only its
+     * first 64 bits are converted.
      *
-     * @return unsigned long
+     * @return unsigned long long
+     */
+    unsigned long long to_ullong() const { return words[0]; }
+
+    /**
+     * @brief Converts a slice of the bitset to an integer. Bit i of the result is
+     * element (start + i) of the bitset.
+     *
+     * @param start Index of the first element of the slice.
+     * @param len   Length of the slice. Must be at most 64.
+     * @return unsigned long long
      */
-    unsigned long long to_ullong() const {
-        unsigned long long val = 0;
+    unsigned long long to_ullong(size_t start, size_t len) const {
+        if (len == 0) return 0;
+        const size_t w = start / bits_per_word;
+        const size_t offset = start % bits_per_word;
 
-        unsigned long long exp = 1;
-        for (size_t i = 0; i < size(); i++) {
-            val += (*this)[i] * exp;
-            exp *= 2;
+        uint64_t val = words[w] >> offset;
+        if (offset + len > bits_per_word) val |= words[w + 1] << (bits_per_word - offset);
+        return val & low_mask(len);
+    }
+
+    /**
+     * @brief Sets a slice of the bitset from an integer. Element (start + i) of the
+     * bitset is set to bit i of the value. The slice must lie within the bitset.
+     *
+     * @param start Index of the first element of the slice.
+     * @param len   Length of the slice. Must be at most 64.
+     * @param val   Value to store. Bits at and above len are ignored.
+     */
+    void set_ullong(size_t start, size_t len, unsigned long long val) {
+        if (len == 0) return;
+        const size_t w = start / bits_per_word;
+        const size_t offset = start % bits_per_word;
+        const uint64_t mask = low_mask(len);
+        val &= mask;
+
+        words[w] = (words[w] & ~(mask << offset)) | (val << offset);
+        if (offset + len > bits_per_word) {
+            const size_t shift = bits_per_word - offset;
+            words[w + 1] = (words[w + 1] & ~(mask >> shift)) | (val >> shift);
         }
+    }
 
-        return val;
+    /**
+     * @brief Copies a slice of another bitset into this one, a word at a time. Element
+     * (start + i) of this bitset is set to element (src_start + i) of src. Both slices
+     * must lie within their bitsets.
+     *
+     * @param start     Index of the first element to set in this bitset.
+     * @param src       Bitset to copy from.
+     * @param src_start Index of the first element to copy from src.
+     * @param len       Length of the slice.
+     */
+    void set_bits(size_t start, const fixed_array<bool>& src, size_t src_start, size_t len) {
+        for (size_t i = 0; i < len; i += bits_per_word) {
+            const size_t n = len - i < bits_per_word ? len - i : bits_per_word;
+            set_ullong(start + i, n, src.to_ullong(src_start + i, n));
+        }
+    }
+    void set_bits(size_t start, const fixed_array<bool>& src) {
+        set_bits(start, src, 0, src.size());
     }
 
     // Modifies a bit in character 'n' at the position 'p' to the value 'b'
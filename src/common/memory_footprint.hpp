@@ -0,0 +1,67 @@
+#ifndef MEMORY_FOOTPRINT_HPP_
+#define MEMORY_FOOTPRINT_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Bytes of RAM used by a state field, event or control task, split by what
+ * they're used for.
+ *
+ * Bytes inside an object are counted with sizeof, and bytes on the heap are counted
+ * from the sizes of what was allocated, without the allocator's own overhead. The
+ * categories add up to the total, and heap says how much of the total is on the heap
+ * rather than inside the object.
+ */
+struct memory_footprint {
+    /** Values of state fields. */
+    size_t values = 0;
+    /** Serializers, including the bit arrays that hold serialized values. */
+    size_t serializers = 0;
+    /** Events, including the bit arrays that hold their data. */
+    size_t events = 0;
+    /** Flows and the downlink plan of the downlink producer. */
+    size_t flows = 0;
+    /** Names that are too long to be stored inside their string. */
+    size_t names = 0;
+    /** Everything else, such as the rest of a control task and pointers to vtables. */
+    size_t other = 0;
+
+    /** Bytes of the total that are on the heap. */
+    size_t heap = 0;
+
+    size_t total() const { return values + serializers + events + flows + names + other; }
+
+    memory_footprint& operator+=(const memory_footprint& rhs) {
+        values += rhs.values;
+        serializers += rhs.serializers;
+        events += rhs.events;
+        flows += rhs.flows;
+        names += rhs.names;
+        other += rhs.other;
+        heap += rhs.heap;
+        return *this;
+    }
+
+    /**
+     * @brief Heap bytes used by a string, which are zero if the string is short enough
+     * to be stored inside the string object.
+     */
+    static size_t heap_size(const std::string& s) {
+        const char* begin = reinterpret_cast<const char*>(&s);
+        if (s.data() >= begin && s.data() < begin + sizeof(s)) return 0;
+        return s.capacity() + 1;
+    }
+
+    /**
+     * @brief Heap bytes used by the elements of a vector, including unused capacity but
+     * not anything the elements themselves allocate.
+     */
+    template<typename T>
+    static size_t heap_size(const std::vector<T>& v) {
+        return v.capacity() * sizeof(T);
+    }
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef NAME_INDEX_HPP_
+#define NAME_INDEX_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Hash index over a list of named objects, such as one of the lists of fields in the
+ * state field registry. Looking up an object by name takes constant time on average, instead
+ * of a string comparison against every object in the list.
+ *
+ * The index does not own or copy the list. It stores positions in the list, so the list may
+ * only be appended to, and every object must be inserted into the index right after it is
+ * appended. Objects keep their position for as long as they are in the list, which is what
+ * makes positions usable as IDs.
+ *
+ * The table uses open addressing with linear probing, and is kept at most half full.
+ *
+ * @tparam T Type of object in the list. Must have a name() method that returns a string.
+ */
+template <typename T>
+class name_index {
+  public:
+    /**
+     * @brief Returned by find() if no object has the given name.
+     */
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Find the position of an object within the list.
+     *
+     * @param items List that is indexed.
+     * @param name  Name of the object.
+     * @return Position of the object, or npos if there is no object with that name.
+     */
+    size_t find(const std::vector<T*>& items, const std::string& name) const {
+        if (slots.empty()) return npos;
+
+        const size_t mask = slots.size() - 1;
+        for (size_t i = hash(name) & mask; slots[i] != empty_slot; i = (i + 1) & mask) {
+            const size_t pos = slots[i] - 1;
+            if (items[pos]->name() == name) return pos;
+        }
+        return npos;
+    }
+
+    /**
+     * @brief Add the last object in the list to the index.
+     *
+     * @param items List that is indexed.
+     */
+    void insert_last(const std::vector<T*>& items) {
+        assert(items.size() <= max_items);
+        if (2 * items.size() > slots.size()) rebuild(items);
+        else insert(items, items.size() - 1);
+    }
+
+    /**
+     * @brief Remove every object from the index.
+     */
+    void clear() { slots.clear(); }
+
+  private:
+    typedef unsigned short slot_t;
+    static constexpr slot_t empty_slot = 0;
+    static constexpr size_t max_items = 0xfffe;
+    static constexpr size_t min_slots = 16;
+
+    /**
+     * @brief Position of each object in the list, plus one, or empty_slot. The size
+     * of the table is always a power of two.
+     */
+    std::vector<slot_t> slots;
+
+    /**
+     * @brief 32-bit FNV-1a hash of a name.
+     */
+    static uint32_t hash(const std::string& name) {
+        uint32_t h = 2166136261u;
+        for (const char c : name) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    void insert(const std::vector<T*>& items, const size_t pos) {
+        const size_t mask = slots.size() - 1;
+        size_t i = hash(items[pos]->name()) & mask;
+        while (slots[i] != empty_slot) i = (i + 1) & mask;
+        slots[i] = static_cast<slot_t>(pos + 1);
+    }
+
+    /**
+     * @brief Double the size of the table and reinsert every object in the list.
+     */
+    void rebuild(const std::vector<T*>& items) {
+        size_t num_slots = slots.empty() ? min_slots : 2 * slots.size();
+        while (num_slots < 2 * items.size()) num_slots *= 2;
+        slots.assign(num_slots, static_cast<slot_t>(empty_slot));
+        for (size_t pos = 0; pos < items.size(); pos++) insert(items, pos);
+    }
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef SPSC_RING_HPP_
+#define SPSC_RING_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * @brief Lock-free ring buffer of bytes with a single producer thread and a single
+ * consumer thread.
+ *
+ * The storage is allocated with the ring, so neither side allocates memory. The producer
+ * can write straight into the free space of the ring, e.g. with a read() system call, by
+ * asking for the free region with write_region() and then publishing the bytes that it
+ * wrote with commit(). The consumer looks at the bytes in the ring with peek(), and
+ * removes them with discard() once it has handled them, so that a message that has only
+ * partly arrived can be left in the ring until the rest of it arrives.
+ *
+ * Each side only writes its own index and reads the other's, so the only synchronization
+ * needed is an acquire/release pair on each index.
+ *
+ * @tparam Capacity Size of the ring in bytes. Must be a power of two.
+ */
+template <size_t Capacity>
+class spsc_ring {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+        "Capacity of an spsc_ring must be a power of two.");
+
+  public:
+    spsc_ring() : head(0), tail(0) {}
+
+    /**
+     * @brief Maximum number of bytes in the ring.
+     */
+    static constexpr size_t capacity() { return Capacity; }
+
+    /**
+     * @brief Number of bytes that can be read. Consumer only.
+     */
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the largest contiguous free region of the ring. Producer only.
+     *
+     * @param region Set to the start of the region.
+     * @return Size of the region, which is zero if the ring is full.
+     */
+    size_t write_region(unsigned char*& region) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t free = Capacity - (h - tail.load(std::memory_order_acquire));
+        const size_t offset = h & (Capacity - 1);
+        region = &data[offset];
+        return std::min(free, Capacity - offset);
+    }
+
+    /**
+     * @brief Publish bytes that were written into the region returned by write_region().
+     * Producer only.
+     */
+    void commit(size_t n) {
+        head.store(head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy bytes into the ring. Producer only.
+     *
+     * @return Number of bytes copied, which is less than n if the ring is full.
+     */
+    size_t write(const void* src, size_t n) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(src);
+        size_t written = 0;
+        while (written < n) {
+            unsigned char* region;
+            const size_t len = std::min(write_region(region), n - written);
+            if (len == 0) break;
+            std::memcpy(region, bytes + written, len);
+            commit(len);
+            written += len;
+        }
+        return written;
+    }
+
+    /**
+     * @brief Copy bytes from the front of the ring without removing them. Consumer only.
+     *
+     * @return Number of bytes copied, which is less than n if the ring has fewer bytes.
+     */
+    size_t peek(void* dst, size_t n) const {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        n = std::min(n, head.load(std::memory_order_acquire) - t);
+        const size_t offset = t & (Capacity - 1);
+        const size_t first = std::min(n, Capacity - offset);
+        std::memcpy(dst, &data[offset], first);
+        std::memcpy(static_cast<unsigned char*>(dst) + first, &data[0], n - first);
+        return n;
+    }
+
+    /**
+     * @brief Remove bytes from the front of the ring. Consumer only.
+     */
+    void discard(size_t n) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        n = std::min(n, head.load(std::memory_order_acquire) - t);
+        tail.store(t + n, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy bytes from the front of the ring and remove them. Consumer only.
+     *
+     * @return Number of bytes read.
+     */
+    size_t read(void* dst, size_t n) {
+        n = peek(dst, n);
+        discard(n);
+        return n;
+    }
+
+  private:
+    /**
+     * @brief Total number of bytes that have been written and read. Only their difference
+     * matters, so they are allowed to wrap around. Each is on its own cache line so that
+     * the producer and consumer don't contend for one.
+     */
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+
+    std::array<unsigned char, Capacity> data;
+};
+
+#endif
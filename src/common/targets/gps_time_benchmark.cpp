@@ -0,0 +1,110 @@
+/**
+ * @brief Microbenchmark for the GPS time math done every control cycle.
+ *
+ * Times the work that PiksiControlTask does to turn the Piksi's time into the
+ * "piksi.time" field, and the conversion of that field into seconds since the PAN
+ * epoch that AttitudeEstimator does. The estimator's conversion is compared against
+ * the previous implementation, which went through gps_time_t's unsigned long
+ * conversions.
+ */
+
+#include <common/Serializer.hpp>
+#include <chrono>
+#include <cstdio>
+
+#ifndef UNIT_TEST
+
+static constexpr size_t num_iterations = 1000000;
+static constexpr size_t num_times = 64;
+
+/**
+ * @brief Prevents the compiler from optimizing away the work done by the benchmark.
+ */
+static volatile double sink = 0;
+
+template<typename F>
+static double time_per_call_ns(F fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_iterations; i++) fn(i);
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / num_iterations;
+}
+
+/**
+ * @brief GPS time in nanoseconds as it was computed before the conversions used 64-bit
+ * integers. The time of week is multiplied in unsigned int, as it was.
+ */
+static unsigned long legacy_ns(const gps_time_t& t) {
+    return t.wn * static_cast<unsigned long>(NANOSECONDS_IN_WEEK) + t.tow * 1000000 + t.ns;
+}
+
+/**
+ * @brief Seconds from the epoch to t, computed the way AttitudeEstimator did before it
+ * used gps_time_t::ns_since(): with operator-, which converts both times to unsigned
+ * long and the difference back to a GPS time, and a final conversion to unsigned long.
+ */
+static double legacy_seconds_since(const gps_time_t& t, const gps_time_t& epoch) {
+    const unsigned long week = static_cast<unsigned long>(NANOSECONDS_IN_WEEK);
+    const unsigned long epoch_ns = legacy_ns(epoch);
+    gps_time_t diff = t;
+    if (!(t.is_set && legacy_ns(t) < epoch_ns)) {
+        const unsigned long d = legacy_ns(t) - epoch_ns;
+        diff.is_set = true;
+        diff.wn = d / week;
+        diff.tow = (d - diff.wn * week) / 1000000;
+        diff.ns = (d - diff.wn * week) % 1000000;
+    }
+    return legacy_ns(diff) / 1.0e9;
+}
+
+int main() {
+    const gps_time_t pan_epoch(2045, 0, 0);
+
+    // Times like the ones the Piksi reports, a few weeks after the epoch. The
+    // nanoseconds may be negative.
+    std::array<msg_gps_time_t, num_times> piksi_times;
+    for (size_t i = 0; i < num_times; i++) {
+        piksi_times[i].wn = static_cast<u16>(2045 + i % 4);
+        piksi_times[i].tow = static_cast<u32>(100000 * i + 7);
+        piksi_times[i].ns = static_cast<s32>(i * 7919) - 250000;
+        piksi_times[i].flags = 0;
+    }
+
+    // PiksiControlTask: build the time from the Piksi's message, check it against the
+    // solution's time of week, and serialize it for telemetry.
+    Serializer<gps_time_t> time_sr;
+    const double piksi_ns = time_per_call_ns([&](size_t i) {
+        const msg_gps_time_t& msg = piksi_times[i % num_times];
+        const gps_time_t time(msg);
+        if (time.tow == msg.tow) time_sr.serialize(time);
+        sink += time_sr.get_bit_array()[1];
+    });
+
+    Serializer<gps_time_t> time_delta_sr(pan_epoch, 56);
+    const double piksi_delta_ns = time_per_call_ns([&](size_t i) {
+        const msg_gps_time_t& msg = piksi_times[i % num_times];
+        const gps_time_t time(msg);
+        if (time.tow == msg.tow) time_delta_sr.serialize(time);
+        sink += time_delta_sr.get_bit_array()[1];
+    });
+
+    // AttitudeEstimator: seconds since the PAN epoch.
+    std::array<gps_time_t, num_times> times;
+    for (size_t i = 0; i < num_times; i++) times[i] = gps_time_t(piksi_times[i]);
+
+    const double estimator_ns = time_per_call_ns([&](size_t i) {
+        sink += times[i % num_times].ns_since(pan_epoch) / 1.0e9;
+    });
+    const double legacy_estimator_ns = time_per_call_ns([&](size_t i) {
+        sink += legacy_seconds_since(times[i % num_times], pan_epoch);
+    });
+
+    printf("piksi time, %2zu bits:         %8.2f ns\n", time_sr.bitsize(), piksi_ns);
+    printf("piksi time, %2zu bits (delta): %8.2f ns\n", time_delta_sr.bitsize(), piksi_delta_ns);
+    printf("estimator time:              %8.2f ns\n", estimator_ns);
+    printf("estimator time (legacy):     %8.2f ns\n", legacy_estimator_ns);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @brief Microbenchmark for serializers.
+ *
+ * Reports the time taken by serialize() and deserialize() for each serializer type, using
+ * field sizes that are typical of the flight registry. Run it on two revisions to compare
+ * the cost of a change to the serializers or to bit_array.
+ */
+
+#include <common/Serializer.hpp>
+#include <chrono>
+#include <cstdio>
+
+#ifndef UNIT_TEST
+
+static constexpr size_t num_iterations = 1000000;
+
+/**
+ * @brief Prevents the compiler from optimizing away the work done by the benchmark.
+ */
+static volatile unsigned int sink = 0;
+
+template<typename F>
+static double time_per_call_ns(F fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_iterations; i++) fn(i);
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / num_iterations;
+}
+
+/**
+ * @brief Times serialization and deserialization of a set of values.
+ *
+ * @param name   Name of the serializer type, for printing.
+ * @param s      Serializer under test.
+ * @param values Values to serialize. The benchmark cycles through them.
+ */
+template<typename T, size_t N>
+static void benchmark(const char* name, Serializer<T>& s, const std::array<T, N>& values) {
+    const double serialize_ns = time_per_call_ns([&](size_t i) {
+        s.serialize(values[i % N]);
+        sink += s.get_bit_array()[0];
+    });
+
+    T dest;
+    const double deserialize_ns = time_per_call_ns([&](size_t i) {
+        s.deserialize(&dest);
+        sink += reinterpret_cast<const unsigned char*>(&dest)[0];
+    });
+
+    printf("%-14s %4zu bits  serialize: %8.2f ns  deserialize: %8.2f ns\n",
+        name, s.bitsize(), serialize_ns, deserialize_ns);
+}
+
+int main() {
+    Serializer<bool> bool_sr;
+    benchmark("bool", bool_sr, std::array<bool, 2>{{true, false}});
+
+    Serializer<unsigned char> uchar_sr(0, 200, 8);
+    benchmark("unsigned char", uchar_sr, std::array<unsigned char, 4>{{0, 15, 128, 200}});
+
+    Serializer<unsigned int> uint_sr;
+    benchmark("unsigned int", uint_sr, std::array<unsigned int, 4>{{0, 1000, 123456, 4000000000}});
+
+    Serializer<signed int> int_sr(-1000, 1000, 11);
+    benchmark("signed int", int_sr, std::array<signed int, 4>{{-1000, -5, 17, 999}});
+
+    Serializer<float> float_sr(-200, 200, 16);
+    benchmark("float", float_sr, std::array<float, 4>{{-200.0f, -3.5f, 0.25f, 150.0f}});
+
+    Serializer<double> double_sr(0, 10000, 32);
+    benchmark("double", double_sr, std::array<double, 4>{{0.0, 1.5, 500.25, 9999.0}});
+
+    Serializer<float, 16> fixed_float_sr(-200, 200);
+    benchmark("float, 16", fixed_float_sr, std::array<float, 4>{{-200.0f, -3.5f, 0.25f, 150.0f}});
+
+    Serializer<double, 32> fixed_double_sr(0, 10000);
+    benchmark("double, 32", fixed_double_sr, std::array<double, 4>{{0.0, 1.5, 500.25, 9999.0}});
+
+    Serializer<f_vector_t> f_vector_sr(0, 100, 100);
+    benchmark("f_vector_t", f_vector_sr, std::array<f_vector_t, 2>{{{{1, 2, 3}}, {{-50, 10, 0.5}}}});
+
+    Serializer<d_vector_t> d_vector_sr(0, 100000, 100);
+    benchmark("d_vector_t", d_vector_sr, std::array<d_vector_t, 2>{{{{1, 2, 3}}, {{-5e4, 1e3, 7}}}});
+
+    Serializer<f_quat_t> f_quat_sr;
+    benchmark("f_quat_t", f_quat_sr,
+        std::array<f_quat_t, 2>{{{{0.5f, 0.5f, 0.5f, 0.5f}}, {{1, 0, 0, 0}}}});
+
+    Serializer<d_quat_t> d_quat_sr;
+    benchmark("d_quat_t", d_quat_sr,
+        std::array<d_quat_t, 2>{{{{0.5, 0.5, 0.5, 0.5}}, {{0, 0, 0.6, 0.8}}}});
+
+    Serializer<gps_time_t> gps_time_sr;
+    benchmark("gps_time_t", gps_time_sr,
+        std::array<gps_time_t, 2>{{gps_time_t(2045, 100000, 500), gps_time_t(2100, 7, 999999)}});
+
+    Serializer<gps_time_t> gps_time_delta_sr(gps_time_t(2045, 0, 0), 56);
+    benchmark("gps_time_t, dt", gps_time_delta_sr,
+        std::array<gps_time_t, 2>{{gps_time_t(2045, 100000, 500), gps_time_t(2100, 7, 999999)}});
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * WARNING: THIS FILE IS AUTOGENERATED. ALL CHANGES WILL BE OVERWRITTEN.
+ */
+
+#ifndef FIELD_MANIFEST_HPP_
+#define FIELD_MANIFEST_HPP_
+
+#include <common/field_handle.hpp>
+#include <common/StateField.hpp>
+
+namespace PAN {
+namespace fields {
+constexpr field_handle<ReadableStateField<unsigned int>> pan_cycle_no = {0, "pan.cycle_no", 32};
+constexpr field_handle<InternalStateField<char*>> downlink_ptr = {1, "downlink.ptr", 0};
+constexpr field_handle<InternalStateField<size_t>> downlink_snap_size = {2, "downlink.snap_size", 0};
+constexpr field_handle<InternalStateField<bool>> downlink_taken = {3, "downlink.taken", 0};
+constexpr field_handle<InternalStateField<char*>> uplink_ptr = {4, "uplink.ptr", 0};
+constexpr field_handle<InternalStateField<size_t>> uplink_len = {5, "uplink.len", 0};
+constexpr field_handle<InternalStateField<unsigned char>> radio_state = {6, "radio.state", 0};
+constexpr field_handle<InternalStateField<unsigned int>> radio_last_comms_ccno = {7, "radio.last_comms_ccno", 0};
+
+constexpr size_t num_fields = 8;
+
+constexpr field_info table[num_fields] = {
+    {"pan.cycle_no", field_kind::readable, "unsigned int", 0, 4294967295, 32},
+    {"downlink.ptr", field_kind::internal, "char*", 0, 0, 0},
+    {"downlink.snap_size", field_kind::internal, "size_t", 0, 0, 0},
+    {"downlink.taken", field_kind::internal, "bool", 0, 0, 0},
+    {"uplink.ptr", field_kind::internal, "char*", 0, 0, 0},
+    {"uplink.len", field_kind::internal, "size_t", 0, 0, 0},
+    {"radio.state", field_kind::internal, "unsigned char", 0, 0, 0},
+    {"radio.last_comms_ccno", field_kind::internal, "unsigned int", 0, 0, 0}
+};
+}
+}
+
+#endif
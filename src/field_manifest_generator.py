@@ -0,0 +1,79 @@
+import os, csv
+
+preamble = \
+"""
+/**
+ * WARNING: THIS FILE IS AUTOGENERATED. ALL CHANGES WILL BE OVERWRITTEN.
+ */
+
+#ifndef FIELD_MANIFEST_HPP_
+#define FIELD_MANIFEST_HPP_
+
+#include <common/field_handle.hpp>
+#include <common/StateField.hpp>
+
+namespace PAN {
+namespace fields {
+"""
+preamble = preamble[1:]
+
+field_types = {
+    "internal" : "InternalStateField",
+    "readable" : "ReadableStateField",
+    "writable" : "WritableStateField",
+}
+
+class FieldManifestParser(object):
+    def __init__(self, inputFile):
+        with open(inputFile, "r") as csvfile:
+            self.data_list = list(csv.reader(csvfile, delimiter = ','))
+
+    def parse(self):
+        fields = []
+        for row_data in self.data_list:
+            if len(row_data) < 6 or row_data[1] not in field_types:
+                # This is the header or an annotation/comment row, ignore it.
+                continue
+
+            name, kind, cpp_type = row_data[0], row_data[1], row_data[2]
+            if kind == "internal":
+                bounds = ["0", "0", "0"]
+            else:
+                bounds = row_data[3:6]
+            fields.append((name, kind, cpp_type, bounds))
+
+        return fields
+
+def handle_definitions(fields):
+    lines = []
+    for id, (name, kind, cpp_type, bounds) in enumerate(fields):
+        lines.append("constexpr field_handle<{}<{}>> {} = {{{}, \"{}\", {}}};".format(
+            field_types[kind], cpp_type, name.replace(".", "_"), id, name, bounds[2]))
+    return "\n".join(lines)
+
+def table_definition(fields):
+    lines = []
+    for name, kind, cpp_type, bounds in fields:
+        lines.append("    {{\"{}\", field_kind::{}, \"{}\", {}, {}, {}}}".format(
+            name, kind, cpp_type, bounds[0], bounds[1], bounds[2]))
+    return "constexpr size_t num_fields = {};\n\nconstexpr field_info table[num_fields] = {{\n{}\n}};" \
+        .format(len(fields), ",\n".join(lines))
+
+end = \
+"""
+}
+}
+
+#endif
+"""
+
+if __name__ == "__main__":
+    with open("src/field_manifest.hpp", "w") as output_f:
+        output_f.write(preamble)
+
+        fields = FieldManifestParser("src/field_manifest.csv").parse()
+        output_f.write(handle_definitions(fields))
+        output_f.write("\n\n")
+        output_f.write(table_definition(fields))
+
+        output_f.write(end)
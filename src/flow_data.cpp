@@ -1,6 +1,10 @@
+/**
+ * WARNING: THIS FILE IS AUTOGENERATED. ALL CHANGES WILL BE OVERWRITTEN.
+ */
+
 #include "flow_data.hpp"
 
 const std::vector<DownlinkProducer::FlowData> PAN::flow_data = {
-{1, "true", {"pan.state", "pan.sat_designation"}},
-{2, "true", {"docksys.docked", "docksys.dock_config", "docksys.is_turning"}}
+{1, true, {"pan.state", "pan.deployed", "pan.sat_designation"}, 0},
+{2, true, {"docksys.docked", "docksys.dock_config", "docksys.is_turning"}, 0}
 };
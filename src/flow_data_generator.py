@@ -24,8 +24,13 @@ class FlowListParser(object):
                 # This is just an annotation/comment row, ignore it.
                 continue
 
-            reformatted_row_data = [len(data) + 1, row_data[1], row_data[2:]] # Flow ID, flow active/inactive, flow fields
-            parsed_row = str(reformatted_row_data).replace("[", "{").replace("]", "}").replace("'", "\"")
+            flow_id = len(data) + 1
+            is_active = row_data[1]
+            # A blank keyframe period means the flow isn't a delta flow.
+            keyframe_period = int(row_data[2]) if row_data[2].strip() else 0
+            fields = ", ".join("\"{}\"".format(f) for f in row_data[3:] if f.strip())
+
+            parsed_row = "{{{}, {}, {{{}}}, {}}}".format(flow_id, is_active, fields, keyframe_period)
             data.append(parsed_row)
 
         return ",\n".join(data)
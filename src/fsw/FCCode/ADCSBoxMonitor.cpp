@@ -205,4 +205,10 @@ void ADCSBoxMonitor::execute(){
         gyr_vec_flag.set(true);
     if(exceed_bounds(gyr_temp, adcs::imu::min_rd_temp, adcs::imu::max_rd_temp - 1))
         gyr_temp_flag.set(true);
-}
\ No newline at end of file
+}
+
+memory_footprint ADCSBoxMonitor::heap_memory_use() const {
+    memory_footprint fp = memory_use_of_fields(ssa_voltages_f);
+    fp += memory_use_of_fields(havt_read_vector);
+    return fp;
+}
@@ -30,6 +30,11 @@ public:
     */
     void execute() override;
 
+    /**
+     * @brief Memory used by the sun sensor and HAVT fields, which are kept in vectors.
+     */
+    memory_footprint heap_memory_use() const override;
+
 protected:
     /**
     * @brief Inputs to get from ADCS box.
@@ -173,3 +173,9 @@ void ADCSCommander::dispatch_docking(){
     rwa_mode_f.set(adcs::RWAMode::RWA_ACCEL_CTRL);
     mtr_mode_f.set(adcs::MTRMode::MTR_ENABLED);
 }
+
+memory_footprint ADCSCommander::heap_memory_use() const {
+    memory_footprint fp = memory_use_of_fields(havt_cmd_reset_vector_f);
+    fp += memory_use_of_fields(havt_cmd_disable_vector_f);
+    return fp;
+}
@@ -22,6 +22,11 @@ class ADCSCommander : public TimedControlTask<void> {
      */
     void execute() override;
 
+    /**
+     * @brief Memory used by the HAVT command fields, which are kept in vectors.
+     */
+    memory_footprint heap_memory_use() const override;
+
    protected:
     // input fields, given by a casted adcs_state_t enum
     const WritableStateField<unsigned char>* adcs_state_fp;
@@ -1,17 +1,32 @@
 #include "ClockManager.hpp"
 #include <common/Event.hpp>
+#include <field_manifest.hpp>
 
 ClockManager::ClockManager(StateFieldRegistry &registry,
                            const unsigned int _control_cycle_size) :
     TimedControlTask<void>(registry, "clock_ct", 0),
     control_cycle_size(_control_cycle_size),
-    control_cycle_count_f("pan.cycle_no", Serializer<unsigned int>())
+    control_cycle_count_f("pan.cycle_no", Serializer<unsigned int>()),
+    trace_dump_f("timing.trace.dump", Serializer<bool>())
 {
-    add_readable_field(control_cycle_count_f);
+    add_readable_field(control_cycle_count_f, PAN::fields::pan_cycle_no);
+    // Registered on every platform, so that the writable field indices used by the
+    // ground's uplink producer match flight's.
+    add_writable_field(trace_dump_f);
+    trace_dump_f.set(false);
     Event::ccno = &control_cycle_count_f;
 }
 
 void ClockManager::execute() {
+    if (trace_dump_f.get()) {
+        #ifdef DESKTOP
+        if (!CycleTrace::dump())
+            printf(debug_severity::error, "Couldn't write cycle trace to %s",
+                CycleTrace::dump_path.c_str());
+        #endif
+        trace_dump_f.set(false);
+    }
+
     if (has_executed) {
         sys_time_t earliest_start_time =
             TimedControlTaskBase::control_cycle_start_time + control_cycle_size;
@@ -22,4 +37,6 @@ void ClockManager::execute() {
     TimedControlTaskBase::control_cycle_start_time = get_system_time();
     control_cycle_count++;
     control_cycle_count_f.set(control_cycle_count);
+    CycleTrace::record(control_cycle_count, CycleTrace::cycle_start,
+        trace_time(TimedControlTaskBase::control_cycle_start_time));
 }
@@ -24,6 +24,9 @@ class ClockManager : public TimedControlTask<void> {
      * of this function. Since this task is the first to run in any control
      * cycle, it therefore ensures that the control cycle stays within its
      * bounded values.
+     * 
+     * On desktop, also writes the cycle trace to a file if that was requested
+     * by setting timing.trace.dump. See CycleTrace.
      */
     void execute() override;
 
@@ -43,6 +46,13 @@ class ClockManager : public TimedControlTask<void> {
      * @brief Keeps track of the current control cycle count.
      */
     ReadableStateField<unsigned int> control_cycle_count_f;
+
+    /**
+     * @brief Set to write the cycle trace to CycleTrace::dump_path at the start of
+     * the next control cycle. Cleared once the trace is written. The field exists on
+     * every platform, but the trace is only written on desktop.
+     */
+    WritableStateField<bool> trace_dump_f;
 };
 
 #endif
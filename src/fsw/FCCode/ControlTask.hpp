@@ -38,6 +38,13 @@ class ControlTask : protected debug_console {
      */
     virtual T execute() = 0;
 
+    /**
+     * @brief Memory that the task owns on the heap, such as buffers and state fields
+     * that are kept in vectors. The memory inside the task object is found by
+     * MemoryReport, so it's left out.
+     */
+    virtual memory_footprint heap_memory_use() const { return memory_footprint(); }
+
     /**
      * @brief Destroy the Control Task object
      * 
@@ -48,6 +55,19 @@ class ControlTask : protected debug_console {
   protected:
     StateFieldRegistry& _registry;
 
+    /**
+     * @brief Memory used by state fields that are kept in a vector, all of which is on
+     * the heap.
+     */
+    template<typename FieldType>
+    static memory_footprint memory_use_of_fields(const std::vector<FieldType>& fields) {
+        memory_footprint fp;
+        for (const FieldType& field : fields) fp += field.memory_use();
+        fp.other += (fields.capacity() - fields.size()) * sizeof(FieldType);
+        fp.heap = fp.total();
+        return fp;
+    }
+
   private:
     void check_field_added(const bool added, const std::string& field_name) {
         if(!added) {
@@ -96,6 +116,39 @@ class ControlTask : protected debug_console {
         check_field_added(added, field.name());
     }
 
+    /**
+     * @brief Add a field to the registry and bind it to its handle from the field
+     * manifest. The field's type must match the type in the manifest, or this does not
+     * compile.
+     *
+     * @{
+     */
+    template<typename U>
+    void add_internal_field(InternalStateField<U>& field,
+                            const field_handle<InternalStateField<U>>& handle) {
+        add_internal_field(field);
+        bind_field(field, handle);
+    }
+
+    template<typename U>
+    void add_readable_field(ReadableStateField<U>& field,
+                            const field_handle<ReadableStateField<U>>& handle) {
+        add_readable_field(field);
+        assert(field.bitsize() == handle.bitsize);
+        bind_field(field, handle);
+    }
+
+    template<typename U>
+    void add_writable_field(WritableStateField<U>& field,
+                            const field_handle<WritableStateField<U>>& handle) {
+        add_writable_field(field);
+        assert(field.bitsize() == handle.bitsize);
+        bind_field(field, handle);
+    }
+    /**
+     * @}
+     */
+
     void add_event(Event& event) {
         const bool added = _registry.add_event(&event);
         check_field_added(added, event.name());
@@ -107,6 +160,11 @@ class ControlTask : protected debug_console {
     }
 
   private:
+    template<typename FieldType>
+    void bind_field(FieldType& field, const field_handle<FieldType>& handle) {
+        assert(field.name() == handle.name);
+        _registry.bind_field(handle, &field);
+    }
 
     void check_field_exists(const StateFieldBase* ptr, const std::string& field_type,
             const char* field_name) {
@@ -179,6 +237,39 @@ class ControlTask : protected debug_console {
         return DYNAMIC_CAST(WritableStateField<U>*, field_ptr);
     }
 
+    /**
+     * @brief Find a field by its handle from the field manifest.
+     *
+     * If the field was bound to its handle when it was added, this takes constant time
+     * and does not compare names. Otherwise, for instance if the field was created by
+     * a test's mock registry, this falls back to finding the field by name.
+     *
+     * @{
+     */
+    template<typename U>
+    InternalStateField<U>* find_field(const field_handle<InternalStateField<U>>& handle) {
+        InternalStateField<U>* field_ptr = _registry.get_field(handle);
+        if (field_ptr) return field_ptr;
+        return find_internal_field<U>(handle.name, __FILE__, __LINE__);
+    }
+
+    template<typename U>
+    ReadableStateField<U>* find_field(const field_handle<ReadableStateField<U>>& handle) {
+        ReadableStateField<U>* field_ptr = _registry.get_field(handle);
+        if (field_ptr) return field_ptr;
+        return find_readable_field<U>(handle.name, __FILE__, __LINE__);
+    }
+
+    template<typename U>
+    WritableStateField<U>* find_field(const field_handle<WritableStateField<U>>& handle) {
+        WritableStateField<U>* field_ptr = _registry.get_field(handle);
+        if (field_ptr) return field_ptr;
+        return find_writable_field<U>(handle.name, __FILE__, __LINE__);
+    }
+    /**
+     * @}
+     */
+
     Event* find_event(const char* event, const char* file, const unsigned int line) {
         Event* event_ptr = _registry.find_event(event);
         check_field_exists(event_ptr, "event", event);
@@ -0,0 +1,63 @@
+#include "CycleTrace.hpp"
+
+#ifdef DESKTOP
+#include <fstream>
+#endif
+
+constexpr unsigned int CycleTrace::version;
+constexpr size_t CycleTrace::capacity;
+constexpr size_t CycleTrace::max_tasks;
+
+std::array<CycleTrace::Event, CycleTrace::capacity> CycleTrace::events;
+unsigned int CycleTrace::num_events = 0;
+std::array<std::string, CycleTrace::max_tasks> CycleTrace::task_names;
+unsigned short CycleTrace::num_tasks = 0;
+
+unsigned short CycleTrace::add_task(const std::string& name) {
+    if (num_tasks == max_tasks) return max_tasks - 1;
+    task_names[num_tasks] = name;
+    return num_tasks++;
+}
+
+memory_footprint CycleTrace::memory_use() {
+    memory_footprint fp;
+    fp.other = sizeof(events) + sizeof(task_names);
+    for (const std::string& name : task_names) {
+        const size_t heap = memory_footprint::heap_size(name);
+        fp.names += heap;
+        fp.heap += heap;
+    }
+    return fp;
+}
+
+#ifdef DESKTOP
+std::string CycleTrace::dump_path = "cycle_trace.bin";
+
+static void write_uint(std::ofstream& out, unsigned int val, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) out.put(static_cast<char>((val >> (8 * i)) & 0xff));
+}
+
+bool CycleTrace::dump() {
+    std::ofstream out(dump_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write("PTRC", 4);
+    write_uint(out, version, 4);
+    write_uint(out, num_tasks, 4);
+    for (unsigned short i = 0; i < num_tasks; i++) {
+        write_uint(out, task_names[i].size(), 2);
+        out.write(task_names[i].data(), task_names[i].size());
+    }
+
+    const unsigned int first = num_events > capacity ? num_events - capacity : 0;
+    write_uint(out, num_events - first, 4);
+    for (unsigned int i = first; i != num_events; i++) {
+        const Event& event = get(i);
+        write_uint(out, event.time_us, 4);
+        write_uint(out, event.task, 2);
+        write_uint(out, event.kind, 1);
+        write_uint(out, 0, 1);
+    }
+    return static_cast<bool>(out);
+}
+#endif
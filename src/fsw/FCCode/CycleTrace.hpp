@@ -0,0 +1,137 @@
+#ifndef CYCLE_TRACE_HPP_
+#define CYCLE_TRACE_HPP_
+
+#include <common/memory_footprint.hpp>
+#include <array>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Records when each timed control task starts and ends, so that overruns of the
+ * control cycle can be diagnosed after the fact.
+ *
+ * Events go into a preallocated ring that holds the last few dozen control cycles on
+ * desktop, where it can be dumped, and the last several on the flight computer, where RAM
+ * is scarce. Recording an event is a single store into the ring, using timestamps that the caller
+ * has already taken, so tracing can stay on all the time.
+ *
+ * On desktop, the ring can be written to a file with dump(), which happens when the
+ * "timing.trace.dump" field is set, e.g. through the debug console. The file is read by
+ * tools/cycle_trace_to_chrome.py, which converts it to a Chrome trace that can be viewed
+ * in chrome://tracing or Perfetto. The file format is, in little-endian order:
+ *
+ * - The characters "PTRC" and the format version, as a 32-bit integer.
+ * - The number of tasks, as a 32-bit integer, and then each task's name as a 16-bit
+ *   length followed by that many characters. A task's ID is its index in this list.
+ * - The number of events, as a 32-bit integer, and then each Event, oldest first.
+ */
+class CycleTrace {
+  public:
+    static constexpr unsigned int version = 1;
+
+    /**
+     * @brief Number of events that the ring holds. Must be a power of two. A control
+     * cycle records about 30 events.
+     */
+#ifdef DESKTOP
+    static constexpr size_t capacity = 2048;
+#else
+    static constexpr size_t capacity = 256;
+#endif
+
+    /**
+     * @brief Maximum number of tasks that can be traced, which is twice as many as the
+     * main control loop has. Tasks added after this many share the last ID.
+     */
+    static constexpr size_t max_tasks = 32;
+
+    enum kind_t : unsigned char {
+        task_start = 0,
+        task_end = 1,
+        /** The start of a control cycle. The event's task is the low 16 bits of the
+         *  control cycle count. */
+        cycle_start = 2
+    };
+
+    /**
+     * @brief An event, as it is stored in the ring and in a dump.
+     */
+    struct Event {
+        /** System time of the event in microseconds, which wraps around. */
+        unsigned int time_us;
+        unsigned short task;
+        kind_t kind;
+        unsigned char reserved;
+    };
+    static_assert(sizeof(Event) == 8, "Trace events must be packed into 8 bytes.");
+
+    /**
+     * @brief Add a task to the trace.
+     *
+     * @param name Name of the task.
+     * @return ID of the task in trace events.
+     */
+    static unsigned short add_task(const std::string& name);
+
+    /**
+     * @brief Record an event.
+     *
+     * @param task ID of the task, or the control cycle count for cycle_start.
+     * @param kind What happened.
+     * @param time_us System time of the event in microseconds.
+     */
+    static void record(unsigned int task, kind_t kind, unsigned int time_us) {
+        Event& event = events[num_events++ & (capacity - 1)];
+        event.time_us = time_us;
+        event.task = static_cast<unsigned short>(task);
+        event.kind = kind;
+    }
+
+    /**
+     * @brief Number of events that have been recorded, including ones that have been
+     * overwritten.
+     */
+    static unsigned int size() { return num_events; }
+
+    /**
+     * @brief Get an event from the ring.
+     *
+     * @param i Index of the event, which must be one of the last capacity events
+     * recorded, i.e. at least size() - capacity and less than size().
+     */
+    static const Event& get(unsigned int i) { return events[i & (capacity - 1)]; }
+
+    /**
+     * @brief Name of a task in the trace.
+     */
+    static const std::string& task_name(unsigned short task) { return task_names[task]; }
+
+    /**
+     * @brief Memory used by the ring and the task names, for the memory report.
+     */
+    static memory_footprint memory_use();
+
+#ifdef DESKTOP
+    /**
+     * @brief File that dump() writes to.
+     */
+    static std::string dump_path;
+
+    /**
+     * @brief Write the tasks and the events in the ring to dump_path.
+     *
+     * @return True if the file was written.
+     */
+    static bool dump();
+#endif
+
+  private:
+    static std::array<Event, capacity> events;
+    static unsigned int num_events;
+    static std::array<std::string, max_tasks> task_names;
+    static unsigned short num_tasks;
+
+    static_assert((capacity & (capacity - 1)) == 0, "Trace capacity must be a power of two.");
+};
+
+#endif
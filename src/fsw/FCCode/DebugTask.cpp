@@ -17,8 +17,13 @@ DebugTask::DebugTask(StateFieldRegistry &registry, unsigned int offset)
 void DebugTask::execute() {
 #ifdef FUNCTIONAL_TEST
   start_cycle_f.set(false);
-  while (!start_cycle_f.get())
+  while (!start_cycle_f.get()) {
     process_commands(_registry);
+#ifdef DESKTOP
+    // Sleep until the simulation sends more commands, instead of spinning
+    if (!start_cycle_f.get()) wait_for_input();
+#endif
+  }
 #endif
 }
 
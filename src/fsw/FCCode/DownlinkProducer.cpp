@@ -1,4 +1,5 @@
 #include "DownlinkProducer.hpp"
+#include <field_manifest.hpp>
 #include <algorithm>
 #include <set>
 
@@ -6,15 +7,19 @@ DownlinkProducer::DownlinkProducer(StateFieldRegistry& r,
     const unsigned int offset) : TimedControlTask<void>(r, "downlink_ct", offset),
                                  snapshot_ptr_f("downlink.ptr"),
                                  snapshot_size_bytes_f("downlink.snap_size"),
+                                 snapshot_taken_f("downlink.taken"),
+                                 frame_budget_f("downlink.budget", Serializer<unsigned char>(0,15,4)),
                                  shift_flows_id1_f("downlink.shift_id1", Serializer<unsigned char>(0,10,1)),
                                  shift_flows_id2_f("downlink.shift_id2", Serializer<unsigned char>(0,10,1)),
                                  toggle_flow_id_f("downlink.toggle_id", Serializer<unsigned char>(0,10,1))
 {
-    cycle_count_fp = find_readable_field<unsigned int>("pan.cycle_no", __FILE__, __LINE__);
+    cycle_count_fp = find_field(PAN::fields::pan_cycle_no);
 
     // Add snapshot fields to the registry
-    add_internal_field(snapshot_ptr_f);
-    add_internal_field(snapshot_size_bytes_f);
+    add_internal_field(snapshot_ptr_f, PAN::fields::downlink_ptr);
+    add_internal_field(snapshot_size_bytes_f, PAN::fields::downlink_snap_size);
+    add_internal_field(snapshot_taken_f, PAN::fields::downlink_taken);
+    snapshot_taken_f.set(false);
 
     // Add shift_flows statefield to registry and set it to default values
     add_writable_field(shift_flows_id1_f);
@@ -25,6 +30,10 @@ DownlinkProducer::DownlinkProducer(StateFieldRegistry& r,
     // Add toggle command statefield to registry and set it to default of 0
     add_writable_field(toggle_flow_id_f);
     toggle_flow_id_f.set(0);
+
+    // Add frame budget statefield to registry and set it to default of 0 (no limit)
+    add_writable_field(frame_budget_f);
+    frame_budget_f.set(0);
 }
 
 void DownlinkProducer::init_flows(const std::vector<FlowData>& flow_data) {
@@ -49,13 +58,89 @@ void DownlinkProducer::init_flows(const std::vector<FlowData>& flow_data) {
     snapshot = new char[max_downlink_size];
     snapshot_ptr_f.set(snapshot);
     snapshot_size_bytes_f.set(max_downlink_size);
+
+    build_plan();
+}
+
+void DownlinkProducer::build_plan() {
+    schedule_flows();
+
+    plan.clear();
+    size_t offset = 0;
+    auto add_entry = [&](PlanEntry::Type type, const bit_array* flow_id_bits,
+                         ReadableStateFieldBase* field, Flow* flow, size_t length) {
+        plan.push_back({type, flow_id_bits, field, flow, offset, length});
+        offset += length;
+    };
+
+    // Control cycle count goes at the start of the initial packet
+    add_entry(PlanEntry::Type::field, nullptr, cycle_count_fp, nullptr,
+        cycle_count_fp->bitsize());
+
+    for(Flow& flow : flows) {
+        if (!flow.is_scheduled) continue;
+
+        add_entry(PlanEntry::Type::flow_id, &flow.id_sr.get_bit_array(), nullptr, nullptr,
+            flow.id_sr.bitsize());
+        if (flow.keyframe_period > 0)
+            add_entry(PlanEntry::Type::delta_header, nullptr, nullptr, &flow,
+                1 + delta_sequence_bits);
+
+        for(ReadableStateFieldBase* field : flow.field_list) {
+            const PlanEntry::Type type = _registry.find_event(field->name()) ?
+                PlanEntry::Type::event : PlanEntry::Type::field;
+            add_entry(type, nullptr, field, nullptr, field->bitsize());
+        }
+    }
+}
+
+void DownlinkProducer::schedule_flows() {
+    scheduled_budget = frame_budget_f.get();
+
+    // Rank the active flows by urgency. Flows are listed in priority order, and the
+    // sort is stable, so ties keep priority order.
+    struct Candidate {
+        Flow* flow;
+        bool is_overdue;
+        size_t score;
+    };
+    std::vector<Candidate> candidates;
+    for (Flow& flow : flows) {
+        flow.is_scheduled = false;
+        if (flow.is_active) candidates.push_back({&flow,
+            flow.max_staleness > 0 && flow.staleness >= flow.max_staleness, 0});
+    }
+
+    if (scheduled_budget == 0) {
+        for (Candidate& c : candidates) c.flow->is_scheduled = true;
+        return;
+    }
+
+    for (size_t i = 0; i < candidates.size(); i++)
+        candidates[i].score = (candidates.size() - i) * (candidates[i].flow->staleness + 1);
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) {
+            if (a.is_overdue != b.is_overdue) return a.is_overdue;
+            return !a.is_overdue && a.score > b.score;
+        });
+
+    // Each MO message starts with a header bit, and the first one also contains the
+    // control cycle count. Flows are constructed to fit in one message, so the most
+    // urgent flow always fits.
+    size_t space = scheduled_budget * (num_bits_in_packet - 1) - cycle_count_fp->bitsize();
+    for (Candidate& c : candidates) {
+        const size_t size = c.flow->get_packet_size();
+        if (size > space) continue;
+        c.flow->is_scheduled = true;
+        space -= size;
+    }
 }
 
 size_t DownlinkProducer::compute_downlink_size(const bool compute_max) const {
     size_t downlink_max_size_bits = 0;
 
     for (const Flow& flow : flows) {
-        if (flow.is_active || compute_max)
+        if (flow.is_scheduled || compute_max)
             downlink_max_size_bits += flow.get_packet_size();
     }
 
@@ -75,100 +160,50 @@ size_t DownlinkProducer::compute_max_downlink_size() const {
     return compute_downlink_size(true);
 }
 
-static void add_bits_to_downlink_frame(const bit_array& field_bits,
-                                       char* snapshot_ptr,
-                                       size_t& packet_offset,
-                                       size_t& downlink_frame_offset)
-{
-    const size_t field_size = field_bits.size();
-    const int field_overflow = (field_size + packet_offset)
-        - DownlinkProducer::num_bits_in_packet; // Number of bits in field that run past the packet end
-
-    if(field_overflow <= 0) {
-        // Contiguously write field to snapshot buffer
-        field_bits.to_string(snapshot_ptr, downlink_frame_offset);
-        downlink_frame_offset += field_size;
-        packet_offset += field_size;
-    }
-    else {
-        // Split field across two packets
-        const int x = field_size - field_overflow; // # of bits in field that don't overrun a packet
-
-        // Copy first part of field
-        field_bits.to_string(snapshot_ptr, downlink_frame_offset, 0, x);
-        downlink_frame_offset += x;
-        packet_offset = 0;
-
-        // Mark the header for a new packet
-        char& packet_start = snapshot_ptr[(downlink_frame_offset / 70)];
-        packet_start = bit_array::modify_bit(packet_start, 7, 0);
-        downlink_frame_offset += 1;
-        packet_offset += 1;
-
-        // Copy the rest of the field
-        field_bits.to_string(snapshot_ptr, downlink_frame_offset, x, field_size);
-        downlink_frame_offset += field_overflow;
-        packet_offset += field_overflow;
-    }
-}
-
 void DownlinkProducer::execute() {
-    // Set the snapshot size in order to let the Quake Manager know about
-    // the size of the current downlink.
-    snapshot_size_bytes_f.set(compute_downlink_size());
-
-    char* snapshot_ptr = snapshot_ptr_f.get();
-    // Create the required iterators
-    size_t downlink_frame_offset = 0; // Bit offset from the beginning
-                                      // of the snapshot buffer
-    size_t packet_offset = 0;         // Bit offset from the beginning
-                                      // of the current downlink packet
-
-    // Add initial packet header
-    snapshot_ptr[0] = bit_array::modify_bit(snapshot_ptr[0], 7, 1);
-    downlink_frame_offset += 1;
-    packet_offset += 1;
-
-    // Add control cycle count to the initial packet
-    cycle_count_fp->serialize();
-    const bit_array& cycle_count_bits = cycle_count_fp->get_bit_array();
-    add_bits_to_downlink_frame(cycle_count_bits, snapshot_ptr, packet_offset,
-            downlink_frame_offset);
-
-    for(auto const& flow : flows) {
-        if (!flow.is_active) continue;
-
-        // Add a flow field one at a time to the snapshot, taking
-        // care to add a downlink packet delimeter if the current
-        // packet size exceeds 70 bytes.
-        const bit_array& flow_id_bits = flow.id_sr.get_bit_array();
-        add_bits_to_downlink_frame(flow_id_bits, snapshot_ptr, packet_offset,
-            downlink_frame_offset);
-
-        for(auto& field : flow.field_list) {
-            Event* event = _registry.find_event(field->name());
-            if (event) {
-                // Event should be serialized when it is signaled
-                const bit_array& event_bits = event->get_bit_array();
-                add_bits_to_downlink_frame(event_bits, snapshot_ptr, packet_offset,
-                    downlink_frame_offset);
-            }
-            else{
-                field->serialize();
-                const bit_array& field_bits = field->get_bit_array();
-                add_bits_to_downlink_frame(field_bits, snapshot_ptr, packet_offset,
-                    downlink_frame_offset);
-            }
+    // If the Quake Manager took the previous snapshot for transmission, the ground
+    // now has the values of the delta flows that were in it. Pending values of any
+    // other snapshot are never transmitted.
+    const bool snapshot_taken = snapshot_taken_f.get();
+    for (Flow& flow : flows) {
+        if (snapshot_taken && flow.has_pending) flow.commit_pending();
+        flow.has_pending = false;
+        if (snapshot_taken && flow.is_active)
+            flow.staleness = flow.is_scheduled ? 0 : flow.staleness + 1;
+    }
+    snapshot_taken_f.set(false);
+
+    // With a frame budget, pick the flows for the next snapshot once the previous
+    // one is taken, so that flows that were left out rotate in.
+    if (frame_budget_f.get() != scheduled_budget || (snapshot_taken && scheduled_budget > 0))
+        build_plan();
+
+    // Downlink packets are num_bits_in_packet long, and each one starts with a
+    // header bit: 1 for the first packet in the frame and 0 for the rest. The
+    // writer inserts these headers and splits fields across packets as needed.
+    bit_writer frame(snapshot_ptr_f.get(), num_bits_in_packet);
+
+    for(size_t i = 0; i < plan.size(); i++) {
+        const PlanEntry& entry = plan[i];
+        if (entry.type == PlanEntry::Type::flow_id) {
+            frame.write(*entry.flow_id_bits);
+        }
+        else if (entry.type == PlanEntry::Type::delta_header) {
+            i += write_delta_flow(frame, i);
+        }
+        else {
+            // Events are serialized when they are signaled, so only
+            // plain fields need to be serialized here.
+            if (entry.type == PlanEntry::Type::field) entry.field->serialize();
+            frame.write(entry.field->get_bit_array());
         }
     }
 
     // If there are bits remaining in the last character of the downlink frame,
-    // fill them with zeroes.
-    const unsigned int num_remaining_bits = 8 - (downlink_frame_offset % 8); 
-    for(int i = num_remaining_bits - 1; i >= 0; i--) {
-        char& last_char = snapshot_ptr[(downlink_frame_offset / 8)];
-        last_char = bit_array::modify_bit(last_char, i, 0);
-    }
+    // fill them with zeroes. Set the snapshot size in order to let the Quake
+    // Manager know about the size of the current downlink; it's smaller than the
+    // planned size if any delta flows were sent as deltas.
+    snapshot_size_bytes_f.set(frame.flush());
 
     // Shift flow priorities
     if (shift_flows_id1_f.get()>0 && shift_flows_id2_f.get()>0) {
@@ -183,6 +218,47 @@ void DownlinkProducer::execute() {
     }
 }
 
+size_t DownlinkProducer::write_delta_flow(bit_writer& frame, size_t header_idx) {
+    Flow& flow = *plan[header_idx].flow;
+    const size_t num_fields = flow.field_list.size();
+    const PlanEntry* const entries = &plan[header_idx + 1];
+    const bool has_reference = !flow.reference.empty();
+
+    // Serialize the flow's fields, and find the sizes of the flow as a keyframe and
+    // as a delta.
+    size_t keyframe_bits = 0;
+    size_t delta_bits = num_fields;
+    flow.pending.clear();
+    for (size_t i = 0; i < num_fields; i++) {
+        if (entries[i].type == PlanEntry::Type::field) entries[i].field->serialize();
+        const bit_array& field_bits = entries[i].field->get_bit_array();
+        keyframe_bits += field_bits.size();
+        if (!has_reference || field_bits != flow.reference[i]) delta_bits += field_bits.size();
+        flow.pending.push_back(field_bits);
+    }
+
+    const bool is_keyframe = !has_reference
+        || flow.deltas_since_keyframe + 1 >= flow.keyframe_period
+        || delta_bits >= keyframe_bits;
+    frame.write(is_keyframe, 1);
+    frame.write(flow.next_sequence(), delta_sequence_bits);
+
+    if (is_keyframe) {
+        for (size_t i = 0; i < num_fields; i++) frame.write(flow.pending[i]);
+    }
+    else {
+        for (size_t i = 0; i < num_fields; i++)
+            frame.write(flow.pending[i] != flow.reference[i], 1);
+        for (size_t i = 0; i < num_fields; i++) {
+            if (flow.pending[i] != flow.reference[i]) frame.write(flow.pending[i]);
+        }
+    }
+
+    flow.has_pending = true;
+    flow.pending_is_keyframe = is_keyframe;
+    return num_fields;
+}
+
 DownlinkProducer::~DownlinkProducer() {
     delete[] snapshot;
 }
@@ -191,12 +267,18 @@ DownlinkProducer::~DownlinkProducer() {
 const std::vector<DownlinkProducer::Flow>& DownlinkProducer::get_flows() const {
     return flows;
 }
+
+const std::vector<DownlinkProducer::PlanEntry>& DownlinkProducer::get_plan() const {
+    return plan;
+}
 #endif
 
 DownlinkProducer::Flow::Flow(const StateFieldRegistry& r,
                         const FlowData& flow_data,
                         const size_t num_flows) : id_sr(num_flows),
-                                                  is_active(flow_data.is_active)
+                                                  is_active(flow_data.is_active),
+                                                  keyframe_period(flow_data.keyframe_period),
+                                                  max_staleness(flow_data.max_staleness)
 {
     if (flow_data.id > num_flows || flow_data.id == 0) {
         printf(debug_severity::error, "Flow ID %d is invalid.", flow_data.id);
@@ -209,7 +291,7 @@ DownlinkProducer::Flow::Flow(const StateFieldRegistry& r,
         ReadableStateFieldBase* field_ptr = r.find_readable_field(field_name);
         Event* event_ptr = r.find_event(field_name);
         if (event_ptr && !field_ptr) {
-            ReadableStateFieldBase* casted_event_ptr = dynamic_cast<ReadableStateFieldBase*>(event_ptr);
+            ReadableStateFieldBase* casted_event_ptr = static_cast<ReadableStateFieldBase*>(event_ptr);
             field_list.push_back(casted_event_ptr);
         }
         else if (field_ptr && !event_ptr){
@@ -235,9 +317,24 @@ size_t DownlinkProducer::Flow::get_packet_size() const {
         packet_size += field->get_bit_array().size();
     }
 
+    // Delta flows are never larger than a keyframe, which only adds the delta
+    // header to the flow.
+    if (keyframe_period > 0) packet_size += 1 + delta_sequence_bits;
+
     return packet_size;
 }
 
+void DownlinkProducer::Flow::commit_pending() {
+    reference = pending;
+    deltas_since_keyframe = pending_is_keyframe ? 0 : deltas_since_keyframe + 1;
+    sequence = next_sequence();
+    has_pending = false;
+}
+
+unsigned int DownlinkProducer::Flow::next_sequence() const {
+    return (sequence + 1) & ((1U << delta_sequence_bits) - 1);
+}
+
 void DownlinkProducer::toggle_flow(unsigned char id) {
     if(id > flows.size()) {
         printf(debug_severity::error, "Flow with ID %d was not found.", id);
@@ -255,6 +352,8 @@ void DownlinkProducer::toggle_flow(unsigned char id) {
             break;
         }
     }
+
+    build_plan();
 }
 
 void DownlinkProducer::shift_flow_priorities(unsigned char id1, unsigned char id2) {
@@ -291,4 +390,18 @@ void DownlinkProducer::shift_flow_priorities(unsigned char id1, unsigned char id
             std::swap(flows[i],flows[i+1]);
         }
     }
-}
\ No newline at end of file
+
+    build_plan();
+}
+memory_footprint DownlinkProducer::heap_memory_use() const {
+    memory_footprint fp;
+    fp.flows = memory_footprint::heap_size(flows) + memory_footprint::heap_size(plan);
+    for (const Flow& flow : flows) {
+        fp.flows += memory_footprint::heap_size(flow.field_list)
+            + memory_footprint::heap_size(flow.reference)
+            + memory_footprint::heap_size(flow.pending);
+    }
+    if (snapshot) fp.other = snapshot_size_bytes_f.get();
+    fp.heap = fp.total();
+    return fp;
+}
@@ -2,11 +2,13 @@
 #define DOWNLINK_PRODUCER_HPP_
 
 #include "TimedControlTask.hpp"
+#include <common/bit_writer.hpp>
 #include <common/constant_tracker.hpp>
 
 class DownlinkProducer : public TimedControlTask<void> {
    public:
     TRACKED_CONSTANT_SC(unsigned int, num_bits_in_packet, 560);
+    TRACKED_CONSTANT_SC(unsigned int, delta_sequence_bits, 8);
 
     /**
      * @brief Flow data object, used in order to specify the
@@ -15,6 +17,20 @@ class DownlinkProducer : public TimedControlTask<void> {
      *   no more data.
      * - If this is initially an active flow.
      * - The fields going into a flow.
+     * - Optionally, a keyframe period, which makes the flow a delta flow.
+     * - Optionally, a maximum staleness, which is the minimum rate at which
+     *   the flow is sent when the frame budget can't fit every active flow.
+     *
+     * A delta flow starts with a bit that is 1 if the flow is a keyframe, followed by
+     * a delta_sequence_bits-bit sequence number that goes up by one, modulo
+     * 2^delta_sequence_bits, with each transmitted snapshot that contains the flow. A
+     * keyframe contains every field, like any other flow. Otherwise the flow is a delta,
+     * which contains one bit per field that is 1 if the field changed since the last
+     * snapshot that was transmitted, followed by only the fields that changed. A delta
+     * only applies to the snapshot with the previous sequence number, so the ground can
+     * tell when the snapshot that a delta is based on never arrived. A keyframe is sent
+     * after every keyframe_period - 1 transmitted deltas, and whenever a delta would not
+     * be smaller than the keyframe.
      * 
      * We can create a static list of these and use it to initialize the
      * actual Flow object, which creates pointers to state fields and 
@@ -24,6 +40,8 @@ class DownlinkProducer : public TimedControlTask<void> {
         unsigned char id;
         bool is_active;
         std::vector<std::string> field_list;
+        unsigned int keyframe_period = 0;
+        unsigned int max_staleness = 0;
     };
 
     /**
@@ -51,7 +69,7 @@ class DownlinkProducer : public TimedControlTask<void> {
      * @brief Compute the size of the downlink snapshot.
      * 
      * @param If true, this computes the maximum possible size of the snapshot.
-     * If false, this computes the size while only considering active flows.
+     * If false, this computes the size while only considering scheduled flows.
      */
     size_t compute_downlink_size(const bool compute_max = false) const;
     size_t compute_max_downlink_size() const;
@@ -62,6 +80,11 @@ class DownlinkProducer : public TimedControlTask<void> {
      */
     void execute() override;
 
+    /**
+     * @brief Memory used by the flows, the downlink plan and the snapshot buffer.
+     */
+    memory_footprint heap_memory_use() const override;
+
     /**
      * @brief Destructor; clears the memory allocated for the snapshot
      * buffer.
@@ -102,18 +125,65 @@ class DownlinkProducer : public TimedControlTask<void> {
         //! List of fields within the flow
         std::vector<ReadableStateFieldBase*> field_list;
 
-        //! Number of bits in the entire flow packet, including the flow ID.
+        //! Number of transmitted snapshots between keyframes, or zero if this isn't
+        //! a delta flow.
+        unsigned int keyframe_period;
+
+        //! Number of consecutive taken snapshots that may leave out this active flow,
+        //! or zero if the flow has no minimum rate.
+        unsigned int max_staleness;
+
+        //! If the flow is in the current downlink plan. Only active flows are scheduled.
+        bool is_scheduled = false;
+
+        //! Number of consecutive taken snapshots that left out this active flow.
+        unsigned int staleness = 0;
+
+        /**
+         * @brief State of a delta flow.
+         *
+         * The reference is the bits of each field in the last snapshot that was
+         * transmitted, and is empty until a snapshot containing the flow is transmitted.
+         * The pending bits are those of the most recent snapshot, which become the
+         * reference if the Quake Manager takes that snapshot for transmission. The
+         * sequence number is that of the reference; the pending snapshot's is one more.
+         */
+        std::vector<bit_array> reference;
+        std::vector<bit_array> pending;
+        bool has_pending = false;
+        bool pending_is_keyframe = false;
+        unsigned int deltas_since_keyframe = 0;
+        unsigned int sequence = 0;
+
+        //! Maximum number of bits in the entire flow packet, including the flow ID.
         size_t get_packet_size() const;
 
+        /**
+         * @brief Make the pending bits the reference, now that the snapshot that
+         * contains them has been transmitted.
+         */
+        void commit_pending();
+
+        //! Sequence number of the pending snapshot.
+        unsigned int next_sequence() const;
+
         /**
         * @brief Move assignment operator.
         */
         Flow& operator=(Flow&& rhs) {
             is_active = std::move(rhs.is_active);
             id_sr = std::move(rhs.id_sr);
-            for (size_t i = 0; i<rhs.field_list.size(); i++) {
-                field_list[i] = rhs.field_list[i];
-            }
+            field_list = std::move(rhs.field_list);
+            keyframe_period = rhs.keyframe_period;
+            max_staleness = rhs.max_staleness;
+            is_scheduled = rhs.is_scheduled;
+            staleness = rhs.staleness;
+            reference = std::move(rhs.reference);
+            pending = std::move(rhs.pending);
+            has_pending = rhs.has_pending;
+            pending_is_keyframe = rhs.pending_is_keyframe;
+            deltas_since_keyframe = rhs.deltas_since_keyframe;
+            sequence = rhs.sequence;
             return *this;
         }
 
@@ -133,12 +203,55 @@ class DownlinkProducer : public TimedControlTask<void> {
             is_active = rhs.is_active;
             id_sr = std::move(rhs.id_sr);
             field_list = rhs.field_list;
+            keyframe_period = rhs.keyframe_period;
+            max_staleness = rhs.max_staleness;
+            is_scheduled = rhs.is_scheduled;
+            staleness = rhs.staleness;
+            reference = rhs.reference;
+            pending = rhs.pending;
+            has_pending = rhs.has_pending;
+            pending_is_keyframe = rhs.pending_is_keyframe;
+            deltas_since_keyframe = rhs.deltas_since_keyframe;
+            sequence = rhs.sequence;
             return *this;
         }
     };
 
+    /**
+     * @brief Entry in the downlink plan. The plan lists, in order, every sequence of
+     * bits that is written into the downlink snapshot on each control cycle.
+     */
+    struct PlanEntry {
+        enum class Type : unsigned char {
+            flow_id,      //!< Flow ID, which never changes.
+            field,        //!< State field, which is serialized before it is written.
+            event,        //!< Event, which is serialized when it is signaled.
+            delta_header  //!< Delta header and change bitmap of a delta flow. The entries
+                          //!< of the flow's fields follow this entry.
+        };
+        Type type;
+
+        //! Bits of the flow ID for flow ID entries, and nullptr otherwise.
+        const bit_array* flow_id_bits;
+
+        //! Field or event for field and event entries, and nullptr otherwise.
+        ReadableStateFieldBase* field;
+
+        //! Flow for delta header entries, and nullptr otherwise.
+        Flow* flow;
+
+        //! Offset of the entry from the start of the snapshot, not counting packet headers.
+        //! Entries after a delta flow are placed as if the flow were a keyframe.
+        size_t offset;
+
+        //! Number of bits in the entry. Delta headers count only the keyframe bit and
+        //! sequence number.
+        size_t length;
+    };
+
     #if defined GSW || defined DESKTOP
     const std::vector<Flow>& get_flows() const;
+    const std::vector<PlanEntry>& get_plan() const;
     #endif
 
     /**
@@ -164,12 +277,66 @@ class DownlinkProducer : public TimedControlTask<void> {
     InternalStateField<char*> snapshot_ptr_f;
     InternalStateField<size_t> snapshot_size_bytes_f;
 
+    /**
+     * @brief Set by the Quake Manager when it takes the snapshot for transmission, so
+     * that delta flows know what the ground has received.
+     */
+    InternalStateField<bool> snapshot_taken_f;
+
+    /**
+     * @brief Maximum number of Quake MO messages in a downlink frame, or zero for no
+     * limit. When the active flows don't fit, schedule_flows() picks the flows that
+     * are sent.
+     */
+    WritableStateField<unsigned char> frame_budget_f;
+
     /**
      * @brief Actual flow data.
      */
     unsigned int num_active_flows = 0;
     std::vector<Flow> flows;
 
+    /**
+     * @brief Frame budget that the current schedule was made for.
+     */
+    unsigned char scheduled_budget = 0;
+
+    /**
+     * @brief Choose which active flows are sent in the next frame.
+     *
+     * With no frame budget, every active flow is sent. Otherwise the budget is
+     * filled with flows in order of urgency. Flows that have reached their maximum
+     * staleness come first, in priority order. The rest are ranked by their priority
+     * weight times one more than their staleness, where the highest priority active
+     * flow has a weight equal to the number of active flows and the lowest has a
+     * weight of one. A flow that doesn't fit in the space left is skipped in favor
+     * of the next one that does, so that no flow that was left out would have fit.
+     * Flows that are left out grow staler with each taken snapshot until they're sent.
+     */
+    void schedule_flows();
+
+    /**
+     * @brief Plan for the downlink snapshot. It only changes when the set or order of
+     * active flows changes, so it is computed by build_plan() rather than on every
+     * control cycle.
+     */
+    std::vector<PlanEntry> plan;
+
+    /**
+     * @brief Compile the active flows into the downlink plan. This must be called
+     * whenever flows are activated, deactivated or reordered.
+     */
+    void build_plan();
+
+    /**
+     * @brief Write a delta flow into the snapshot.
+     *
+     * @param frame      Snapshot being written.
+     * @param header_idx Index of the flow's delta header entry in the plan.
+     * @return Number of plan entries after the header that were written.
+     */
+    size_t write_delta_flow(bit_writer& frame, size_t header_idx);
+
     /**
      * @brief Fields used to shift flows. Moves the flow with id1 to the flow with 
      * id2's position. Default is <0,0> (No flow can have an id of 0).
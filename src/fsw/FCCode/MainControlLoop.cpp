@@ -45,7 +45,29 @@ MainControlLoop::MainControlLoop(StateFieldRegistry& registry,
       mission_manager(registry, mission_manager_offset), // This item is initialized near-last so it has access to all state fields
       attitude_computer(registry, attitude_computer_offset), // This item needs "adcs.state" from mission manager.
       adcs_commander(registry, adcs_commander_offset), // needs inputs from attitude computer
-      adcs_box_controller(registry, adcs_box_controller_offset, adcs)
+      adcs_box_controller(registry, adcs_box_controller_offset, adcs),
+      task_schedule(registry, {
+          // The tasks that execute() runs on time, in the order that it runs them
+          {"piksi", "piksi_control_task_offset", piksi_control_task_offset, &piksi_control_task},
+          {"gomspace_rd", "gomspace_controller_offset", gomspace_controller_offset, &gomspace_controller},
+          {"adcs_monitor", "adcs_monitor_offset", adcs_monitor_offset, &adcs_monitor},
+          #ifdef FUNCTIONAL_TEST
+          {"debug", "debug_task_offset", debug_task_offset, &debug_task},
+          #endif
+          {"adcs_estimator", "attitude_estimator_offset", attitude_estimator_offset, &attitude_estimator},
+          {"mission_ct", "mission_manager_offset", mission_manager_offset, &mission_manager},
+          {"attitude_computer", "attitude_computer_offset", attitude_computer_offset, &attitude_computer},
+          {"adcs_commander", "adcs_commander_offset", adcs_commander_offset, &adcs_commander},
+          {"adcs_controller", "adcs_box_controller_offset", adcs_box_controller_offset, &adcs_box_controller},
+          {"downlink_ct", "downlink_producer_offset", downlink_producer_offset, &downlink_producer},
+          {"quake", "quake_manager_offset", quake_manager_offset, &quake_manager},
+          {"docking_ct", "docking_controller_offset", docking_controller_offset, &docking_controller},
+          {"dcdc_ct", "dcdc_controller_offset", dcdc_controller_offset, &dcdc_controller},
+          #ifdef DESKTOP
+          {"eeprom_ct", "eeprom_controller_offset", eeprom_controller_offset, &eeprom_controller},
+          #endif
+      }, PAN::control_cycle_time_us),
+      memory_report(registry)
 {
     docking_controller.init();
 
@@ -76,6 +98,25 @@ MainControlLoop::MainControlLoop(StateFieldRegistry& registry,
     WritableStateField<bool>* fault_handler_enabled_fp =
         find_writable_field<bool>("fault_handler.enabled", __FILE__, __LINE__);
     fault_handler_enabled_fp->set(false);
+
+    memory_report.add_task("field_creator_task", field_creator_task);
+    memory_report.add_task("clock_manager", clock_manager);
+    memory_report.add_task("piksi_control_task", piksi_control_task);
+    memory_report.add_task("adcs_monitor", adcs_monitor);
+    memory_report.add_task("debug_task", debug_task);
+    memory_report.add_task("attitude_estimator", attitude_estimator);
+    memory_report.add_task("gomspace_controller", gomspace_controller);
+    memory_report.add_task("docking_controller", docking_controller);
+    memory_report.add_task("downlink_producer", downlink_producer);
+    memory_report.add_task("quake_manager", quake_manager);
+    memory_report.add_task("uplink_consumer", uplink_consumer);
+    memory_report.add_task("dcdc_controller", dcdc_controller);
+    memory_report.add_task("eeprom_controller", eeprom_controller);
+    memory_report.add_task("mission_manager", mission_manager);
+    memory_report.add_task("attitude_computer", attitude_computer);
+    memory_report.add_task("adcs_commander", adcs_commander);
+    memory_report.add_task("adcs_box_controller", adcs_box_controller);
+    memory_report.add_task("task_schedule", task_schedule);
 }
 
 void MainControlLoop::execute() {
@@ -113,6 +154,17 @@ void MainControlLoop::execute() {
         // eeprom_controller.execute_on_time();
         // Commented to save EEPROM Cycles
     #endif
+
+    task_schedule.execute();
+    memory_report.execute();
+}
+
+TaskSchedule& MainControlLoop::get_task_schedule() {
+    return task_schedule;
+}
+
+const MemoryReport& MainControlLoop::get_memory_report() const {
+    return memory_report;
 }
 
 #ifdef GSW
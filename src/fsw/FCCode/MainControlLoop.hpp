@@ -24,6 +24,8 @@
 #include "DownlinkProducer.hpp"
 #include "EEPROMController.hpp"
 #include "UplinkConsumer.h"
+#include "TaskSchedule.hpp"
+#include "MemoryReport.hpp"
 
 #if (!defined(FUNCTIONAL_TEST) && !defined(FLIGHT))
 static_assert(false, "Need to define either the FUNCTIONAL_TEST or FLIGHT flags.");
@@ -64,7 +66,13 @@ class MainControlLoop : public ControlTask<void> {
 
     // Control cycle time offsets, in microseconds
     // Defined in https://cornellprod-my.sharepoint.com/:x:/r/personal/saa243_cornell_edu/_layouts/15/Doc.aspx?sourcedoc=%7B04C55BBB-7AED-410B-AC43-67352393D6D5%7D&file=Flight%20Software%20Cycle.xlsx&action=default&mobileredirect=true&cid=e2b9bd89-7037-47bf-ad2a-fd8b25808939
-    #ifdef FUNCTIONAL_TEST
+    // or, if CALIBRATED_OFFSETS is defined, in the header that it names, which is
+    // written by the native binary's --calibrate mode.
+    #if defined(CALIBRATED_OFFSETS)
+        #include CALIBRATED_OFFSETS
+        // The uplink consumer isn't run on time, so it isn't calibrated.
+        TRACKED_CONSTANT_SC(unsigned int, uplink_consumer_offset     , 111500);
+    #elif defined(FUNCTIONAL_TEST)
         TRACKED_CONSTANT_SC(unsigned int, piksi_control_task_offset  , 5500);
         TRACKED_CONSTANT_SC(unsigned int, adcs_monitor_offset        , 7500);
         TRACKED_CONSTANT_SC(unsigned int, debug_task_offset          , 35500);
@@ -111,6 +119,10 @@ class MainControlLoop : public ControlTask<void> {
 
     ADCSBoxController adcs_box_controller; // needs adcs.state from MissionManager
 
+    TaskSchedule task_schedule; // needs the timing fields of all of the tasks above
+
+    MemoryReport memory_report;
+
    public:
     /*
      * @brief Construct a new Main Control Loop Task object
@@ -126,6 +138,17 @@ class MainControlLoop : public ControlTask<void> {
      */
     void execute() override;
 
+    /**
+     * @brief Schedule of the timed control tasks, for checking and calibrating
+     * their offsets.
+     */
+    TaskSchedule& get_task_schedule();
+
+    /**
+     * @brief Report of the memory used by the state fields and the control tasks.
+     */
+    const MemoryReport& get_memory_report() const;
+
     #ifdef GSW
         /**
          * @brief This function allows ground software to access the downlink.
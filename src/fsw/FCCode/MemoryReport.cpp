@@ -0,0 +1,133 @@
+#include "MemoryReport.hpp"
+#include "CycleTrace.hpp"
+#include <algorithm>
+
+#ifdef DESKTOP
+#include <fstream>
+#endif
+
+constexpr size_t MemoryReport::num_printed_fields;
+
+MemoryReport::MemoryReport(StateFieldRegistry& registry) :
+    ControlTask<void>(registry),
+    report_f("sys.memory_report", Serializer<bool>())
+{
+    #ifdef FUNCTIONAL_TEST
+    add_writable_field(report_f);
+    #endif
+    report_f.set(false);
+}
+
+void MemoryReport::execute() {
+    if (report_f.get()) {
+        print();
+        report_f.set(false);
+    }
+}
+
+std::vector<MemoryReport::Entry> MemoryReport::fields() const {
+    std::vector<Entry> entries;
+    for (const InternalStateFieldBase* field : _registry.internal_fields)
+        entries.push_back({field->name(), field->memory_use()});
+    for (const ReadableStateFieldBase* field : _registry.readable_fields)
+        entries.push_back({field->name(), field->memory_use()});
+    for (const Event* event : _registry.events)
+        entries.push_back({event->name(), event->memory_use()});
+    return entries;
+}
+
+std::vector<MemoryReport::Entry> MemoryReport::tasks() const {
+    std::vector<const StateFieldBase*> all_fields;
+    all_fields.insert(all_fields.end(),
+        _registry.internal_fields.begin(), _registry.internal_fields.end());
+    all_fields.insert(all_fields.end(),
+        _registry.readable_fields.begin(), _registry.readable_fields.end());
+    all_fields.insert(all_fields.end(), _registry.events.begin(), _registry.events.end());
+
+    std::vector<Entry> entries;
+    for (const Task& task : added_tasks) {
+        // A field is part of the task if it's inside the task object. The rest of the
+        // task object is counted as other memory.
+        const char* begin = static_cast<const char*>(task.task);
+        const char* end = begin + task.size;
+        memory_footprint fp;
+        size_t fields_size = 0;
+        for (const StateFieldBase* field : all_fields) {
+            const char* address = reinterpret_cast<const char*>(field);
+            if (address < begin || address >= end) continue;
+            const memory_footprint field_fp = field->memory_use();
+            fp += field_fp;
+            fields_size += field_fp.total() - field_fp.heap;
+        }
+        fp.other += task.size - std::min(fields_size, task.size);
+        fp += task.heap_memory_use(task.task);
+        entries.push_back({task.name, fp});
+    }
+    return entries;
+}
+
+memory_footprint MemoryReport::fields_total() const {
+    memory_footprint total;
+    for (const Entry& entry : fields()) total += entry.footprint;
+    return total;
+}
+
+void MemoryReport::print() {
+    const memory_footprint total = fields_total();
+    printf(debug_severity::info, "Fields and events: %u bytes, %u of them on the heap",
+        static_cast<unsigned int>(total.total()), static_cast<unsigned int>(total.heap));
+    printf(debug_severity::info, "Values %u, serializers %u, events %u, names %u, other %u",
+        static_cast<unsigned int>(total.values), static_cast<unsigned int>(total.serializers),
+        static_cast<unsigned int>(total.events), static_cast<unsigned int>(total.names),
+        static_cast<unsigned int>(total.other));
+    printf(debug_severity::info, "Shared print buffer: %u bytes",
+        static_cast<unsigned int>(SerializerType::print_buffer_size));
+    printf(debug_severity::info, "Cycle trace: %u bytes",
+        static_cast<unsigned int>(CycleTrace::memory_use().total()));
+
+    for (const Entry& entry : tasks()) {
+        printf(debug_severity::info, "Task %s: %u bytes, %u of them on the heap, %u in flows",
+            entry.name.c_str(), static_cast<unsigned int>(entry.footprint.total()),
+            static_cast<unsigned int>(entry.footprint.heap),
+            static_cast<unsigned int>(entry.footprint.flows));
+    }
+
+    std::vector<Entry> largest = fields();
+    const size_t num_printed = std::min(num_printed_fields, largest.size());
+    std::partial_sort(largest.begin(), largest.begin() + num_printed, largest.end(),
+        [](const Entry& a, const Entry& b) {
+            return a.footprint.total() > b.footprint.total();
+        });
+    for (size_t i = 0; i < num_printed; i++) {
+        printf(debug_severity::info, "Field %s: %u bytes", largest[i].name.c_str(),
+            static_cast<unsigned int>(largest[i].footprint.total()));
+    }
+}
+
+#ifdef DESKTOP
+bool MemoryReport::write(const std::string& path) const {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    out << "kind,name,values,serializers,events,flows,names,other,heap,total\n";
+    auto write_entry = [&](const char* kind, const Entry& entry) {
+        const memory_footprint& fp = entry.footprint;
+        out << kind << "," << entry.name << "," << fp.values << "," << fp.serializers << ","
+            << fp.events << "," << fp.flows << "," << fp.names << "," << fp.other << ","
+            << fp.heap << "," << fp.total() << "\n";
+    };
+
+    for (const Entry& entry : fields()) write_entry("field", entry);
+    for (const Entry& entry : tasks()) write_entry("task", entry);
+
+    memory_footprint print_buffer;
+    print_buffer.other = SerializerType::print_buffer_size;
+    write_entry("shared", {"print_buffer", print_buffer});
+    write_entry("shared", {"cycle_trace", CycleTrace::memory_use()});
+
+    if (!out) {
+        printf(debug_severity::error, "Couldn't write memory report to %s.", path.c_str());
+        return false;
+    }
+    printf(debug_severity::info, "Wrote memory report to %s.", path.c_str());
+    return true;
+}
+#endif
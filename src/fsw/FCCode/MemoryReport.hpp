@@ -0,0 +1,114 @@
+#ifndef MEMORY_REPORT_HPP_
+#define MEMORY_REPORT_HPP_
+
+#include "ControlTask.hpp"
+#include <common/memory_footprint.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reports how much RAM is used by each state field, event and control task.
+ *
+ * Fields and events are found by walking the registry, and each one reports its own
+ * footprint through StateFieldBase::memory_use(). Control tasks are added with
+ * add_task(). A task's footprint is the size of the task object, split up by the
+ * footprints of the fields that are inside it, plus whatever the task reports in
+ * ControlTask::heap_memory_use().
+ *
+ * The report is printed through the debug console when "sys.memory_report" is set, and
+ * on desktop it can also be written to a CSV file with write(). The native binary's
+ * --memory-report mode writes the file after the flight software is constructed.
+ */
+class MemoryReport : public ControlTask<void> {
+  public:
+    /**
+     * @brief Footprint of a field, event or task in the report.
+     */
+    struct Entry {
+        std::string name;
+        memory_footprint footprint;
+    };
+
+    /**
+     * @brief Number of fields with the largest footprints that are printed through the
+     * debug console. Every field is written by write().
+     */
+    static constexpr size_t num_printed_fields = 10;
+
+    /**
+     * @brief Construct a new memory report.
+     *
+     * @param registry State field registry
+     */
+    MemoryReport(StateFieldRegistry& registry);
+
+    /**
+     * @brief Add a control task to the report.
+     *
+     * @param name Name of the task in the report.
+     * @param task The task, which must outlive the report.
+     */
+    template<typename TaskType>
+    void add_task(const char* name, const TaskType& task) {
+        added_tasks.push_back({name, &task, sizeof(TaskType), [](const void* t) {
+            return static_cast<const TaskType*>(t)->heap_memory_use();
+        }});
+    }
+
+    /**
+     * @brief Prints the report through the debug console if sys.memory_report is set.
+     */
+    void execute() override;
+
+    /**
+     * @brief Footprint of each field and event in the registry, in registry order.
+     */
+    std::vector<Entry> fields() const;
+
+    /**
+     * @brief Footprint of each control task, in the order in which they were added.
+     */
+    std::vector<Entry> tasks() const;
+
+    /**
+     * @brief Sum of the footprints of all fields and events in the registry. The
+     * print buffer that's shared by all serializers isn't included.
+     */
+    memory_footprint fields_total() const;
+
+    /**
+     * @brief Print the totals, the tasks and the largest fields through the debug
+     * console.
+     */
+    void print();
+
+#ifdef DESKTOP
+    /**
+     * @brief Write every field, event and task to a CSV file, with one column for each
+     * category of memory_footprint.
+     *
+     * @return True if the file was written.
+     */
+    bool write(const std::string& path) const;
+#endif
+
+  protected:
+    /**
+     * @brief A task that was added to the report.
+     */
+    struct Task {
+        const char* name;
+        const void* task;
+        size_t size;
+        memory_footprint (*heap_memory_use)(const void* task);
+    };
+    std::vector<Task> added_tasks;
+
+    /**
+     * @brief Set to print the report at the next control cycle. Cleared once the
+     * report is printed.
+     */
+    WritableStateField<bool> report_f;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <adcs/constants.hpp>
 #include <common/constant_tracker.hpp>
+#include <field_manifest.hpp>
 #include "SimpleFaultHandler.hpp"
 
 // Declare static storage for constexpr variables
@@ -52,8 +53,8 @@ MissionManager::MissionManager(StateFieldRegistry& registry, unsigned int offset
     adcs_paired_fp = find_writable_field<bool>("adcs.paired", __FILE__, __LINE__);
     adcs_ang_momentum_fp = find_internal_field<lin::Vector3f>("attitude_estimator.h_body", __FILE__, __LINE__);
 
-    radio_state_fp = find_internal_field<unsigned char>("radio.state", __FILE__, __LINE__);
-    last_checkin_cycle_fp = find_internal_field<unsigned int>("radio.last_comms_ccno", __FILE__, __LINE__);
+    radio_state_fp = find_field(PAN::fields::radio_state);
+    last_checkin_cycle_fp = find_field(PAN::fields::radio_last_comms_ccno);
 
     prop_state_fp = find_readable_field<unsigned char>("prop.state", __FILE__, __LINE__);
 
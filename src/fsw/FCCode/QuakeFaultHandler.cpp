@@ -1,13 +1,13 @@
 #include "QuakeFaultHandler.hpp"
 #include "constants.hpp"
 #include "radio_state_t.enum"
+#include <field_manifest.hpp>
 
 const unsigned int& control_cycle_count = TimedControlTaskBase::control_cycle_count;
 
 QuakeFaultHandler::QuakeFaultHandler(StateFieldRegistry& r) : FaultHandlerMachine(r) {
-    radio_state_fp        = find_internal_field<unsigned char>("radio.state", __FILE__, __LINE__);
-    last_checkin_cycle_fp = find_internal_field<unsigned int>("radio.last_comms_ccno", __FILE__,
-                                                                  __LINE__);
+    radio_state_fp        = find_field(PAN::fields::radio_state);
+    last_checkin_cycle_fp = find_field(PAN::fields::radio_last_comms_ccno);
     power_cycle_radio_fp  = find_writable_field<bool>("gomspace.power_cycle_output1_cmd", __FILE__,
                                                           __LINE__);
 }
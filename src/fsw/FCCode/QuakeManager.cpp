@@ -1,5 +1,6 @@
 #include "QuakeManager.h"
 #include "Drivers/QLocate.hpp"
+#include <field_manifest.hpp>
 
 #include "radio_state_t.enum"
 
@@ -44,18 +45,19 @@ QuakeManager::QuakeManager(StateFieldRegistry &registry, unsigned int offset) :
     add_writable_field(max_wait_cycles_f);
     add_writable_field(max_transceive_cycles_f);
     add_readable_field(radio_err_f);
-    add_internal_field(radio_mt_packet_f);
-    add_internal_field(radio_mt_len_f);
-    add_internal_field(radio_state_f);
-    add_internal_field(last_checkin_cycle_f);
+    add_internal_field(radio_mt_packet_f, PAN::fields::uplink_ptr);
+    add_internal_field(radio_mt_len_f, PAN::fields::uplink_len);
+    add_internal_field(radio_state_f, PAN::fields::radio_state);
+    add_internal_field(last_checkin_cycle_f, PAN::fields::radio_last_comms_ccno);
 
     #ifdef FUNCTIONAL_TEST
     add_writable_field(dump_telemetry_f);
     #endif
 
     // Retrieve fields from registry
-    snapshot_size_fp = find_internal_field<size_t>("downlink.snap_size", __FILE__, __LINE__);
-    radio_mo_packet_fp = find_internal_field<char*>("downlink.ptr", __FILE__, __LINE__);
+    snapshot_size_fp = find_field(PAN::fields::downlink_snap_size);
+    radio_mo_packet_fp = find_field(PAN::fields::downlink_ptr);
+    snapshot_taken_fp = find_field(PAN::fields::downlink_taken);
 
     // Initialize Quake Manager variables
     max_wait_cycles_f.set(1);
@@ -71,6 +73,7 @@ QuakeManager::QuakeManager(StateFieldRegistry &registry, unsigned int offset) :
     // Setup MO Buffers
     max_snapshot_size = std::max(snapshot_size_fp->get() + 1, static_cast<size_t>(packet_size));
     mo_buffer_copy = new char[max_snapshot_size];
+    mo_packets = max_snapshot_size / packet_size;
 }
 
 QuakeManager::~QuakeManager()
@@ -106,6 +109,7 @@ bool QuakeManager::execute() {
             }
             Serial.print("\"}\n");
         #endif
+        snapshot_taken_fp->set(true);
     }
     #endif
 
@@ -179,11 +183,17 @@ bool QuakeManager::dispatch_write() {
         if (mo_idx == 0) {
             memset(mo_buffer_copy, 0, max_snapshot_size);
             memcpy(mo_buffer_copy, radio_mo_packet_fp->get(), max_snapshot_size);
+            snapshot_taken_fp->set(true);
+
+            // Only send the messages that the current snapshot occupies
+            const size_t snapshot_packets = (snapshot_size_fp->get() + packet_size - 1) / packet_size;
+            mo_packets = std::min(std::max(snapshot_packets, static_cast<size_t>(1)),
+                                  max_snapshot_size / packet_size);
         }
         // load the current 70 bytes of the buffer
        qct.set_downlink_msg(mo_buffer_copy + (packet_size*mo_idx), packet_size);
-       assert(max_snapshot_size/packet_size != 0);
-       mo_idx = (mo_idx + 1) % (max_snapshot_size/packet_size);
+       assert(mo_packets != 0);
+       mo_idx = (mo_idx + 1) % mo_packets;
     }
 
     int err_code = qct.execute();
@@ -339,4 +349,11 @@ bool QuakeManager::transition_radio_state(radio_state_t new_state)
         qct.get_current_state(),
         radio_state_f.get());
     return bOk;
-}
\ No newline at end of file
+}
+
+memory_footprint QuakeManager::heap_memory_use() const {
+    memory_footprint fp;
+    fp.other = max_snapshot_size;
+    fp.heap = fp.other;
+    return fp;
+}
@@ -30,6 +30,11 @@ class QuakeManager : public TimedControlTask<bool> {
     ~QuakeManager();
     bool execute() override;
 
+    /**
+     * @brief Memory used by the copy of the MO buffer.
+     */
+    memory_footprint heap_memory_use() const override;
+
    // protected:
    /**
     * @brief attempts to execute a step in the CONFIG command sequence. This command
@@ -66,6 +71,12 @@ class QuakeManager : public TimedControlTask<bool> {
    */
   const InternalStateField<char*>* radio_mo_packet_fp;
 
+  /**
+   * @brief Set whenever a snapshot is taken for transmission, provided by
+   * DownlinkProducer.
+   */
+  InternalStateField<bool>* snapshot_taken_fp;
+
   /**
    * @brief State machine constants that control how long the machine may
    * be in the WAIT and TRANSCEIVE states.
@@ -187,6 +198,14 @@ class QuakeManager : public TimedControlTask<bool> {
      */
     size_t mo_idx;
 
+    /**
+     * Number of 70 byte MO messages in the snapshot held in mo_buffer_copy.
+     * Set when the snapshot is copied, from the size of the snapshot that
+     * the DownlinkProducer reports, so that smaller snapshots take fewer
+     * messages.
+     */
+    size_t mo_packets;
+
     /**
      * True if QM encountered an unexpected response from execute()
      * All states transition to wait when this flag is set. 
@@ -0,0 +1,129 @@
+#include "TaskSchedule.hpp"
+#include <algorithm>
+
+#ifdef DESKTOP
+#include <fstream>
+#endif
+
+constexpr unsigned int TaskSchedule::margin_percent;
+constexpr unsigned int TaskSchedule::granularity_us;
+
+TaskSchedule::TaskSchedule(StateFieldRegistry& registry, const std::vector<Entry>& _entries,
+                           unsigned int _cycle_time_us) :
+    ControlTask<void>(registry),
+    entries(_entries),
+    cycle_time_us(_cycle_time_us),
+    is_error(_entries.size(), true),
+    overbudget_f("timing.schedule.overbudget", Serializer<unsigned int>()),
+    errors_f("timing.schedule.errors", Serializer<unsigned int>())
+{
+    add_readable_field(overbudget_f);
+    add_readable_field(errors_f);
+
+    for (const Entry& entry : entries) {
+        const std::string field = std::string("timing.") + entry.task + ".exec_p99";
+        exec_p99_fps.push_back(
+            find_readable_field<unsigned int>(field.c_str(), __FILE__, __LINE__));
+    }
+
+    // The tasks that aren't errors are the longest sequence of tasks, in the order that
+    // they run, whose offsets increase and are within the control cycle. run_length[i]
+    // is the length of the longest such sequence that ends at task i, and prev[i] is
+    // the task before i in that sequence.
+    const size_t n = entries.size();
+    std::vector<size_t> run_length(n, 0);
+    std::vector<size_t> prev(n, n);
+    size_t last = n;
+    for (size_t i = 0; i < n; i++) {
+        if (entries[i].offset >= cycle_time_us) continue;
+        run_length[i] = 1;
+        for (size_t j = 0; j < i; j++) {
+            if (run_length[j] > 0 && entries[j].offset < entries[i].offset
+                && run_length[j] + 1 > run_length[i])
+            {
+                run_length[i] = run_length[j] + 1;
+                prev[i] = j;
+            }
+        }
+        if (last == n || run_length[i] > run_length[last]) last = i;
+    }
+    for (size_t i = last; i < n; i = prev[i]) is_error[i] = false;
+    errors_f.set(static_cast<unsigned int>(std::count(is_error.begin(), is_error.end(), true)));
+}
+
+void TaskSchedule::execute() {
+    unsigned int overbudget = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (is_error[i]) continue;
+        size_t next = i + 1;
+        while (next < entries.size() && is_error[next]) next++;
+        const unsigned int end = next < entries.size() ? entries[next].offset : cycle_time_us;
+        if (exec_p99_fps[i]->get() > end - entries[i].offset) overbudget++;
+    }
+    overbudget_f.set(overbudget);
+}
+
+TaskSchedule::Solution TaskSchedule::solve(const std::vector<unsigned int>& costs,
+                                           unsigned int cycle_time_us) {
+    Solution solution;
+    unsigned int offset = granularity_us;
+    for (unsigned int cost : costs) {
+        solution.offsets.push_back(offset);
+
+        // Every task gets at least one unit of time, since its start is jittery even if
+        // it does nothing.
+        const unsigned int budget = cost + (cost * margin_percent + 99) / 100;
+        offset += std::max(1u, (budget + granularity_us - 1) / granularity_us) * granularity_us;
+    }
+    solution.end = offset;
+    solution.feasible = offset <= cycle_time_us;
+    return solution;
+}
+
+void TaskSchedule::start_calibration() {
+    for (const Entry& entry : entries)
+        if (entry.timed_task) entry.timed_task->reset_timing();
+}
+
+TaskSchedule::Solution TaskSchedule::solve() {
+    // The published percentiles can be up to a publish period behind the histograms
+    for (const Entry& entry : entries)
+        if (entry.timed_task) entry.timed_task->publish_timing();
+
+    std::vector<unsigned int> costs;
+    for (const ReadableStateField<unsigned int>* exec_p99_fp : exec_p99_fps)
+        costs.push_back(exec_p99_fp->get());
+    return solve(costs, cycle_time_us);
+}
+
+#ifdef DESKTOP
+bool TaskSchedule::write_header(const std::string& path, unsigned int num_cycles) {
+    const Solution solution = solve();
+    if (!solution.feasible) {
+        printf(debug_severity::error,
+            "Tasks need %u us, which doesn't fit in a %u us control cycle.",
+            solution.end, cycle_time_us);
+        return false;
+    }
+
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    out << "// Offsets of the timed control tasks in the main control loop, in microseconds,\n"
+        << "// computed from execution times measured over " << num_cycles << " control cycles.\n"
+        << "// Generated by the native binary's --calibrate mode. See TaskSchedule.\n"
+        << "//\n"
+        << "// The tasks' budgets end at " << solution.end << " us, out of a "
+        << cycle_time_us << " us control cycle.\n\n";
+    for (size_t i = 0; i < entries.size(); i++) {
+        // The macro's name is split so that tools/constant_reporter.py skips this line
+        out << "TRACKED_" "CONSTANT_SC(unsigned int, " << entries[i].offset_name << ", "
+            << solution.offsets[i] << "); // p99 execution time: "
+            << exec_p99_fps[i]->get() << " us\n";
+    }
+    if (!out) {
+        printf(debug_severity::error, "Couldn't write task offsets to %s.", path.c_str());
+        return false;
+    }
+    printf(debug_severity::info, "Wrote task offsets to %s.", path.c_str());
+    return true;
+}
+#endif
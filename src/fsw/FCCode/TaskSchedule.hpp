@@ -0,0 +1,140 @@
+#ifndef TASK_SCHEDULE_HPP_
+#define TASK_SCHEDULE_HPP_
+
+#include "ControlTask.hpp"
+#include "TimedControlTask.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Checks the offsets of the timed control tasks in a control loop against the
+ * tasks' measured execution times, and computes new offsets from them.
+ *
+ * A task's budget is the time between its offset and the offset of the task that runs
+ * after it, or the end of the control cycle for the last task. Every cycle, the
+ * schedule counts the tasks whose 99th percentile execution time, as published in
+ * timing.<task>.exec_p99, is over their budget, and publishes the count as
+ * timing.schedule.overbudget. A nonzero count means that the offsets no longer fit the
+ * tasks, and some tasks are starting late.
+ *
+ * Tasks whose offsets can't give them a budget are schedule errors: tasks that start at
+ * or past the end of the control cycle, and the fewest tasks that have to be left out
+ * for the offsets of the rest to increase in the order that the tasks run. They are
+ * counted in timing.schedule.errors instead, and are left out of the budgets of the
+ * other tasks.
+ *
+ * New offsets can be computed with solve(), and written to a header with
+ * write_header(). Those publish the tasks' timing statistics first, so that every
+ * execution time recorded since start_calibration() counts. See MainControlLoop for how
+ * that header is used.
+ */
+class TaskSchedule : public ControlTask<void> {
+  public:
+    /**
+     * @brief A timed control task in the schedule.
+     */
+    struct Entry {
+        /** Name of the task, as passed to TimedControlTask. */
+        const char* task;
+        /** Name of the constant that holds the task's offset. */
+        const char* offset_name;
+        /** The task's offset, in microseconds. */
+        unsigned int offset;
+        /** The task, if its timing statistics are to be calibrated. */
+        TimedControlTaskBase* timed_task = nullptr;
+    };
+
+    /**
+     * @brief Each task's budget in a solved schedule is its execution time, plus this
+     * percentage, rounded up to a multiple of granularity_us.
+     */
+    static constexpr unsigned int margin_percent = 25;
+    static constexpr unsigned int granularity_us = 100;
+
+    /**
+     * @brief Offsets computed by solve().
+     */
+    struct Solution {
+        std::vector<unsigned int> offsets;
+        /** Time at which the last task's budget ends, in microseconds. */
+        unsigned int end;
+        /** True if every task's budget fits in the control cycle. */
+        bool feasible;
+    };
+
+    /**
+     * @brief Construct a new task schedule. Must be constructed after all of the tasks
+     * in the schedule, so that their timing fields can be found.
+     *
+     * @param registry State field registry
+     * @param entries The tasks in the schedule, in the order in which they execute.
+     * @param cycle_time_us Duration of a control cycle, in microseconds.
+     */
+    TaskSchedule(StateFieldRegistry& registry, const std::vector<Entry>& entries,
+                 unsigned int cycle_time_us);
+
+    /**
+     * @brief Counts the tasks that are over their budget.
+     */
+    void execute() override;
+
+    /**
+     * @brief Computes the tightest offsets for tasks with the given execution times,
+     * which run in order starting one granularity_us after the start of the cycle.
+     *
+     * @param costs Execution time of each task, in microseconds.
+     * @param cycle_time_us Duration of a control cycle, in microseconds.
+     */
+    static Solution solve(const std::vector<unsigned int>& costs, unsigned int cycle_time_us);
+
+    /**
+     * @brief Clears the timing statistics of the tasks in this schedule, so that only
+     * execution times recorded from now on are used by solve().
+     */
+    void start_calibration();
+
+    /**
+     * @brief Computes the tightest offsets for the tasks in this schedule from their
+     * measured 99th percentile execution times.
+     */
+    Solution solve();
+
+#ifdef DESKTOP
+    /**
+     * @brief Solves for new offsets from the measured execution times, and writes them
+     * to a header as tracked constants.
+     *
+     * @param path Path of the header.
+     * @param num_cycles Number of control cycles that the execution times were measured
+     * over, for the header's comment.
+     * @return True if the schedule was feasible and the header was written.
+     */
+    bool write_header(const std::string& path, unsigned int num_cycles);
+#endif
+
+  protected:
+    const std::vector<Entry> entries;
+    const unsigned int cycle_time_us;
+
+    /**
+     * @brief Each task's timing.<task>.exec_p99 field.
+     */
+    std::vector<const ReadableStateField<unsigned int>*> exec_p99_fps;
+
+    /**
+     * @brief Whether each task is a schedule error.
+     */
+    std::vector<bool> is_error;
+
+    /**
+     * @brief Number of tasks whose 99th percentile execution time is over their budget.
+     */
+    ReadableStateField<unsigned int> overbudget_f;
+
+    /**
+     * @brief Number of tasks that are schedule errors.
+     */
+    ReadableStateField<unsigned int> errors_f;
+};
+
+#endif
@@ -2,3 +2,7 @@
 
 sys_time_t TimedControlTaskBase::control_cycle_start_time;
 unsigned int TimedControlTaskBase::control_cycle_count = 0;
+#ifdef DESKTOP
+bool TimedControlTaskBase::virtual_clock = false;
+sys_time_t TimedControlTaskBase::virtual_time;
+#endif
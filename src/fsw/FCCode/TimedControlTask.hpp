@@ -2,6 +2,8 @@
 #define TIMED_CONTROL_TASK_HPP_
 
 #include "ControlTask.hpp"
+#include "CycleTrace.hpp"
+#include "TimingHistogram.hpp"
 #include "constants.hpp"
 #include <string>
 
@@ -43,10 +45,56 @@ class TimedControlTaskBase {
      */
     static sys_time_t control_cycle_start_time;
     
+#ifdef DESKTOP
+    /**
+     * @brief True if the system time is virtual. See use_virtual_clock().
+     */
+    static bool virtual_clock;
+
+    /**
+     * @brief The virtual system time.
+     */
+    static sys_time_t virtual_time;
+#endif
 
   public:
     static unsigned int control_cycle_count;
 
+    /**
+     * @brief Number of times that a task's execution time and start jitter are recorded
+     * between updates of their published percentiles.
+     */
+    static constexpr unsigned int timing_publish_period = 32;
+
+    /**
+     * @brief Clear the task's timing statistics, e.g. to leave warm-up cycles out of a
+     * measurement.
+     */
+    virtual void reset_timing() = 0;
+
+    /**
+     * @brief Publish the percentiles of the task's timing statistics now, rather than
+     * at the next update.
+     */
+    virtual void publish_timing() = 0;
+
+#ifdef DESKTOP
+    /**
+     * @brief Switch the system time between the real clock and a virtual clock.
+     * 
+     * The virtual clock starts at the current real time, and only moves forward when a
+     * task waits, by exactly the time waited, so waits return immediately. This lets a
+     * simulation run the flight software as fast as the computer allows, with the same
+     * timing on every run. Should be called before the first control cycle.
+     * 
+     * @param enabled True for the virtual clock, false for the real clock.
+     */
+    static void use_virtual_clock(bool enabled) {
+      virtual_clock = enabled;
+      virtual_time = std::chrono::steady_clock::now();
+    }
+#endif
+
     /**
      * @brief Get the system time.
      * 
@@ -54,7 +102,7 @@ class TimedControlTaskBase {
      */
     static sys_time_t get_system_time() {
       #ifdef DESKTOP
-        return std::chrono::steady_clock::now();
+        return virtual_clock ? virtual_time : std::chrono::steady_clock::now();
       #else
         return micros();
       #endif
@@ -88,14 +136,35 @@ class TimedControlTaskBase {
       #endif
     }
 
+    /**
+     * @brief Convert a system time into a timestamp for the cycle trace, in
+     * microseconds. The timestamp wraps around every 2^32 microseconds.
+     */
+    static unsigned int trace_time(const sys_time_t& time) {
+      return duration_to_us(time - sys_time_t());
+    }
+
     static void wait_duration(const unsigned int& delta_t) {
-      const sys_time_t start = get_system_time();
-      // Wait until execution time
-      while(duration_to_us(get_system_time() - start) < delta_t) {
-        #ifndef DESKTOP
+      #ifdef DESKTOP
+        if (virtual_clock) {
+          virtual_time += us_to_duration(delta_t);
+          return;
+        }
+
+        // Sleep through most of the wait so that waiting doesn't occupy a core, and
+        // spin through the rest, since the OS can wake us up late.
+        const sys_time_t end = get_system_time() + us_to_duration(delta_t);
+        constexpr unsigned int spin_time = 200;
+        if (delta_t > spin_time)
+          std::this_thread::sleep_until(end - us_to_duration(spin_time));
+        while (get_system_time() < end) {}
+      #else
+        const sys_time_t start = get_system_time();
+        // Wait until execution time
+        while(duration_to_us(get_system_time() - start) < delta_t) {
           delayMicroseconds(10);
-        #endif
-      }
+        }
+      #endif
     }
 };
 
@@ -121,16 +190,109 @@ class TimedControlTask : public ControlTask<T>, public TimedControlTaskBase {
     ReadableStateField<unsigned int> num_lates_f;
 
     /**
-     * @brief Number of times a control task
+     * @brief Average time that this task waited for its start time, in microseconds.
+     * Computed from an integer total, so that it doesn't lose precision over long runs.
      */
     std::string avg_wait_field_name;
-    ReadableStateField<float> avg_wait_f;
+    FixedReadableStateField<float, 32> avg_wait_f;
+    unsigned long long total_wait = 0;
+    unsigned int num_waits = 0;
+
+    /**
+     * @brief Histogram of a timing statistic, and state fields for its percentiles.
+     * The maximum is updated whenever the histogram is, but the percentiles, which
+     * take a scan of the histogram, are only updated every timing_publish_period
+     * records.
+     */
+    struct TimingStatistic {
+      TimingHistogram histogram;
+      ReadableStateField<unsigned int> p50_f;
+      ReadableStateField<unsigned int> p99_f;
+      ReadableStateField<unsigned int> max_f;
+      unsigned char records_until_publish = 0;
+
+      /**
+       * @param prefix Prefix of the percentile fields' names, e.g. "timing.task.exec".
+       */
+      TimingStatistic(const std::string& prefix) :
+        p50_f(prefix + "_p50", Serializer<unsigned int>()),
+        p99_f(prefix + "_p99", Serializer<unsigned int>()),
+        max_f(prefix + "_max", Serializer<unsigned int>()) {}
+
+      void record(unsigned int us) {
+        histogram.record(us);
+        max_f.set(histogram.max());
+        if (records_until_publish-- > 0) return;
+        publish();
+      }
+
+      void publish() {
+        static constexpr unsigned int pcts[2] = {50, 99};
+        unsigned int values[2];
+        histogram.percentiles(pcts, values, 2);
+        p50_f.set(values[0]);
+        p99_f.set(values[1]);
+        records_until_publish = timing_publish_period - 1;
+      }
+
+      void reset() {
+        histogram = TimingHistogram();
+        max_f.set(0);
+        publish();
+        records_until_publish = 0;
+      }
+    };
+
+    /**
+     * @brief Time between this task's start time and the start of its execute(), and
+     * time that its execute() takes, in microseconds.
+     */
+    TimingStatistic start_jitter;
+    TimingStatistic exec_time;
+
+    /**
+     * @brief ID of this task in the cycle trace.
+     */
+    const unsigned short trace_id;
+
+    /**
+     * @brief Records the execution time of a task when it goes out of scope, so that
+     * execute_on_time() can time execute() even if it returns void.
+     */
+    class ExecutionTimer {
+      TimedControlTask& task;
+      const sys_time_t start;
+
+     public:
+      ExecutionTimer(TimedControlTask& task, const sys_time_t& start) :
+        task(task), start(start) {}
+      ~ExecutionTimer() {
+        const sys_time_t end = get_system_time();
+        CycleTrace::record(task.trace_id, CycleTrace::task_end, trace_time(end));
+        task.exec_time.record(duration_to_us(end - start));
+      }
+    };
 
   public:
+    void reset_timing() override {
+      start_jitter.reset();
+      exec_time.reset();
+    }
+
+    void publish_timing() override {
+      start_jitter.publish();
+      exec_time.publish();
+    }
+
     /**
      * @brief Execute this control task's task, but only if it's reached its
      * start time.
      * 
+     * Records how late execute() started and how long it took into this task's timing
+     * histograms, whose percentiles are published as timing.<name>.jitter_* and
+     * timing.<name>.exec_* state fields, and records its start and end in the cycle
+     * trace.
+     * 
      * @param control_cycle_start_time System time for the start of the control task.
      * @return T Value returned by execute().
      */
@@ -138,6 +300,13 @@ class TimedControlTask : public ControlTask<T>, public TimedControlTaskBase {
       sys_time_t earliest_start_time = 
         TimedControlTaskBase::control_cycle_start_time + offset;
       wait_until_time(earliest_start_time);
+
+      const sys_time_t start_time = get_system_time();
+      const signed int jitter = (signed int) duration_to_us(start_time - earliest_start_time);
+      start_jitter.record(std::max(jitter, 0));
+      CycleTrace::record(trace_id, CycleTrace::task_start, trace_time(start_time));
+
+      ExecutionTimer timer(*this, start_time);
       return this->execute();
     }
 
@@ -155,9 +324,9 @@ class TimedControlTask : public ControlTask<T>, public TimedControlTaskBase {
         num_lates_f.set(num_lates_f.get() + 1);
       }
       const unsigned int wait_time = std::max(delta_t, 0);
-      const float new_avg_wait = ((avg_wait_f.get() * control_cycle_count) + wait_time) /
-        (control_cycle_count + 1);
-      avg_wait_f.set(new_avg_wait);
+      total_wait += wait_time;
+      num_waits++;
+      avg_wait_f.set(static_cast<float>(total_wait) / num_waits);
 
       wait_duration(wait_time); 
     }
@@ -178,10 +347,18 @@ class TimedControlTask : public ControlTask<T>, public TimedControlTaskBase {
         num_lates_field_name("timing." + name + ".num_lates"),
         num_lates_f(num_lates_field_name, Serializer<unsigned int>()),
         avg_wait_field_name("timing." + name + ".avg_wait"),
-        avg_wait_f(avg_wait_field_name, Serializer<float>(0,PAN::control_cycle_time_us,32))
+        avg_wait_f(avg_wait_field_name, Serializer<float, 32>(0, PAN::control_cycle_time_us)),
+        start_jitter("timing." + name + ".jitter"),
+        exec_time("timing." + name + ".exec"),
+        trace_id(CycleTrace::add_task(name))
     {
       this->add_readable_field(num_lates_f);
       this->add_readable_field(avg_wait_f);
+      for (TimingStatistic* stat : {&start_jitter, &exec_time}) {
+        this->add_readable_field(stat->p50_f);
+        this->add_readable_field(stat->p99_f);
+        this->add_readable_field(stat->max_f);
+      }
     }
 };
 
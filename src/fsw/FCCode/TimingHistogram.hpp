@@ -0,0 +1,133 @@
+#ifndef TIMING_HISTOGRAM_HPP_
+#define TIMING_HISTOGRAM_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Histogram of durations in microseconds, with log-scale buckets.
+ *
+ * Each power of two is split into sub_buckets equal buckets, so a percentile read from
+ * the histogram is within 1/sub_buckets of the true value, while durations of up to a
+ * control cycle fit in about a hundred buckets. Recording a duration is a few integer
+ * operations and never allocates, so it's cheap enough to do on every control cycle.
+ * Reading a percentile scans every bucket, so it should be done less often.
+ *
+ * Bucket counts are 16 bits wide. When a bucket fills up, every count is halved, so
+ * older durations weigh less than recent ones.
+ */
+class TimingHistogram {
+  public:
+    static constexpr unsigned int sub_bucket_bits = 3;
+    static constexpr unsigned int sub_buckets = 1 << sub_bucket_bits;
+
+    /**
+     * @brief Durations of 2^max_value_bits microseconds or more, which is longer than a
+     * control cycle, are counted in the last bucket. The maximum is still tracked exactly.
+     */
+    static constexpr unsigned int max_value_bits = 18;
+    static constexpr size_t num_buckets = (max_value_bits - sub_bucket_bits + 1) * sub_buckets;
+
+    TimingHistogram() : counts(), total(0), max_value(0) {}
+
+    /**
+     * @brief Add a duration to the histogram.
+     *
+     * @param us Duration in microseconds.
+     */
+    void record(unsigned int us) {
+        const size_t b = bucket(us);
+        if (counts[b] == UINT16_MAX) halve();
+        counts[b]++;
+        total++;
+        if (us > max_value) max_value = us;
+    }
+
+    /**
+     * @brief Number of durations recorded, less those halved away when a bucket fills.
+     */
+    unsigned int count() const { return total; }
+
+    /**
+     * @brief Largest duration recorded, or zero if none have been.
+     */
+    unsigned int max() const { return max_value; }
+
+    /**
+     * @brief Get a percentile of the recorded durations.
+     *
+     * @param pct Percentile, from 0 to 100.
+     * @return The upper end of the bucket containing the percentile, which is at most
+     * max(), or max() if the percentile is in the last bucket, or zero if no durations
+     * have been recorded.
+     */
+    unsigned int percentile(unsigned int pct) const {
+        unsigned int value;
+        percentiles(&pct, &value, 1);
+        return value;
+    }
+
+    /**
+     * @brief Get several percentiles with a single scan of the buckets.
+     *
+     * @param pcts   Percentiles, from 0 to 100, in increasing order.
+     * @param values Receives each percentile, as it would be returned by percentile().
+     * @param n      Number of percentiles.
+     */
+    void percentiles(const unsigned int* pcts, unsigned int* values, size_t n) const {
+        size_t j = 0;
+        if (total > 0) {
+            unsigned long long seen = 0;
+            for (size_t i = 0; i < num_buckets - 1 && j < n; i++) {
+                seen += counts[i];
+                if (seen == 0) continue;
+                const unsigned int upper = bucket_upper_bound(i);
+                // Compare against the smallest number of durations that are at most
+                // each percentile, rounded up
+                for (; j < n && seen * 100 >= static_cast<unsigned long long>(total) * pcts[j]; j++)
+                    values[j] = upper < max_value ? upper : max_value;
+            }
+        }
+        for (; j < n; j++) values[j] = max_value;
+    }
+
+    /**
+     * @brief Index of the bucket that counts a duration.
+     */
+    static size_t bucket(unsigned int us) {
+        if (us >= (1u << max_value_bits)) us = (1u << max_value_bits) - 1;
+        if (us < sub_buckets) return us;
+        const unsigned int msb = 31 - __builtin_clz(us);
+        return ((msb - sub_bucket_bits + 1) << sub_bucket_bits)
+            + ((us >> (msb - sub_bucket_bits)) & (sub_buckets - 1));
+    }
+
+    /**
+     * @brief Largest duration counted by a bucket.
+     */
+    static unsigned int bucket_upper_bound(size_t i) {
+        if (i < sub_buckets) return i;
+        const unsigned int shift = (i >> sub_bucket_bits) - 1;
+        const unsigned int lower = (sub_buckets + (i & (sub_buckets - 1))) << shift;
+        return lower + (1u << shift) - 1;
+    }
+
+  private:
+    /**
+     * @brief Halve every bucket's count.
+     */
+    void halve() {
+        total = 0;
+        for (uint16_t& c : counts) {
+            c /= 2;
+            total += c;
+        }
+    }
+
+    std::array<uint16_t, num_buckets> counts;
+    unsigned int total;
+    unsigned int max_value;
+};
+
+#endif
@@ -1,6 +1,6 @@
 #include "UplinkCommon.h"
 
-Uplink::Uplink(StateFieldRegistry& r) : registry(r), index_size(0)
+Uplink::Uplink(StateFieldRegistry& r) : registry(r), index_size(0), num_staged_updates(0)
 {
 }
 
@@ -9,30 +9,46 @@ void Uplink::init_uplink()
     // calculate the maximum number of bits needed to represent the indices
     // target variable is index_size
     for (index_size = 1; (registry.writable_fields.size() + 1) / (1 << index_size) > 0; ++index_size){}
+
+    // Allocate the scratch space for staging requests up front
+    staged_updates.resize(registry.writable_fields.size());
+    is_field_updated.resize(registry.writable_fields.size());
+    num_staged_updates = 0;
 }
 
 bool Uplink::_validate_packet(bitstream& bs)
 {
-    // Start validation at beginning of bs
+    return _stage_packet(bs);
+}
+
+void Uplink::_update_fields(bitstream& bs)
+{
+    if (_stage_packet(bs))
+        _apply_staged_updates(bs);
+}
+
+bool Uplink::_stage_packet(bitstream& bs)
+{
+    // Start decoding at beginning of bs
     bs.reset();
+    num_staged_updates = 0;
     size_t packet_bytes = bs.max_len;
-    size_t field_index = 0, field_len = 0, bits_checked = 0, bits_consumed = 0;
-    // Keep a bit map to prevent updating the same field twice
-    static std::vector<bool> is_field_updated(registry.writable_fields.size(), 0);
-    // Clear the bit map
-    for (size_t i = 0; i < registry.writable_fields.size(); ++i)
+    size_t field_len = 0, bits_checked = 0, bits_consumed = 0;
+    // Clear the bit map that prevents updating the same field twice
+    for (size_t i = 0; i < is_field_updated.size(); ++i)
         is_field_updated[i] = 0;
     while (bits_checked < 8*packet_bytes)
     {
         // Get index from bitstream
-        bits_consumed = bs.nextN(index_size, reinterpret_cast<uint8_t*>(&field_index));
+        uint64_t field_index = 0;
+        bits_consumed = bs.nextN(index_size, field_index);
 
         if (field_index == 0) // reached end of the packet
             break;
         --field_index;
         // Check if index is within writable_fields and get its length if it is      
         field_len = get_field_length(field_index);
-        if (field_len == 0) 
+        if (field_len == 0 || field_index >= staged_updates.size()) 
             return false;
         // If we have already seen this field or if the number of bits consumed
         // to get the next index is not index_size
@@ -41,6 +57,10 @@ bool Uplink::_validate_packet(bitstream& bs)
 
         bits_checked += bits_consumed;
         is_field_updated[field_index] = true;
+
+        // Stage the request. Its value is read from the packet once the whole
+        // packet has been validated.
+        staged_updates[num_staged_updates++] = {static_cast<size_t>(field_index), bits_checked};
         
         bits_consumed = bs.seekG(field_len, bs_end);
         // Return in this case because indicates that packet is not aligned since
@@ -60,35 +80,22 @@ bool Uplink::_validate_packet(bitstream& bs)
     return (u8 != 0 || bits_consumed > 7) ? false : true;
 }
 
-void Uplink::_update_fields(bitstream& bs)
+void Uplink::_apply_staged_updates(bitstream& bs)
 {
-    size_t packet_size = bs.max_len*8;
-    size_t field_index = 0, field_len = 0, bits_consumed = 0;
-    // Start updates at beginning of bs
-    bs.reset();
-    while (bits_consumed < packet_size)
+    for (size_t i = 0; i < num_staged_updates; ++i)
     {
-        // Get index from the bitstream
-        bits_consumed += bs.nextN(index_size, reinterpret_cast<uint8_t*>(&field_index));
-        if (field_index == 0) // reached end of the packet
-            return;
-        --field_index;
-
-        // Get field length from the index
-        field_len = get_field_length(field_index);
-        auto field_p = registry.writable_fields[field_index];
-        const std::vector<bool>& _bit_arr = field_p->get_bit_array();
-        std::vector<bool>& field_bit_arr = const_cast<std::vector<bool>&>(_bit_arr);
-        
-        // Clear field's bit array
-        for (size_t i = 0; i < field_len; ++i)
-          field_bit_arr[i] = 0;
+        const FieldUpdate& update = staged_updates[i];
+        auto field_p = registry.writable_fields[update.field_index];
 
-        // Dump into bit_array
-        bits_consumed += bs.nextN(field_len, field_bit_arr);
+        // Read the new value straight into a bit array of the field's length
+        bit_array field_bit_arr(get_field_length(update.field_index));
+        bs.reset();
+        bs.seekG(update.value_offset, bs_end);
+        bs.nextN(field_bit_arr.size(), field_bit_arr);
         field_p->set_bit_array(field_bit_arr);
         field_p->deserialize();
     }
+    num_staged_updates = 0;
 }
 
 size_t Uplink::get_field_length(size_t field_index)
@@ -2,6 +2,7 @@
 #pragma once
 #include <common/bitstream.h>
 #include <common/StateFieldRegistry.hpp>
+#include <vector>
 
 /**
  * Uplink provides operations on an Uplink Packet and is stateless
@@ -33,6 +34,16 @@ class Uplink {
    */
   size_t index_size;
 
+  /**
+   * @brief A request that has been decoded from a packet but not yet applied: the
+   * index of a field in registry.writable_fields, and the bit offset of the field's
+   * new value within the packet
+   */
+  struct FieldUpdate {
+    size_t field_index;
+    size_t value_offset;
+  };
+
 #ifndef DEBUG
   protected:
 #endif
@@ -42,9 +53,36 @@ class Uplink {
   bool _validate_packet(bitstream& bs); 
 
   /**
-   * Updates the fields of the registry with the uplink packet described by bs
+   * Updates the fields of the registry with the uplink packet described by bs,
+   * if the packet is valid
    * This function is here in order to sync producer and consumer
    */
   void _update_fields(bitstream& bs);
 
+  /**
+   * Decodes every request in the packet in a single pass, and stages the requests
+   * so that they can be applied with _apply_staged_updates()
+   * @return true if the whole packet is valid, in which case all of its requests
+   * are staged
+   */
+  bool _stage_packet(bitstream& bs);
+
+  /**
+   * Applies the requests staged by the last call to _stage_packet(), reading the
+   * new values from the same packet
+   */
+  void _apply_staged_updates(bitstream& bs);
+
+  /**
+   * @brief Requests staged by _stage_packet(). Sized by init_uplink() to hold a
+   * request for every writable field, since no field may be updated twice
+   */
+  std::vector<FieldUpdate> staged_updates;
+  size_t num_staged_updates;
+
+  /**
+   * @brief Bit map of the fields that have a request in the packet being staged
+   */
+  std::vector<bool> is_field_updated;
+
 };
\ No newline at end of file
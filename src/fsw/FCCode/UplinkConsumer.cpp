@@ -1,11 +1,12 @@
 #include "UplinkConsumer.h"
 #include <common/bitstream.h>
+#include <field_manifest.hpp>
 
 UplinkConsumer::UplinkConsumer(StateFieldRegistry& _registry, unsigned int offset) :
     TimedControlTask<void>(_registry, "uplink_ct", offset), Uplink(_registry)
 {
-    radio_mt_packet_len_fp = find_internal_field<size_t>("uplink.len", __FILE__, __LINE__);
-    radio_mt_packet_fp = find_internal_field<char*>("uplink.ptr", __FILE__, __LINE__);
+    radio_mt_packet_len_fp = find_field(PAN::fields::uplink_len);
+    radio_mt_packet_fp = find_field(PAN::fields::uplink_ptr);
 }
 
 void UplinkConsumer::execute()
@@ -16,8 +17,11 @@ void UplinkConsumer::execute()
     if ( !radio_mt_packet_len_fp->get() || !radio_mt_packet_fp->get())
         return;
     
-    if (validate_packet())
-        update_fields();
+    // Decode the packet in one pass, and apply its requests only if the whole
+    // packet is valid
+    bitstream bs (radio_mt_packet_fp->get(), radio_mt_packet_len_fp->get());
+    if (_stage_packet(bs))
+        _apply_staged_updates(bs);
 
     // clear len always
     radio_mt_packet_len_fp->set(0);
@@ -55,7 +55,9 @@ class UplinkConsumer : public TimedControlTask<void>, public Uplink {
      * uplink. If a new uplink has been received, UplinkConsumer expects the
      * contents of the uplink packet to be in the buffer pointed to by radio_mt_packet_f. 
      * UplinkConsumer will then check the packet, update the fields in the registry,
-     * and reset radio_mt_packet_len_f.
+     * and reset radio_mt_packet_len_f. The packet is decoded in a single pass that
+     * stages its requests, and the requests are applied only if the whole packet
+     * is valid.
      */
     void execute() override;
 #ifndef DEBUG
@@ -65,8 +67,8 @@ class UplinkConsumer : public TimedControlTask<void>, public Uplink {
 #endif
 
     /**
-     * @brief Applies all the updates specified by mt packet to writable fields
-     * @param packet_size the number of bits in the packet excluding padding
+     * @brief Applies all the updates specified by mt packet to writable fields,
+     * if the packet is valid
      */
     void update_fields();
 
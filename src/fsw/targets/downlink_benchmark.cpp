@@ -0,0 +1,112 @@
+/**
+ * @brief Microbenchmark for packing downlink snapshots.
+ *
+ * Compares the word-level bit_writer used by the DownlinkProducer against the
+ * previous implementation, which wrote every telemetry bit with bit_array::to_string().
+ * The benchmark frame contains every readable field in the flight registry, which is an
+ * upper bound on the size of any flow set that flight can send.
+ */
+
+#include <fsw/FCCode/MainControlLoop.hpp>
+#include <common/bit_writer.hpp>
+#include <flow_data.hpp>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifndef UNIT_TEST
+
+static constexpr size_t num_iterations = 10000;
+
+/**
+ * @brief Snapshot packing as it was done before bit_writer, with one modify_bit()
+ * call per telemetry bit. Packet headers are written at the packet boundary so that
+ * the output can be compared against bit_writer's.
+ */
+static void legacy_add_bits(const bit_array& field_bits, char* snapshot_ptr,
+                            size_t& packet_offset, size_t& downlink_frame_offset)
+{
+    const size_t field_size = field_bits.size();
+    const int field_overflow = (field_size + packet_offset)
+        - DownlinkProducer::num_bits_in_packet;
+
+    if(field_overflow <= 0) {
+        field_bits.to_string(snapshot_ptr, downlink_frame_offset);
+        downlink_frame_offset += field_size;
+        packet_offset += field_size;
+    }
+    else {
+        const int x = field_size - field_overflow;
+        field_bits.to_string(snapshot_ptr, downlink_frame_offset, 0, x);
+        downlink_frame_offset += x;
+        packet_offset = 0;
+
+        char& packet_start = snapshot_ptr[(downlink_frame_offset / 8)];
+        packet_start = bit_array::modify_bit(packet_start, 7 - downlink_frame_offset % 8, 0);
+        downlink_frame_offset += 1;
+        packet_offset += 1;
+
+        field_bits.to_string(snapshot_ptr, downlink_frame_offset, x, field_size);
+        downlink_frame_offset += field_overflow;
+        packet_offset += field_overflow;
+    }
+}
+
+static size_t legacy_pack(const std::vector<const bit_array*>& fields, char* snapshot_ptr) {
+    size_t downlink_frame_offset = 1;
+    size_t packet_offset = 1;
+    snapshot_ptr[0] = bit_array::modify_bit(snapshot_ptr[0], 7, 1);
+    for (const bit_array* field_bits : fields)
+        legacy_add_bits(*field_bits, snapshot_ptr, packet_offset, downlink_frame_offset);
+    for (int i = 7 - downlink_frame_offset % 8; i >= 0; i--) {
+        char& last_char = snapshot_ptr[(downlink_frame_offset / 8)];
+        last_char = bit_array::modify_bit(last_char, i, 0);
+    }
+    return (downlink_frame_offset + 7) / 8;
+}
+
+static size_t bit_writer_pack(const std::vector<const bit_array*>& fields, char* snapshot_ptr) {
+    bit_writer frame(snapshot_ptr, DownlinkProducer::num_bits_in_packet);
+    for (const bit_array* field_bits : fields) frame.write(*field_bits);
+    return frame.flush();
+}
+
+template<typename F>
+static double time_per_frame_us(F pack) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_iterations; i++) pack();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / num_iterations;
+}
+
+int main() {
+    StateFieldRegistry registry;
+    MainControlLoop fcp(registry, PAN::flow_data);
+
+    std::vector<const bit_array*> fields;
+    size_t num_bits = 0;
+    for (ReadableStateFieldBase* field : registry.readable_fields) {
+        field->serialize();
+        fields.push_back(&field->get_bit_array());
+        num_bits += field->bitsize();
+    }
+
+    std::vector<char> legacy_frame(num_bits / 8 + num_bits / DownlinkProducer::num_bits_in_packet + 2);
+    std::vector<char> new_frame(legacy_frame.size());
+    const size_t frame_size = bit_writer_pack(fields, new_frame.data());
+    legacy_pack(fields, legacy_frame.data());
+
+    const double legacy_us = time_per_frame_us([&] { legacy_pack(fields, legacy_frame.data()); });
+    const double new_us = time_per_frame_us([&] { bit_writer_pack(fields, new_frame.data()); });
+
+    std::cout << "Fields: " << fields.size() << ", frame size: " << frame_size << " bytes" << std::endl;
+    std::cout << "Frames match: "
+              << (memcmp(legacy_frame.data(), new_frame.data(), frame_size) == 0 ? "yes" : "no")
+              << std::endl;
+    std::cout << "to_string() packing: " << legacy_us << " us/frame" << std::endl;
+    std::cout << "bit_writer packing:  " << new_us << " us/frame" << std::endl;
+    std::cout << "Speedup: " << legacy_us / new_us << "x" << std::endl;
+    return 0;
+}
+
+#endif
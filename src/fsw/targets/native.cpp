@@ -1,14 +1,73 @@
 #include <fsw/FCCode/MainControlLoop.hpp>
 #include <common/StateFieldRegistry.hpp>
 #include "flow_data.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
+/**
+ * Runs flight software on a desktop computer, for use with the simulation:
+ *
+ *     program [--virtual-clock] [--trace <file>]
+ *
+ * With --virtual-clock, the flight software runs on a virtual clock that only moves
+ * forward when the software waits, so control cycles take no real time. See
+ * TimedControlTaskBase::use_virtual_clock().
+ *
+ * With --trace, the cycle trace is written to the given file instead of
+ * cycle_trace.bin when timing.trace.dump is set. See CycleTrace.
+ *
+ * With --calibrate <cycles> <header>, offsets for the timed control tasks are computed
+ * from the tasks' execution times over the given number of control cycles, which must be
+ * at least TimedControlTaskBase::timing_publish_period, and written to the given header,
+ * which can then be built in with -D CALIBRATED_OFFSETS='"<header>"'. The measurement
+ * starts after calibration_warmup_cycles, so that the slower first cycles are left out.
+ * The flight software keeps running afterwards. See TaskSchedule. Execution times can't
+ * be measured on the virtual clock.
+ *
+ * With --memory-report <file>, a report of the memory used by each state field and
+ * control task is written to the given CSV file, and the program exits without running
+ * the flight software. See MemoryReport.
+ */
 #ifndef UNIT_TEST
-int main() {
+static constexpr unsigned int calibration_warmup_cycles = TimedControlTaskBase::timing_publish_period;
+
+int main(int argc, char* argv[]) {
+    unsigned int calibration_cycles = 0;
+    const char* calibration_header = nullptr;
+    const char* memory_report_path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--virtual-clock") == 0)
+            TimedControlTaskBase::use_virtual_clock(true);
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            CycleTrace::dump_path = argv[++i];
+        else if (std::strcmp(argv[i], "--calibrate") == 0 && i + 2 < argc) {
+            calibration_cycles = std::strtoul(argv[++i], nullptr, 10);
+            calibration_header = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--memory-report") == 0 && i + 1 < argc)
+            memory_report_path = argv[++i];
+    }
+
+    if (calibration_header && calibration_cycles < TimedControlTaskBase::timing_publish_period) {
+        std::fprintf(stderr, "--calibrate needs at least %u cycles.\n",
+            TimedControlTaskBase::timing_publish_period);
+        return 1;
+    }
+
     StateFieldRegistry registry;
     MainControlLoop fcp(registry, PAN::flow_data);
 
-    while (true) {
+    if (memory_report_path)
+        return fcp.get_memory_report().write(memory_report_path) ? 0 : 1;
+
+    for (unsigned int cycle = 1; ; cycle++) {
         fcp.execute();
+        if (!calibration_header) continue;
+        if (cycle == calibration_warmup_cycles)
+            fcp.get_task_schedule().start_calibration();
+        else if (cycle == calibration_warmup_cycles + calibration_cycles)
+            fcp.get_task_schedule().write_header(calibration_header, calibration_cycles);
     }
     return 0;
 }
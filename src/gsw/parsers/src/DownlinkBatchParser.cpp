@@ -0,0 +1,145 @@
+#include "DownlinkBatchParser.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Parser and state field registry that belong to one worker thread.
+ */
+struct DownlinkBatchParser::Worker {
+    StateFieldRegistry registry;
+    DownlinkParser parser;
+
+    Worker(const std::vector<DownlinkProducer::FlowData>& flow_data) :
+        registry(),
+        parser(registry, flow_data) {}
+};
+
+DownlinkBatchParser::DownlinkBatchParser(
+    const std::vector<DownlinkProducer::FlowData>& flow_data, size_t num_threads)
+{
+    const bool has_delta_flows = std::any_of(flow_data.begin(), flow_data.end(),
+        [](const DownlinkProducer::FlowData& flow) { return flow.keyframe_period > 0; });
+    if (has_delta_flows || num_threads == 0) num_threads = 1;
+
+    // Workers are constructed up front, on this thread, since constructing flight
+    // software isn't thread-safe.
+    for (size_t i = 0; i < num_threads; i++)
+        workers.push_back(std::make_unique<Worker>(flow_data));
+}
+
+DownlinkBatchParser::~DownlinkBatchParser() {}
+
+static bool read_file(const std::string& path, std::vector<char>& contents) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) return false;
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool DownlinkBatchParser::read_packets(const std::string& path,
+    std::vector<std::vector<char>>& packets)
+{
+    struct stat path_stat;
+    if (stat(path.c_str(), &path_stat) != 0) return false;
+
+    if (S_ISDIR(path_stat.st_mode)) {
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return false;
+        std::vector<std::string> filenames;
+        for (dirent* entry = readdir(dir); entry; entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') filenames.push_back(path + "/" + entry->d_name);
+        }
+        closedir(dir);
+        std::sort(filenames.begin(), filenames.end());
+
+        for (const std::string& filename : filenames) {
+            struct stat file_stat;
+            if (stat(filename.c_str(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) continue;
+            std::vector<char> packet;
+            if (!read_file(filename, packet)) return false;
+            if (!packet.empty()) packets.push_back(std::move(packet));
+        }
+        return true;
+    }
+
+    // Split a concatenated archive into packets. The last packet may be short.
+    std::vector<char> archive;
+    if (!read_file(path, archive)) return false;
+    constexpr size_t packet_size = DownlinkProducer::num_bits_in_packet / 8;
+    for (size_t i = 0; i < archive.size(); i += packet_size) {
+        packets.emplace_back(archive.begin() + i,
+            archive.begin() + std::min(i + packet_size, archive.size()));
+    }
+    return true;
+}
+
+std::vector<std::vector<char>> DownlinkBatchParser::group_frames(
+    const std::vector<std::vector<char>>& packets)
+{
+    std::vector<std::vector<char>> frames;
+    for (const std::vector<char>& packet : packets) {
+        // An empty packet has no bits, so it can't start or add to a frame.
+        if (packet.empty()) continue;
+        const bool is_first_packet_in_frame = (static_cast<unsigned char>(packet[0]) >> 7) == 0b1;
+        if (is_first_packet_in_frame || frames.empty()) frames.emplace_back();
+        frames.back().insert(frames.back().end(), packet.begin(), packet.end());
+    }
+    return frames;
+}
+
+size_t DownlinkBatchParser::process_frames(const std::vector<std::vector<char>>& frames,
+    std::ostream& out)
+{
+    const size_t batch_size = frames_per_worker * workers.size();
+    std::vector<std::string> results(std::min(batch_size, frames.size()));
+
+    for (size_t batch_start = 0; batch_start < frames.size(); batch_start += batch_size) {
+        const size_t batch_end = std::min(batch_start + batch_size, frames.size());
+
+        // Workers take the next unparsed frame of the batch until none are left.
+        std::atomic<size_t> next_frame(batch_start);
+        auto work = [&](Worker& worker) {
+            for (size_t i = next_frame++; i < batch_end; i = next_frame++)
+                results[i - batch_start] = worker.parser.process_downlink_frame(frames[i]);
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < workers.size(); i++)
+            threads.emplace_back(work, std::ref(*workers[i]));
+        work(*workers[0]);
+        for (std::thread& thread : threads) thread.join();
+
+        for (size_t i = 0; i < batch_end - batch_start; i++) out << results[i] << '\n';
+    }
+
+    return frames.size();
+}
+
+size_t DownlinkBatchParser::process_frames(const std::vector<std::vector<char>>& frames,
+    DownlinkParser::FrameSink& sink)
+{
+    for (const std::vector<char>& frame : frames)
+        workers[0]->parser.process_downlink_frame(frame, sink);
+    return frames.size();
+}
+
+bool DownlinkBatchParser::process_archive(const std::string& path, std::ostream& out) {
+    std::vector<std::vector<char>> packets;
+    if (!read_packets(path, packets)) return false;
+    process_frames(group_frames(packets), out);
+    return true;
+}
+
+bool DownlinkBatchParser::process_archive(const std::string& path,
+    DownlinkParser::FrameSink& sink)
+{
+    std::vector<std::vector<char>> packets;
+    if (!read_packets(path, packets)) return false;
+    process_frames(group_frames(packets), sink);
+    return true;
+}
@@ -0,0 +1,97 @@
+#ifndef GROUND_DOWNLINK_BATCH_PARSER_HPP_
+#define GROUND_DOWNLINK_BATCH_PARSER_HPP_
+
+#include "DownlinkParser.hpp"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Parses an archive of downlink packets, such as the MO messages received over
+ * a mission, into newline-delimited JSON, with one line per downlink frame.
+ *
+ * Frames are decoded on worker threads. Each worker has its own DownlinkParser and
+ * state field registry, since parsing a frame writes to the fields in the registry.
+ * Frames are handed out in batches, and the results of each batch are written in the
+ * order of the frames, so the output is the same as that of a single parser.
+ *
+ * A delta flow can only be rebuilt from the frames that came before it, so if any flow
+ * is a delta flow, all frames are parsed on one thread.
+ */
+class DownlinkBatchParser {
+  public:
+    /**
+     * @brief Construct a new batch parser.
+     *
+     * @param flow_data   Flows that the archive was produced with.
+     * @param num_threads Number of worker threads. Must be at least one.
+     */
+    DownlinkBatchParser(const std::vector<DownlinkProducer::FlowData>& flow_data,
+        size_t num_threads);
+
+    ~DownlinkBatchParser();
+
+    /**
+     * @brief Read the downlink packets in an archive. The archive is either a directory
+     * that contains one packet per file, which are read in order of file name, or a file
+     * of packets that were concatenated in the order they were received.
+     *
+     * @param path    Path of the directory or file.
+     * @param packets Packets that were read.
+     * @return False if the archive doesn't exist or can't be read.
+     */
+    static bool read_packets(const std::string& path, std::vector<std::vector<char>>& packets);
+
+    /**
+     * @brief Group packets into frames. A frame starts at every packet whose first bit
+     * is a 1. Unlike DownlinkParser, which waits for the start of the next frame, the
+     * last frame is considered complete at the end of the packets. Empty packets are
+     * skipped.
+     */
+    static std::vector<std::vector<char>> group_frames(
+        const std::vector<std::vector<char>>& packets);
+
+    /**
+     * @brief Parse frames and write their data to a stream, one JSON object per line,
+     * in the order of the frames.
+     *
+     * @return Number of frames that were parsed.
+     */
+    size_t process_frames(const std::vector<std::vector<char>>& frames, std::ostream& out);
+
+    /**
+     * @brief Parse frames into a sink, such as a TelemetryArchiveWriter. Since a sink
+     * receives the data of each frame as it's decoded, frames are parsed in order on
+     * one thread.
+     *
+     * @return Number of frames that were parsed.
+     */
+    size_t process_frames(const std::vector<std::vector<char>>& frames,
+        DownlinkParser::FrameSink& sink);
+
+    /**
+     * @brief Parse every frame in an archive. See read_packets() for the formats of
+     * archives, and process_frames() for the output.
+     *
+     * @return False if the archive doesn't exist or can't be read.
+     */
+    bool process_archive(const std::string& path, std::ostream& out);
+    bool process_archive(const std::string& path, DownlinkParser::FrameSink& sink);
+
+    /**
+     * @brief Number of worker threads that frames are parsed on.
+     */
+    size_t num_threads() const { return workers.size(); }
+
+    /**
+     * @brief Number of frames that are handed out to each worker per batch.
+     */
+    static constexpr size_t frames_per_worker = 256;
+
+  private:
+    struct Worker;
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+#endif
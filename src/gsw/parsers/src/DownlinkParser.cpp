@@ -1,5 +1,6 @@
 #include "DownlinkParser.hpp"
 #include <common/Serializer.hpp>
+#include <common/bit_reader.hpp>
 #include <vector>
 #include <fstream>
 #include <json.hpp>
@@ -20,10 +21,6 @@ std::string DownlinkParser::process_downlink_file(const std::string& filename) {
 }
 
 std::string DownlinkParser::process_downlink_packet(const std::vector<char>& packet) {
-    // The returned JSON object.
-    using json = nlohmann::json;
-    json ret;
-
     // If the first bit of the packet is a 1, it's the start of a new frame.
     // Otherwise the packet belongs to a previous frame.
     const bool is_first_packet_in_frame = (static_cast<unsigned char>(packet[0]) >> 7) == 0b1;
@@ -32,162 +29,254 @@ std::string DownlinkParser::process_downlink_packet(const std::vector<char>& pac
         // packet to the downlink frame that's currently being
         // collected
         most_recent_frame.insert(most_recent_frame.end(), packet.begin(), packet.end());
+        return nlohmann::json().dump();
     }
-    else {
-        // The packet is the start of a new downlink frame.
-        // Process the most recently collected frame.
-        const std::vector<char> frame_to_process = most_recent_frame;
-        most_recent_frame = packet;
+
+    // The packet is the start of a new downlink frame.
+    // Process the most recently collected frame.
+    std::vector<char> frame_to_process;
+    frame_to_process.swap(most_recent_frame);
+    most_recent_frame = packet;
+    return process_downlink_frame(frame_to_process);
+}
+
+/**
+ * @brief Collects the data in a downlink frame into the JSON object that is
+ * returned by DownlinkParser::process_downlink_frame().
+ *
+ * Field information is stored like so:
+ * "data": {
+ *      "event_name": {
+ *          "control_cycle_number": event control cycle number,
+ *          "field_data": {
+ *              "field1_name": field1 value,
+ *              "field2_name": field2 value,
+ *              "field3_name": field3 value
+ *          }
+ *      },
+ *      "readable_field_name": readable field value
+ * }
+ */
+class JsonFrameSink : public DownlinkParser::FrameSink {
+  public:
+    using json = nlohmann::json;
+    json ret;
+
+    JsonFrameSink() {
         ret["metadata"]["error"] = false;
         ret["metadata"]["flow_ids"] = json::array();
+    }
 
-        // Process the downlink frame in four steps.
+    void begin_frame(unsigned int cycle_no) override {
+        ret["data"]["pan.cycle_no"] = std::to_string(cycle_no);
+        ret["metadata"]["cycle_no"] = cycle_no;
+    }
 
-        // Step 1: Manage the downlink frame at a bit level.
-        std::vector<bool> frame_bits(frame_to_process.size() * 8);
-        for(size_t i = 0; i < frame_to_process.size(); i++) {
-            std::bitset<8> x(frame_to_process[i]);
-            for(int j = 0; j < 8; j++) {
-                frame_bits[i*8 + j] = x[7 - j];
-            }
+    void add_flow(unsigned char flow_id) override {
+        ret["metadata"]["flow_ids"].push_back(flow_id);
+    }
+
+    void add_field(ReadableStateFieldBase* field) override {
+        ret["data"][field->name()] = std::string(field->print());
+    }
+
+    void add_event(Event* event, const bit_array& bits) override {
+        // Store the original values of the control cycle count and data fields
+        unsigned int current_ccno = event->ccno->get();
+        std::vector<bit_array> field_bits_original;
+        for (ReadableStateFieldBase* data_field : event->_data_fields()) {
+            data_field->serialize();
+            field_bits_original.push_back(data_field->get_bit_array());
+        }
+
+        event->set_bit_array(bits);
+
+        event->deserialize();
+        unsigned int event_ccno = event->ccno->get();
+
+        ret["data"][event->name()]["control_cycle_number"] = event_ccno;
+        for (ReadableStateFieldBase* data_field: event->_data_fields()) {
+            ret["data"][event->name()]["field_data"][data_field->name()] = std::string(data_field->print());
+        }
+
+        // Reapply the original values to the control cycle count and data fields
+        event->ccno->set(current_ccno);
+        for (size_t j = 0; j < field_bits_original.size(); j++) {
+            ReadableStateFieldBase* data_field = event->_data_fields()[j];
+            data_field->set_bit_array(field_bits_original[j]);
+            data_field->deserialize();
+        }
+    }
+
+    void end_frame(const std::string& error) override {
+        if (!error.empty()) ret["metadata"]["error"] = error;
+    }
+};
+
+std::string DownlinkParser::process_downlink_frame(const std::vector<char>& frame) {
+    JsonFrameSink sink;
+    process_downlink_frame(frame, sink);
+    return sink.ret.dump();
+}
+
+void DownlinkParser::process_downlink_frame(const std::vector<char>& frame, FrameSink& sink) {
+    const std::string error = decode_downlink_frame(frame, sink);
+    sink.end_frame(error);
+}
+
+std::string DownlinkParser::decode_downlink_frame(const std::vector<char>& frame_to_process,
+    FrameSink& sink)
+{
+    std::string error;
+
+    // Process the downlink frame in three steps.
+
+    // Step 1: Read the downlink frame with a cursor that skips the header
+    // bit at the start of each packet.
+    bit_reader frame(frame_to_process.data(), frame_to_process.size(),
+        DownlinkProducer::num_bits_in_packet);
+
+    // Step 2: Process control cycle count
+    Serializer<unsigned int> cycle_count_sr;
+    if (frame.remaining() < cycle_count_sr.bitsize()) return "cycle count incomplete";
+    unsigned int cycle_count;
+    bit_array cycle_count_bits(cycle_count_sr.bitsize());
+    frame.read(cycle_count_bits);
+    cycle_count_sr.set_bit_array(cycle_count_bits);
+    cycle_count_sr.deserialize(&cycle_count);
+    sink.begin_frame(cycle_count);
+
+    // Step 3: Process flows by ID. If, at any point, the expected
+    // size of a field exceeds the number of bits available in the
+    // downlink, then stop processing.
+    Serializer<unsigned char> flow_id_sr(flow_data.size());
+    bit_array flow_id_bits(flow_id_sr.bitsize());
+    std::vector<bool> found_flow_ids(flow_data.size() + 1, false);
+    while(frame.remaining() > 0) {
+        // Step 3.1. Get flow ID and check if it's valid.
+        unsigned char flow_id;
+
+        if (flow_id_sr.bitsize() > frame.remaining()) {
+            // The frame doesn't contain the full flow ID. Stop processing.
+            return "flow ID incomplete";
+        }
+        frame.read(flow_id_bits);
+        flow_id_sr.set_bit_array(flow_id_bits);
+        flow_id_sr.deserialize(&flow_id);
+        
+        if (flow_id == 0) {
+            // We've reached the end of the downlink packet, since no flow
+            // with ID 0 can exist.
+            return error;
         }
 
-        // Step 2: Remove header bits from the packet.
-        for(int i = frame_bits.size() / DownlinkProducer::num_bits_in_packet; i >= 0; i--) {
-            frame_bits.erase(frame_bits.begin() + i * DownlinkProducer::num_bits_in_packet);
+        // The flow ID serializer can produce IDs up to the next power of two, which
+        // may be past the last flow.
+        if (flow_id > flow_data.size()) {
+            return "flow ID invalid: " + std::to_string(flow_id);
         }
 
-        // Step 3: Process control cycle count
-        unsigned int cycle_count;
-        Serializer<unsigned int> cycle_count_sr;
-        const std::vector<bool> cycle_count_bits(frame_bits.begin(), frame_bits.begin() + 32);
-        cycle_count_sr.set_bit_array(cycle_count_bits);
-        cycle_count_sr.deserialize(&cycle_count);
-        ret["data"]["pan.cycle_no"] = std::to_string(cycle_count);
-        ret["metadata"]["cycle_no"] = cycle_count;
-        frame_bits.erase(frame_bits.begin(), frame_bits.begin() + 32);
-
-        // Step 4: Process flows by ID. If, at any point, the expected
-        // size of a field exceeds the number of bits available in the
-        // downlink, then stop processing.
-        //
-        // As flows are processed, their bits are removed from the frame.
-        while(frame_bits.size() > 0) {
-            // Step 4.1. Get flow ID and check if it's valid.
-            unsigned char flow_id;
-
-            Serializer<unsigned char> flow_id_sr(flow_data.size());
-            if (flow_id_sr.bitsize() > frame_bits.size()) {
-                // The frame doesn't contain the full flow ID. Stop processing.
-                ret["metadata"]["error"] = "flow ID incomplete";
-                return ret.dump();
+        // Check if flow has been repeated. This shouldn't be possible.
+        if (found_flow_ids[flow_id]) {
+            return "multiple flows of same ID found: " + std::to_string(flow_id);
+        }
+
+        // Continue processing the flow.
+        found_flow_ids[flow_id] = true;
+        sink.add_flow(flow_id);
+
+        // Step 3.1.1. Find flow in Downlink Producer flows list and check if
+        // it exists there.
+        const DownlinkProducer::Flow* flow = nullptr;
+        for(const DownlinkProducer::Flow& f : flow_data) {
+            unsigned char found_flow_id;
+            f.id_sr.deserialize(&found_flow_id);
+            if (flow_id == found_flow_id) {
+                flow = &f;
+                break;
             }
-            const std::vector<bool> flow_id_bits(frame_bits.begin(),
-                frame_bits.begin() + flow_id_sr.bitsize());
-            flow_id_sr.set_bit_array(flow_id_bits);
-            flow_id_sr.deserialize(&flow_id);
-            
-            if (flow_id == 0) {
-                // We've reached the end of the downlink packet, since no flow
-                // with ID 0 can exist.
-                return ret.dump();
+        }
+        if (!flow) {
+            // Flow ID wasn't found in the list of flows. Stop processing this downlink frame.
+            return "flow ID invalid: " + std::to_string(flow_id);
+        }
+
+        // Step 3.2. If the flow is a delta flow, read its keyframe bit, its sequence
+        // number and, for deltas, the bitmap of fields that are in the frame. The
+        // fields that aren't in the frame have the values that were last received for
+        // the flow.
+        const size_t num_fields = flow->field_list.size();
+        const bool is_delta_flow = flow->keyframe_period > 0;
+        bool is_keyframe = true;
+        unsigned int sequence = 0;
+        std::vector<bool> field_in_frame(num_fields, true);
+        if (is_delta_flow) {
+            if (frame.remaining() < 1 + DownlinkProducer::delta_sequence_bits)
+                return "delta header incomplete";
+            is_keyframe = frame.read_bit();
+            sequence = static_cast<unsigned int>(frame.read(DownlinkProducer::delta_sequence_bits));
+            if (!is_keyframe) {
+                if (frame.remaining() < num_fields) return "delta header incomplete";
+                for (size_t i = 0; i < num_fields; i++) field_in_frame[i] = frame.read_bit();
             }
+        }
 
-            // Check if flow has been repeated. This shouldn't be possible.
-            const std::vector<unsigned char> found_flow_ids = ret["metadata"]["flow_ids"];
-            if (std::find(found_flow_ids.begin(), found_flow_ids.end(), flow_id)
-                    != found_flow_ids.end())
+        std::vector<bit_array>* last_field_bits = nullptr;
+        std::vector<bit_array> flow_field_bits;
+        if (is_delta_flow) {
+            last_field_bits = &delta_flow_values[flow_id];
+            const unsigned int sequence_mask = (1U << DownlinkProducer::delta_sequence_bits) - 1;
+            if (!is_keyframe && !last_field_bits->empty()
+                && ((delta_flow_sequences[flow_id] + 1) & sequence_mask) != sequence)
             {
-                ret["metadata"]["error"] = "multiple flows of same ID found: " + std::to_string(flow_id);
-                return ret.dump();
+                // The delta is based on a snapshot that wasn't received, so the values
+                // that were last received can't fill in the missing fields.
+                error = "delta reference mismatch for flow ID: " + std::to_string(flow_id);
+                last_field_bits->clear();
+            }
+            else if (!is_keyframe && last_field_bits->empty()) {
+                // No keyframe has been received for this flow, so only the fields
+                // that are in the frame are known.
+                error = "no keyframe for flow ID: " + std::to_string(flow_id);
             }
+            flow_field_bits.resize(num_fields);
+        }
 
-            // Continue processing the flow.
-            ret["metadata"]["flow_ids"].push_back(flow_id);
-            frame_bits.erase(frame_bits.begin(), frame_bits.begin() + flow_id_bits.size());
-
-            // Step 4.1.1. Find flow in Downlink Producer flows list and check if
-            // it exists there.
-            const DownlinkProducer::Flow* flow = nullptr;
-            for(const DownlinkProducer::Flow& f : flow_data) {
-                unsigned char found_flow_id;
-                f.id_sr.deserialize(&found_flow_id);
-                if (flow_id == found_flow_id) {
-                    flow = &f;
-                    break;
+        // Step 3.3. Process the items in the flow, and pass them to the sink.
+        for(size_t i = 0; i < num_fields; i++) {
+            ReadableStateFieldBase* field = flow->field_list[i];
+            bit_array field_bits(field->get_bit_array().size());
+            if (field_in_frame[i]) {
+                if (field_bits.size() > frame.remaining()) {
+                    return "field incomplete: " + field->name();
                 }
+                frame.read(field_bits);
             }
-            if (!flow) {
-                // Flow ID wasn't found in the list of flows. Stop processing this downlink frame.
-                // If the flow ID is a zero, then the packet is over, so an error didn't occur.
-                if (flow_id != 0) ret["metadata"]["error"] = "flow ID invalid: " + std::to_string(flow_id);
-                return ret.dump();
+            else if (!last_field_bits->empty()) {
+                field_bits = (*last_field_bits)[i];
+            }
+            else continue;
+            if (is_delta_flow) {
+                flow_field_bits[i].resize(field_bits.size());
+                flow_field_bits[i] = field_bits;
             }
 
-            /**
-             * Step 4.2. Process the items in the flow, and add the items
-             * to the downlink data.
-             * Field information will be stored like so: 
-             * "data": {
-             *      "event_name": {
-             *          "control_cycle_number": event control cycle number,
-             *          "field_data": {
-             *              "field1_name": field1 value,
-             *              "field2_name": field2 value,
-             *              "field3_name": field3 value
-             *          }
-             *      },
-             *      "readable_field_name": readable field value
-             * }
-             */
-            for(ReadableStateFieldBase* field : flow->field_list) {
-                Event* event = registry.find_event(field->name());
-                if (event) {
-                    // Store the original values of the control cycle count and data fields
-                    unsigned int current_ccno = event->ccno->get();
-                    std::vector<bit_array> field_bits_original;
-                    for (ReadableStateFieldBase* data_field : event->_data_fields()) {
-                        data_field->serialize();
-                        field_bits_original.push_back(data_field->get_bit_array());
-                    }
-
-                    const std::vector<bool>::iterator event_end_it =
-                        frame_bits.begin() + event->get_bit_array().size();
-                    
-                    const std::vector<bool> event_bits(frame_bits.begin(), event_end_it);
-                    event->set_bit_array(event_bits);
-                    
-                    event->deserialize();
-                    unsigned int event_ccno = event->ccno->get();
-
-                    ret["data"][event->name()]["control_cycle_number"] = event_ccno;
-                    for (ReadableStateFieldBase* data_field: event->_data_fields()) {
-                        ret["data"][event->name()]["field_data"][data_field->name()] = std::string(data_field->print());
-                    }
-
-                    // Reapply the original values to the control cycle count and data fields
-                    event->ccno->set(current_ccno);
-                    for (size_t i = 0; i < field_bits_original.size(); i++) {
-                        ReadableStateFieldBase* field = event->_data_fields()[i];
-                        field->set_bit_array(field_bits_original[i]);
-                        field->deserialize();
-                    }
-                    frame_bits.erase(frame_bits.begin(), event_end_it);
-                }
-                else {
-                    const std::vector<bool>::iterator field_end_it =
-                        frame_bits.begin() + field->get_bit_array().size();
-
-                    const std::vector<bool> field_bits(frame_bits.begin(), field_end_it);
-                    field->set_bit_array(field_bits);
-                    field->deserialize();
-
-                    ret["data"][field->name()] = std::string(field->print());
-                    frame_bits.erase(frame_bits.begin(), field_end_it);
-                }
+            Event* event = registry.find_event(field->name());
+            if (event) {
+                sink.add_event(event, field_bits);
             }
+            else {
+                field->set_bit_array(field_bits);
+                field->deserialize();
+                sink.add_field(field);
+            }
+        }
+
+        if (is_delta_flow && (is_keyframe || !last_field_bits->empty())) {
+            *last_field_bits = std::move(flow_field_bits);
+            delta_flow_sequences[flow_id] = sequence;
         }
     }
 
-    return ret.dump();
+    return error;
 }
@@ -2,6 +2,7 @@
 #define GROUND_DOWNLINK_PARSER_HPP_
 
 #include <fsw/FCCode/MainControlLoop.hpp>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -29,6 +30,62 @@ class DownlinkParser {
      */
     std::string process_downlink_file(const std::string& filename);
 
+    /**
+     * @brief Process a complete downlink frame, made up of one or more downlink
+     * packets, and return its data in JSON format. See process_downlink_packet()'s
+     * documentation below for the format.
+     *
+     * @param frame Character buffer containing the downlink frame.
+     */
+    std::string process_downlink_frame(const std::vector<char>& frame);
+
+    /**
+     * @brief Receives the data in a downlink frame as the frame is decoded, so that
+     * the data can be stored in a format other than JSON.
+     */
+    class FrameSink {
+      public:
+        virtual ~FrameSink() {}
+
+        /**
+         * @brief Called at the start of a frame, once its control cycle count has
+         * been read. Not called if the frame is too short to contain a cycle count.
+         */
+        virtual void begin_frame(unsigned int cycle_no) = 0;
+
+        /**
+         * @brief Called for each flow in the frame, before the flow's fields.
+         */
+        virtual void add_flow(unsigned char flow_id) = 0;
+
+        /**
+         * @brief Called for each field in a flow, once the field's value has been
+         * deserialized into the field.
+         */
+        virtual void add_field(ReadableStateFieldBase* field) = 0;
+
+        /**
+         * @brief Called for each event in a flow, with the serialized event.
+         */
+        virtual void add_event(Event* event, const bit_array& bits) = 0;
+
+        /**
+         * @brief Called at the end of every frame.
+         *
+         * @param error Description of the error that stopped processing of the
+         * frame, or an empty string if there was no error.
+         */
+        virtual void end_frame(const std::string& error) = 0;
+    };
+
+    /**
+     * @brief Process a complete downlink frame and pass its data to a sink.
+     *
+     * @param frame Character buffer containing the downlink frame.
+     * @param sink  Sink that receives the data in the frame.
+     */
+    void process_downlink_frame(const std::vector<char>& frame, FrameSink& sink);
+
   protected:
     /**
      * @brief Initialize flight software in order to get downlink flows.
@@ -54,6 +111,9 @@ class DownlinkParser {
      * completed downlink frame, in JSON format. Otherwise, an empty JSON
      * string is returned.
      * 
+     * Delta flows are rebuilt into full flows, using the values that were last
+     * received for the fields that didn't change.
+     *
      * @param packet Character buffer containing the downlink packet.
      * 
      * @return JSON-encoded downlink data, containing two high-level keys:
@@ -65,11 +125,32 @@ class DownlinkParser {
      */
     std::string process_downlink_packet(const std::vector<char>& packet);
 
+    /**
+     * @brief Decode a downlink frame into a sink, without ending the frame.
+     *
+     * @return Description of the error that stopped processing of the frame, or an
+     * empty string if there was no error.
+     */
+    std::string decode_downlink_frame(const std::vector<char>& frame, FrameSink& sink);
+
     /**
      * @brief The most recent downlink frame that is yet incomplete and/or
      * unprocessed.
      */
     std::vector<char> most_recent_frame;
+
+    /**
+     * @brief Bits of each field of each delta flow, as of the last frame that
+     * contained the flow, indexed by flow ID. A flow has no entry until a keyframe
+     * of the flow is received.
+     */
+    std::map<unsigned char, std::vector<bit_array>> delta_flow_values;
+
+    /**
+     * @brief Sequence number of the frame that delta_flow_values was last updated from,
+     * indexed by flow ID.
+     */
+    std::map<unsigned char, unsigned int> delta_flow_sequences;
 };
 
 #endif
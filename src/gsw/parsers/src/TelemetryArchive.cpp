@@ -0,0 +1,349 @@
+#include "TelemetryArchive.hpp"
+#include <common/GPSTime.hpp>
+#include <common/types.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using nlohmann::json;
+
+/************** Helper functions for column types. ***********/
+template<typename T>
+static std::function<void(char*)> make_value_writer(const ReadableStateFieldBase* field) {
+    const StateField<T>* f = dynamic_cast<const StateField<T>*>(field);
+    if (!f) return nullptr;
+    return [f](char* out) {
+        const T val = f->get();
+        std::memcpy(out, &val, sizeof(T));
+    };
+}
+
+template<>
+std::function<void(char*)> make_value_writer<gps_time_t>(const ReadableStateFieldBase* field) {
+    const StateField<gps_time_t>* f = dynamic_cast<const StateField<gps_time_t>*>(field);
+    if (!f) return nullptr;
+    return [f](char* out) {
+        const gps_time_t t = f->get();
+        const unsigned long long ns = t.is_set ? static_cast<unsigned long long>(t.to_ns()) : 0;
+        std::memcpy(out, &ns, sizeof(ns));
+    };
+}
+
+/**
+ * @brief Get a function that writes the value of a lin vector field as an array, or
+ * nullptr if the field isn't a lin vector.
+ */
+template<typename T, size_t N>
+static std::function<void(char*)> make_lin_value_writer(const ReadableStateFieldBase* field) {
+    const StateField<lin::Vector<T, N>>* f =
+        dynamic_cast<const StateField<lin::Vector<T, N>>*>(field);
+    if (!f) return nullptr;
+    return [f](char* out) {
+        const lin::Vector<T, N> val = f->get();
+        std::array<T, N> arr;
+        for (size_t i = 0; i < N; i++) arr[i] = val(i);
+        std::memcpy(out, &arr, sizeof(arr));
+    };
+}
+
+/**
+ * @brief Get a function that writes the value of an array or lin vector field, or
+ * nullptr if the field is neither.
+ */
+template<typename T, size_t N>
+static std::function<void(char*)> make_vector_value_writer(const ReadableStateFieldBase* field) {
+    std::function<void(char*)> write_value = make_value_writer<std::array<T, N>>(field);
+    if (!write_value) write_value = make_lin_value_writer<T, N>(field);
+    return write_value;
+}
+
+/**
+ * @brief Get a function that writes the value of a field to a column of the given
+ * type, or nullptr if the field doesn't have that type.
+ */
+static std::function<void(char*)> make_value_writer(const std::string& type,
+    const ReadableStateFieldBase* field)
+{
+    if      (type == "unsigned int") return make_value_writer<unsigned int>(field);
+    else if (type == "signed int") return make_value_writer<signed int>(field);
+    else if (type == "unsigned char") return make_value_writer<unsigned char>(field);
+    else if (type == "signed char") return make_value_writer<signed char>(field);
+    else if (type == "float") return make_value_writer<float>(field);
+    else if (type == "double") return make_value_writer<double>(field);
+    else if (type == "float vector") return make_vector_value_writer<float, 3>(field);
+    else if (type == "double vector") return make_vector_value_writer<double, 3>(field);
+    else if (type == "float quaternion") return make_vector_value_writer<float, 4>(field);
+    else if (type == "double quaternion") return make_vector_value_writer<double, 4>(field);
+    else if (type == "bool") return make_value_writer<bool>(field);
+    else if (type == "gps_time_t") return make_value_writer<gps_time_t>(field);
+    else return nullptr;
+}
+
+/**
+ * @brief Pack bits into bytes, with the first bit in the least significant bit of
+ * the first byte.
+ */
+static void pack_bits(const bit_array& bits, char* out) {
+    const size_t width = (bits.size() + 7) / 8;
+    std::memset(out, 0, width);
+    for (size_t i = 0; i < bits.size(); i += 8) {
+        const size_t len = std::min<size_t>(8, bits.size() - i);
+        out[i / 8] = static_cast<char>(bits.to_ullong(i, len));
+    }
+}
+/************** End helper functions. ***********/
+
+size_t TelemetryArchive::value_width(const std::string& type) {
+    if      (type == "unsigned int") return sizeof(unsigned int);
+    else if (type == "signed int") return sizeof(signed int);
+    else if (type == "unsigned char") return sizeof(unsigned char);
+    else if (type == "signed char") return sizeof(signed char);
+    else if (type == "float") return sizeof(float);
+    else if (type == "double") return sizeof(double);
+    else if (type == "float vector") return sizeof(f_vector_t);
+    else if (type == "double vector") return sizeof(d_vector_t);
+    else if (type == "float quaternion") return sizeof(f_quat_t);
+    else if (type == "double quaternion") return sizeof(d_quat_t);
+    else if (type == "bool") return sizeof(bool);
+    else if (type == "gps_time_t") return sizeof(unsigned long long);
+    else return 0;
+}
+
+/**
+ * @brief Buffered rows of one column of the archive.
+ */
+struct TelemetryArchiveWriter::Column {
+    std::string name;
+    std::string type;
+    size_t width;
+    size_t rows;
+    bool written;
+
+    /**
+     * @brief Writes the current value of the column's field, or nullptr if the
+     * column stores serialized bits.
+     */
+    std::function<void(char*)> write_value;
+
+    std::vector<char> cycles;
+    std::vector<char> values;
+
+    Column(const std::string& _name, const std::string& _type, size_t _width) :
+        name(_name), type(_type), width(_width), rows(0), written(false) {}
+
+    void add_row(unsigned int cycle_no) {
+        const char* cycle_bytes = reinterpret_cast<const char*>(&cycle_no);
+        cycles.insert(cycles.end(), cycle_bytes, cycle_bytes + sizeof(cycle_no));
+        values.resize(values.size() + width);
+        rows++;
+    }
+};
+
+TelemetryArchiveWriter::TelemetryArchiveWriter(const std::string& _directory,
+    const json& telemetry_info) :
+        directory(_directory),
+        schema(telemetry_info),
+        ok(true),
+        closed(false),
+        frames(new Column("frames", "unsigned int", 0)),
+        cycle_no(0),
+        frame_count(0)
+{
+    struct stat dir_stat;
+    if (stat(directory.c_str(), &dir_stat) != 0) mkdir(directory.c_str(), 0755);
+    ok = stat(directory.c_str(), &dir_stat) == 0 && S_ISDIR(dir_stat.st_mode);
+}
+
+TelemetryArchiveWriter::~TelemetryArchiveWriter() {
+    close();
+}
+
+TelemetryArchiveWriter::Column& TelemetryArchiveWriter::column(const std::string& name,
+    const ReadableStateFieldBase* field, size_t width)
+{
+    auto it = field_columns.find(field);
+    if (it != field_columns.end()) return *it->second;
+
+    // Store the field's values as its type in the telemetry info, or as its bits if
+    // the field isn't in the telemetry info.
+    std::string type = "bits";
+    std::function<void(char*)> write_value;
+    const json& fields = schema["fields"];
+    if (fields.find(name) != fields.end()) {
+        const std::string field_type = fields[name]["type"];
+        write_value = make_value_writer(field_type, field);
+        if (write_value) {
+            type = field_type;
+            width = TelemetryArchive::value_width(type);
+        }
+    }
+
+    columns.emplace_back(new Column(name, type, width));
+    columns.back()->write_value = std::move(write_value);
+    field_columns[field] = columns.back().get();
+    return *columns.back();
+}
+
+void TelemetryArchiveWriter::begin_frame(unsigned int _cycle_no) {
+    cycle_no = _cycle_no;
+    frames->add_row(cycle_no);
+    frame_count++;
+    if (frames->cycles.size() >= buffer_size) flush(*frames);
+}
+
+void TelemetryArchiveWriter::add_flow(unsigned char) {}
+
+void TelemetryArchiveWriter::add_field(ReadableStateFieldBase* field) {
+    const bit_array& bits = field->get_bit_array();
+    Column& c = column(field->name(), field, (bits.size() + 7) / 8);
+    c.add_row(cycle_no);
+    char* value = c.values.data() + c.values.size() - c.width;
+    if (c.write_value) c.write_value(value);
+    else pack_bits(bits, value);
+    if (c.values.size() + c.cycles.size() >= buffer_size) flush(c);
+}
+
+void TelemetryArchiveWriter::add_event(Event* event, const bit_array& bits) {
+    Column& c = column(event->name(), event, (bits.size() + 7) / 8);
+    c.add_row(cycle_no);
+    pack_bits(bits, c.values.data() + c.values.size() - c.width);
+    if (c.values.size() + c.cycles.size() >= buffer_size) flush(c);
+}
+
+void TelemetryArchiveWriter::end_frame(const std::string&) {}
+
+static bool write_file(const std::string& path, const std::vector<char>& data, bool append) {
+    std::ofstream file(path, std::ios::out | std::ios::binary
+        | (append ? std::ios::app : std::ios::trunc));
+    file.write(data.data(), data.size());
+    return file.good();
+}
+
+void TelemetryArchiveWriter::flush(Column& c) {
+    const std::string path = directory + "/" + c.name;
+    ok &= write_file(path + ".cycle", c.cycles, c.written);
+    if (c.width > 0) ok &= write_file(path + ".val", c.values, c.written);
+    c.written = true;
+    c.cycles.clear();
+    c.values.clear();
+}
+
+bool TelemetryArchiveWriter::close() {
+    if (closed) return ok;
+    closed = true;
+    if (!ok) return false;
+
+    json& archive = schema["archive"];
+    archive["version"] = TelemetryArchive::version;
+    archive["frames"] = frame_count;
+    archive["columns"] = json::object();
+
+    flush(*frames);
+    for (std::unique_ptr<Column>& c : columns) {
+        flush(*c);
+        archive["columns"][c->name] = {
+            {"type", c->type},
+            {"width", c->width},
+            {"rows", c->rows}
+        };
+    }
+
+    std::ofstream schema_file(directory + "/schema.json");
+    schema_file << schema;
+    ok &= schema_file.good();
+    return ok;
+}
+
+/**
+ * @brief A file that's mapped into memory.
+ */
+struct TelemetryArchiveReader::Mapping {
+    void* addr;
+    size_t length;
+
+    Mapping(const std::string& path, size_t _length) : addr(nullptr), length(_length) {
+        if (length == 0) return;
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && static_cast<size_t>(file_stat.st_size) >= length) {
+            addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) addr = nullptr;
+        }
+        ::close(fd);
+    }
+
+    ~Mapping() {
+        if (addr) munmap(addr, length);
+    }
+
+    bool good() const { return length == 0 || addr; }
+};
+
+std::pair<size_t, size_t> TelemetryArchiveReader::Column::find(unsigned int first_cycle,
+    unsigned int last_cycle) const
+{
+    const unsigned int* first = std::lower_bound(cycles, cycles + rows, first_cycle);
+    const unsigned int* last = std::upper_bound(first, cycles + rows, last_cycle);
+    return {static_cast<size_t>(first - cycles), static_cast<size_t>(last - cycles)};
+}
+
+TelemetryArchiveReader::TelemetryArchiveReader(const std::string& _directory) :
+    directory(_directory), ok(false)
+{
+    std::ifstream schema_file(directory + "/schema.json");
+    if (!schema_file.is_open()) return;
+    archive_schema = json::parse(schema_file, nullptr, false);
+    ok = !archive_schema.is_discarded()
+        && archive_schema.find("archive") != archive_schema.end()
+        && archive_schema["archive"]["version"] == TelemetryArchive::version;
+}
+
+TelemetryArchiveReader::~TelemetryArchiveReader() {}
+
+std::vector<std::string> TelemetryArchiveReader::fields() const {
+    std::vector<std::string> names;
+    if (!ok) return names;
+    for (auto it = archive_schema["archive"]["columns"].begin();
+        it != archive_schema["archive"]["columns"].end(); ++it)
+    {
+        names.push_back(it.key());
+    }
+    return names;
+}
+
+const TelemetryArchiveReader::Column* TelemetryArchiveReader::column(const std::string& field) {
+    if (!ok) return nullptr;
+    auto it = columns.find(field);
+    if (it != columns.end()) return &it->second;
+
+    Column c;
+    if (field == "frames") {
+        c.type = "unsigned int";
+        c.width = 0;
+        c.rows = archive_schema["archive"]["frames"];
+    }
+    else {
+        const json& column_info = archive_schema["archive"]["columns"];
+        if (column_info.find(field) == column_info.end()) return nullptr;
+        c.type = column_info[field]["type"];
+        c.width = column_info[field]["width"];
+        c.rows = column_info[field]["rows"];
+    }
+
+    const std::string path = directory + "/" + field;
+    std::unique_ptr<Mapping> cycles(new Mapping(path + ".cycle", c.rows * sizeof(unsigned int)));
+    std::unique_ptr<Mapping> values(new Mapping(path + ".val", c.rows * c.width));
+    if (!cycles->good() || !values->good()) return nullptr;
+    c.cycles = static_cast<const unsigned int*>(cycles->addr);
+    c.values = static_cast<const char*>(values->addr);
+    mappings.push_back(std::move(cycles));
+    mappings.push_back(std::move(values));
+
+    return &columns.emplace(field, c).first->second;
+}
@@ -0,0 +1,212 @@
+#ifndef GROUND_TELEMETRY_ARCHIVE_HPP_
+#define GROUND_TELEMETRY_ARCHIVE_HPP_
+
+#include "DownlinkParser.hpp"
+#include <json.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Columnar archive of downlinked telemetry.
+ *
+ * An archive is a directory with the following files:
+ * - schema.json: the telemetry info from TelemetryInfoGenerator, with an added
+ *   "archive" key that lists the number of frames and, for each column, its type,
+ *   the width of its values in bytes and its number of rows.
+ * - frames.cycle: the control cycle count of each frame, in the order the frames
+ *   were received.
+ * - <field name>.cycle and <field name>.val: one row for every frame that contained
+ *   the field, with the control cycle count of the frame in the .cycle file and the
+ *   value of the field in the .val file.
+ *
+ * Cycle counts are stored as unsigned ints and values as their C++ type, in the byte
+ * order of the machine that wrote the archive, so columns can be memory-mapped as
+ * arrays. GPS times are stored as nanoseconds since the GPS epoch, or zero if unset.
+ * Events, which aren't in the telemetry info, are stored as their serialized bits,
+ * packed into bytes with the first bit in the least significant bit of the first byte.
+ */
+namespace TelemetryArchive {
+    /**
+     * @brief Number of bytes in each value of a column of the given type, or zero if
+     * the type isn't one that TelemetryInfoGenerator reports.
+     */
+    size_t value_width(const std::string& type);
+
+    /**
+     * @brief Version of the archive format that's written to schema.json.
+     */
+    constexpr unsigned int version = 1;
+}
+
+/**
+ * @brief Writes the frames that DownlinkParser decodes to a columnar archive.
+ *
+ * Rows are buffered in memory and appended to the column files whenever a column's
+ * buffer is full, so an archive can be written without keeping a file open for
+ * every field. The archive is complete once close() returns.
+ */
+class TelemetryArchiveWriter : public DownlinkParser::FrameSink {
+  public:
+    /**
+     * @brief Construct a new archive writer. The directory is created if it doesn't
+     * exist, and any existing column files in it are replaced.
+     *
+     * @param directory      Directory of the archive.
+     * @param telemetry_info Output of TelemetryInfoGenerator for the flight software
+     *                       that produced the frames.
+     */
+    TelemetryArchiveWriter(const std::string& directory, const nlohmann::json& telemetry_info);
+
+    /**
+     * @brief Calls close().
+     */
+    ~TelemetryArchiveWriter();
+
+    /**
+     * @brief False if the archive's directory couldn't be created or a column file
+     * couldn't be written.
+     */
+    bool good() const { return ok; }
+
+    /**
+     * @brief Write out the buffered rows and the schema.
+     *
+     * @return good()
+     */
+    bool close();
+
+    /**
+     * @brief Number of frames that have been written.
+     */
+    size_t num_frames() const { return frame_count; }
+
+    void begin_frame(unsigned int cycle_no) override;
+    void add_flow(unsigned char flow_id) override;
+    void add_field(ReadableStateFieldBase* field) override;
+    void add_event(Event* event, const bit_array& bits) override;
+    void end_frame(const std::string& error) override;
+
+    /**
+     * @brief Number of bytes of rows that are buffered per column before they're
+     * appended to the column's files.
+     */
+    static constexpr size_t buffer_size = 1 << 16;
+
+  private:
+    struct Column;
+
+    /**
+     * @brief Get the column of a field, creating it on the first row of the field.
+     */
+    Column& column(const std::string& name, const ReadableStateFieldBase* field, size_t width);
+
+    void flush(Column& column);
+
+    const std::string directory;
+    nlohmann::json schema;
+    bool ok;
+    bool closed;
+
+    std::unique_ptr<Column> frames;
+    std::vector<std::unique_ptr<Column>> columns;
+    std::unordered_map<const StateFieldBase*, Column*> field_columns;
+
+    unsigned int cycle_no;
+    size_t frame_count;
+};
+
+/**
+ * @brief Reads columns of a columnar telemetry archive.
+ *
+ * Only the files of the columns that are queried are opened, and they are memory-mapped
+ * rather than read, so a query touches only the rows that it returns.
+ */
+class TelemetryArchiveReader {
+  public:
+    /**
+     * @brief Rows of one column, as arrays that are mapped into memory.
+     */
+    struct Column {
+        std::string type;
+        size_t width;
+        size_t rows;
+        const unsigned int* cycles;
+        const char* values;
+
+        /**
+         * @brief Rows whose cycle counts are in [first_cycle, last_cycle], as a range
+         * of row indices [first, last). Cycle counts in a column are assumed to
+         * increase, which they do unless the flight computer was rebooted.
+         */
+        std::pair<size_t, size_t> find(unsigned int first_cycle, unsigned int last_cycle) const;
+    };
+
+    /**
+     * @brief Open an archive that was written by TelemetryArchiveWriter.
+     */
+    TelemetryArchiveReader(const std::string& directory);
+
+    ~TelemetryArchiveReader();
+
+    /**
+     * @brief False if the archive's schema couldn't be read.
+     */
+    bool good() const { return ok; }
+
+    /**
+     * @brief The archive's schema. See TelemetryArchive.
+     */
+    const nlohmann::json& schema() const { return archive_schema; }
+
+    /**
+     * @brief Names of the fields that have a column in the archive.
+     */
+    std::vector<std::string> fields() const;
+
+    /**
+     * @brief Get the column of a field, mapping it into memory the first time.
+     *
+     * @return The column, or nullptr if the field has no column or its files couldn't
+     * be mapped. Use "frames" for the cycle counts of the frames.
+     */
+    const Column* column(const std::string& field);
+
+    /**
+     * @brief Read the values of a field in a range of control cycles.
+     *
+     * @tparam T Type of the field's values. Must have the same width as the column.
+     * @param field       Name of the field.
+     * @param first_cycle First control cycle of the range.
+     * @param last_cycle  Last control cycle of the range.
+     * @param cycles      Control cycles of the rows that were read.
+     * @param values      Values of the rows that were read.
+     * @return False if the field has no column or T has the wrong width.
+     */
+    template<typename T>
+    bool read(const std::string& field, unsigned int first_cycle, unsigned int last_cycle,
+        std::vector<unsigned int>& cycles, std::vector<T>& values)
+    {
+        const Column* c = column(field);
+        if (!c || c->width != sizeof(T)) return false;
+        const std::pair<size_t, size_t> rows = c->find(first_cycle, last_cycle);
+        cycles.assign(c->cycles + rows.first, c->cycles + rows.second);
+        const T* begin = reinterpret_cast<const T*>(c->values);
+        values.assign(begin + rows.first, begin + rows.second);
+        return true;
+    }
+
+  private:
+    struct Mapping;
+
+    const std::string directory;
+    nlohmann::json archive_schema;
+    bool ok;
+
+    std::map<std::string, Column> columns;
+    std::vector<std::unique_ptr<Mapping>> mappings;
+};
+
+#endif
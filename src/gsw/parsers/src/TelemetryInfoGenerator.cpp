@@ -22,6 +22,10 @@ std::string type_name() {
     else if (std::is_same<d_vector_t, T>::value) return "double vector";
     else if (std::is_same<f_quat_t, T>::value) return "float quaternion";
     else if (std::is_same<d_quat_t, T>::value) return "double quaternion";
+    else if (std::is_same<lin::Vector3f, T>::value) return "float vector";
+    else if (std::is_same<lin::Vector3d, T>::value) return "double vector";
+    else if (std::is_same<lin::Vector4f, T>::value) return "float quaternion";
+    else if (std::is_same<lin::Vector4d, T>::value) return "double quaternion";
     else if (std::is_same<bool, T>::value) return "bool";
     else if (std::is_same<gps_time_t, T>::value) return "gps_time_t";
     else {
@@ -62,6 +66,25 @@ bool try_collect_vector_field_info(const StateFieldBaseType* field, json& field_
     return true;
 }
 
+template<template<typename> class StateFieldType,
+         typename UnderlyingType,
+         class StateFieldBaseType>
+bool try_collect_lin_vector_field_info(const StateFieldBaseType* field, json& field_info) {
+    static_assert(std::is_floating_point<UnderlyingType>::value,
+        "Can't collect vector field info for a vector of non-float or non-double type.");
+
+    using UnderlyingVectorType = lin::Vector<UnderlyingType, 3>;
+
+    const StateFieldType<UnderlyingVectorType>* ptr =
+        dynamic_cast<const StateFieldType<UnderlyingVectorType>*>(field);
+    if (!ptr) return false;
+
+    field_info["type"] = type_name<UnderlyingVectorType>();
+    field_info["min"] = ptr->get_serializer_min()(0);
+    field_info["max"] = ptr->get_serializer_max()(0);
+    return true;
+}
+
 template<template<typename> class StateFieldType,
          typename UnderlyingType,
          class StateFieldBaseType>
@@ -97,10 +120,14 @@ json get_field_info(const StateFieldBaseType* field) {
     found_field_type |= try_collect_field_info<StateFieldType, double, StateFieldBaseType>(field, field_info);
     found_field_type |= try_collect_vector_field_info<StateFieldType, float, StateFieldBaseType>(field, field_info);
     found_field_type |= try_collect_vector_field_info<StateFieldType, double, StateFieldBaseType>(field, field_info);
+    found_field_type |= try_collect_lin_vector_field_info<StateFieldType, float, StateFieldBaseType>(field, field_info);
+    found_field_type |= try_collect_lin_vector_field_info<StateFieldType, double, StateFieldBaseType>(field, field_info);
     found_field_type |= try_collect_unbounded_field_info<StateFieldType, bool, StateFieldBaseType>(field, field_info);
     found_field_type |= try_collect_unbounded_field_info<StateFieldType, gps_time_t, StateFieldBaseType>(field, field_info);
     found_field_type |= try_collect_unbounded_field_info<StateFieldType, f_quat_t, StateFieldBaseType>(field, field_info);
     found_field_type |= try_collect_unbounded_field_info<StateFieldType, d_quat_t, StateFieldBaseType>(field, field_info);
+    found_field_type |= try_collect_unbounded_field_info<StateFieldType, lin::Vector4f, StateFieldBaseType>(field, field_info);
+    found_field_type |= try_collect_unbounded_field_info<StateFieldType, lin::Vector4d, StateFieldBaseType>(field, field_info);
     
     if(!found_field_type) {
         std::cout << "Could not find field type for field: " << field->name() << std::endl;
@@ -1,5 +1,7 @@
 #include "UplinkProducer.h"
 #include <flow_data.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <json.hpp>
@@ -18,17 +20,23 @@ UplinkProducer::UplinkProducer(StateFieldRegistry& r):
         auto w = registry.writable_fields[i];
         field_map[w->name().c_str()] = i;
         max_possible_packet_size += index_size + w->bitsize();
+
+        // Resolve the field's type once, so that batches don't have to
+        try_index_field<unsigned int>(i) || try_index_field<signed int>(i)
+            || try_index_field<unsigned char>(i) || try_index_field<signed char>(i)
+            || try_index_field<float>(i) || try_index_field<double>(i)
+            || try_index_field<bool>(i)
+            || try_index_field<f_vector_t>(i) || try_index_field<d_vector_t>(i)
+            || try_index_field<f_quat_t>(i) || try_index_field<d_quat_t>(i)
+            || try_index_field<gps_time_t>(i);
     }
  }
 
 template<typename UnderlyingType>
-size_t UplinkProducer::try_add_field(bitstream bs, std::string key, nlohmann::json j) {
-    // Get pointer to that field in the registry
-    WritableStateField<UnderlyingType>* ptr = dynamic_cast<WritableStateField<UnderlyingType>*>(registry.find_writable_field(key));
-
-    // If the statefield of the given underlying type doesn't exist in the registry, return 0 bits written. Otherwise, get the value of the key
-    if (!ptr) return 0;
-    UnderlyingType val = j[key];
+void UplinkProducer::set_value(WritableStateField<UnderlyingType>* ptr, size_t field_index,
+    const std::string& key, const nlohmann::json& j_val)
+{
+    UnderlyingType val = j_val;
 
     // Check that the value specified in the JSON file is within that serializer bounds of the statefield
     UnderlyingType min = ptr->get_serializer_min();
@@ -39,29 +47,19 @@ size_t UplinkProducer::try_add_field(bitstream bs, std::string key, nlohmann::js
 
     // Make sure the value we want to set does not exceed the max possible
     // value that the field can be set to
-    size_t field_index=field_map[key];
     uint64_t max_val = (1ul << (get_field_length(field_index) + 1)) - 1;
-    if (static_cast<unsigned int>(val) > max_val) {
+    if (static_cast<unsigned int>(val) > max_val)
         throw std::runtime_error("cannot assign " + std::to_string(val) + " to field " + key + ". max value: " + std::to_string(max_val));
-        return false;
-    }
 
     ptr->set(val);
     ptr->serialize();
-
-    // Add the updated value to the bitstream
-    return add_entry(bs, ptr->get_bit_array(), field_index);
 }
 
 template<typename UnderlyingType>
-size_t UplinkProducer::try_add_vector_field(bitstream bs, std::string key, nlohmann::json j) {
-    // Get pointer to that field in the registry
-    using UnderlyingVectorType = std::array<UnderlyingType, 3>;
-    WritableStateField<UnderlyingVectorType>* ptr = dynamic_cast<WritableStateField<UnderlyingVectorType>*>(registry.find_writable_field(key));
-
-    // If the statefield of the given underlying type doesn't exist in the registry, return 0 bits written.
-    if (!ptr) return 0;
-    UnderlyingVectorType vals = j[key];
+void UplinkProducer::set_value(WritableStateField<std::array<UnderlyingType, 3>>* ptr, size_t field_index,
+    const std::string& key, const nlohmann::json& j_val)
+{
+    std::array<UnderlyingType, 3> vals = j_val;
 
     // Check that the magnitude of the values in the JSON file is within the statefield's serializer bounds
     UnderlyingType min = ptr->get_serializer_min()[0];
@@ -72,58 +70,81 @@ size_t UplinkProducer::try_add_vector_field(bitstream bs, std::string key, nlohm
 
     ptr->set(vals);
     ptr->serialize();
-
-    // Add the updated value to the bitstream
-    size_t field_index=field_map[key];
-    return add_entry(bs, ptr->get_bit_array(), field_index);
 }
 
 template<typename UnderlyingType>
-size_t UplinkProducer::try_add_quat_field(bitstream bs, std::string key, nlohmann::json j) {
-    // Get pointer to that field in the registry
+void UplinkProducer::set_value(WritableStateField<std::array<UnderlyingType, 4>>* ptr, size_t field_index,
+    const std::string& key, const nlohmann::json& j_val)
+{
     static_assert(std::is_same<UnderlyingType, double>::value || std::is_same<UnderlyingType, float>::value,
         "Can't collect quaternion field info for a vector of non-float or non-double type.");
-    using UnderlyingQuatType = std::array<UnderlyingType, 4>;
-    WritableStateField<UnderlyingQuatType>* ptr = dynamic_cast<WritableStateField<UnderlyingQuatType>*>(registry.find_writable_field(key));
-
-    // If the quaternion statefield of the given underlying type doesn't exist in the registry, return 0 bits written. Otherwise, get the values of the key
-    if (!ptr) return 0;
-    std::array<UnderlyingType, 4> vals = j[key];
+    std::array<UnderlyingType, 4> vals = j_val;
 
     // Check that the magnitude of the values in the JSON file is 1 ± some margin of error
     UnderlyingType quat_mag = std::sqrt(std::pow(vals[0], 2) + std::pow(vals[1], 2) + std::pow(vals[2], 2) + std::pow(vals[3], 2));
     UnderlyingType error = 1e-10;
     if (std::abs(quat_mag-1)>error) throw std::runtime_error("Magnitude of quaternion must be 1");
 
-    // Set the statefield pointer to the new values.
     ptr->set(vals);
     ptr->serialize();
+}
 
-    // Add the updated value to the bitstream
-    size_t field_index=field_map[key];
-    return add_entry(bs, ptr->get_bit_array(), field_index);
+void UplinkProducer::set_value(WritableStateField<gps_time_t>* ptr, size_t field_index,
+    const std::string& key, const nlohmann::json& j_val)
+{
+    unsigned short wn = j_val[0];
+    unsigned int tow = j_val[1];
+    unsigned long ns = j_val[2];
+
+    ptr->set(gps_time_t(wn,tow,ns));
+    ptr->serialize();
 }
 
-size_t UplinkProducer::try_add_gps_time(bitstream bs, std::string key, nlohmann::json j) {
+template<typename UnderlyingType>
+size_t UplinkProducer::try_add_field(bitstream& bs, std::string key, nlohmann::json j) {
     // Get pointer to that field in the registry
-    WritableStateField<gps_time_t>* ptr = dynamic_cast<WritableStateField<gps_time_t>*>(registry.find_writable_field(key));
+    WritableStateField<UnderlyingType>* ptr = dynamic_cast<WritableStateField<UnderlyingType>*>(registry.find_writable_field(key));
 
-    // If the time statefield doesn't exist in the registry, return 0 bits written. Otherwise, get the values of the key
+    // If the statefield of the given underlying type doesn't exist in the registry, return 0 bits written.
     if (!ptr) return 0;
-    unsigned short wn = j[key][0];
-    unsigned int tow = j[key][1];
-    unsigned long ns = j[key][2];
-
-    // Set the statefield pointer to the new time.
-    ptr->set(gps_time_t(wn,tow,ns));
-    ptr->serialize();
+    size_t field_index=field_map[key];
+    set_value(ptr, field_index, key, j[key]);
 
     // Add the updated value to the bitstream
-    size_t field_index=field_map[key];
     return add_entry(bs, ptr->get_bit_array(), field_index);
 }
 
-size_t UplinkProducer::add_field_to_bitstream(bitstream bs, std::string key, nlohmann::json j) {
+template<typename UnderlyingType>
+size_t UplinkProducer::try_add_vector_field(bitstream& bs, std::string key, nlohmann::json j) {
+    return try_add_field<std::array<UnderlyingType, 3>>(bs, key, j);
+}
+
+template<typename UnderlyingType>
+size_t UplinkProducer::try_add_quat_field(bitstream& bs, std::string key, nlohmann::json j) {
+    return try_add_field<std::array<UnderlyingType, 4>>(bs, key, j);
+}
+
+size_t UplinkProducer::try_add_gps_time(bitstream& bs, std::string key, nlohmann::json j) {
+    return try_add_field<gps_time_t>(bs, key, j);
+}
+
+template<typename UnderlyingType>
+void UplinkProducer::set_indexed_field(UplinkProducer& producer, const IndexedField& f,
+    const std::string& key, const nlohmann::json& val)
+{
+    producer.set_value(static_cast<WritableStateField<UnderlyingType>*>(f.field), f.index, key, val);
+}
+
+template<typename UnderlyingType>
+bool UplinkProducer::try_index_field(size_t index) {
+    auto w = registry.writable_fields[index];
+    WritableStateField<UnderlyingType>* ptr = dynamic_cast<WritableStateField<UnderlyingType>*>(w);
+    if (!ptr) return false;
+    field_index[w->name()] = {index, ptr, &set_indexed_field<UnderlyingType>};
+    return true;
+}
+
+size_t UplinkProducer::add_field_to_bitstream(bitstream& bs, std::string key, nlohmann::json j) {
     size_t bits_written = 0;
     bits_written += try_add_field<unsigned int>(bs, key, j);
     bits_written += try_add_field<signed int>(bs, key, j);
@@ -187,12 +208,8 @@ size_t UplinkProducer::add_entry(bitstream& bs, const bit_array& val, size_t ind
     ++index;
     bits_written += bs.editN(index_size, (uint8_t*)&index);
 
-    // Create a temporary bitstream from the bit array
-    char tmp [field_size];
-    bitstream bs_temp(tmp, field_size);
-
-    // Write bit array/bs_temp to the bitstream
-    bits_written += bs.editN(field_size, bs_temp);
+    // Write the value
+    bits_written += bs.editN(field_size, val);
    
     return bits_written;
 }
@@ -257,4 +274,91 @@ const size_t UplinkProducer::get_max_possible_packet_size()
         return false;
     }
     return true;
- }
\ No newline at end of file
+ }
+UplinkProducer::Batch UplinkProducer::compile_batch(const std::vector<nlohmann::json>& command_sets,
+    size_t message_size)
+{
+    struct Entry {
+        size_t field_index;
+        bit_array val;
+    };
+
+    // Encode the commands. A field that's set again keeps its place in the queue
+    // but takes the new value.
+    std::vector<Entry> entries;
+    std::vector<size_t> entry_of_field(registry.writable_fields.size(), SIZE_MAX);
+    for (const nlohmann::json& commands : command_sets)
+    {
+        for (auto& e : commands.items())
+        {
+            const std::string& key = e.key();
+            auto it = field_index.find(key);
+            if (it == field_index.end())
+                throw std::runtime_error("field map key not found: " + key);
+
+            const IndexedField& f = it->second;
+            f.set(*this, f, key, e.value());
+            const bit_array& val = registry.writable_fields[f.index]->get_bit_array();
+            if (entry_of_field[f.index] == SIZE_MAX) {
+                entry_of_field[f.index] = entries.size();
+                entries.push_back({f.index, val});
+            }
+            else
+                entries[entry_of_field[f.index]].val = val;
+        }
+    }
+
+    // Pack the entries into messages with first-fit decreasing, which never uses more
+    // than 11/9 of the fewest possible messages plus one, and usually matches
+    // min_messages. Pointers to the entries are sorted, since bit_arrays of
+    // different sizes can't be assigned to each other.
+    const size_t message_bits = message_size * 8;
+    auto entry_size = [&](const Entry* e) { return index_size + e->val.size(); };
+    std::vector<const Entry*> sorted_entries;
+    for (const Entry& e : entries) sorted_entries.push_back(&e);
+    std::stable_sort(sorted_entries.begin(), sorted_entries.end(), [&](const Entry* a, const Entry* b) {
+        return entry_size(a) > entry_size(b);
+    });
+
+    Batch batch;
+    std::vector<std::vector<const Entry*>> packed;
+    size_t total_bits = 0;
+    for (const Entry* e : sorted_entries)
+    {
+        const size_t bits = entry_size(e);
+        if (bits > message_bits)
+            throw std::runtime_error("field " + registry.writable_fields[e->field_index]->name()
+                + " does not fit into a message");
+        total_bits += bits;
+
+        size_t i = 0;
+        while (i < packed.size() && batch.free_bits[i] < bits) ++i;
+        if (i == packed.size()) {
+            packed.emplace_back();
+            batch.free_bits.push_back(message_bits);
+        }
+        packed[i].push_back(e);
+        batch.free_bits[i] -= bits;
+    }
+    batch.min_messages = (total_bits + message_bits - 1) / message_bits;
+
+    // Write the messages, trimmed to the bytes that they use
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        std::vector<char> message(message_size, 0);
+        bitstream bs(message.data(), message_size);
+        for (const Entry* e : packed[i])
+        {
+            bs.editN(index_size, static_cast<uint64_t>(e->field_index + 1));
+            bs.editN(e->val.size(), e->val);
+        }
+        const size_t used_bits = message_bits - batch.free_bits[i];
+        message.resize((used_bits + 7) / 8);
+
+        bitstream packet(message.data(), message.size());
+        if (!_validate_packet(packet))
+            throw std::runtime_error("Uplink Producer: Packet you created is not valid");
+        batch.messages.push_back(std::move(message));
+    }
+    return batch;
+}
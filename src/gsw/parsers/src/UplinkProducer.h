@@ -3,6 +3,8 @@
 #include <fsw/FCCode/MainControlLoop.hpp>
 #include <fsw/FCCode/UplinkCommon.h>
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include <json.hpp>
 
 /**
@@ -46,13 +48,40 @@ class UplinkProducer : public Uplink{
      */
     const size_t get_max_possible_packet_size();
 
+    /**
+     * Maximum size of an uplink (MT) message, in bytes
+     */
+    static constexpr size_t max_message_size = 340;
+
+    /**
+     * Uplink messages compiled from a batch of JSON command sets
+     */
+    struct Batch {
+        // Uplink packets, each of which fits into one MT message
+        std::vector<std::vector<char>> messages;
+        // Number of unused bits in each message
+        std::vector<size_t> free_bits;
+        // Lower bound on the number of messages that could hold the commands
+        size_t min_messages;
+    };
+
+    /**
+     * Compiles a queue of JSON command sets into as few uplink packets as possible.
+     * If a field is set by more than one command set, only the last value is sent,
+     * since a packet can't update a field twice and the messages may be applied in
+     * any order. Commands are packed into messages largest first.
+     * @throw runtime_error if a command is invalid
+     */
+    Batch compile_batch(const std::vector<nlohmann::json>& command_sets,
+        size_t message_size = max_message_size);
+
     /**
      * Helper function for add_field_to_bitstream.
      * Check that the field/key of a given type is in the statefield registry.
      * If it is, add the value of the field/key to the bitstream
      */
     template<typename UnderlyingType>
-    size_t try_add_field(bitstream bs, std::string key, nlohmann::json j);
+    size_t try_add_field(bitstream& bs, std::string key, nlohmann::json j);
 
     /**
      * Helper function for add_field_to_bitstream.
@@ -60,7 +89,7 @@ class UplinkProducer : public Uplink{
      * If it is, add the value of the field/key to the bitstream
      */
     template<typename UnderlyingType>
-    size_t try_add_vector_field(bitstream bs, std::string key, nlohmann::json j);
+    size_t try_add_vector_field(bitstream& bs, std::string key, nlohmann::json j);
 
     /**
      * Helper function for add_field_to_bitstream.
@@ -68,20 +97,20 @@ class UplinkProducer : public Uplink{
      * If it is, add the value of the field/key to the bitstream
      */
     template<typename UnderlyingType>
-    size_t try_add_quat_field(bitstream bs, std::string key, nlohmann::json j);
+    size_t try_add_quat_field(bitstream& bs, std::string key, nlohmann::json j);
 
     /**
      * Helper function for add_field_to_bitstream.
      * Check that the time statefield of a given type is in the statefield registry.
      * If it is, add the value of the field/key to the bitstream
      */
-    size_t try_add_gps_time(bitstream bs, std::string key, nlohmann::json j);
+    size_t try_add_gps_time(bitstream& bs, std::string key, nlohmann::json j);
 
     /**
      * Check that a field is in the registry. If it is, add the value to the bitstream.
      * @return number of bits written if successful
      */
-    size_t add_field_to_bitstream(bitstream bs, std::string key, nlohmann::json j);
+    size_t add_field_to_bitstream(bitstream& bs, std::string key, nlohmann::json j);
 
 #ifndef DEBUG
   private:
@@ -94,6 +123,51 @@ class UplinkProducer : public Uplink{
      */ 
     size_t add_entry(bitstream& bs, const bit_array& val, size_t index);
 
+    /**
+     * Checks that a value specified in JSON is valid for a field, then sets and
+     * serializes the field
+     * @throw runtime_error if the value is out of bounds
+     */
+    template<typename UnderlyingType>
+    void set_value(WritableStateField<UnderlyingType>* ptr, size_t field_index,
+        const std::string& key, const nlohmann::json& val);
+    template<typename UnderlyingType>
+    void set_value(WritableStateField<std::array<UnderlyingType, 3>>* ptr, size_t field_index,
+        const std::string& key, const nlohmann::json& val);
+    template<typename UnderlyingType>
+    void set_value(WritableStateField<std::array<UnderlyingType, 4>>* ptr, size_t field_index,
+        const std::string& key, const nlohmann::json& val);
+    void set_value(WritableStateField<gps_time_t>* ptr, size_t field_index,
+        const std::string& key, const nlohmann::json& val);
+
+    /**
+     * A writable field whose type has been resolved, so that commands for it don't
+     * need to look it up in the registry
+     */
+    struct IndexedField {
+        // Index of the field in registry.writable_fields
+        size_t index;
+        // Field, as the WritableStateField<T>* that set expects
+        void* field;
+        // Sets and serializes the field
+        void (*set)(UplinkProducer& producer, const IndexedField& f,
+            const std::string& key, const nlohmann::json& val);
+    };
+
+    template<typename UnderlyingType>
+    static void set_indexed_field(UplinkProducer& producer, const IndexedField& f,
+        const std::string& key, const nlohmann::json& val);
+
+    /**
+     * Adds a writable field to field_index if it has the given type
+     * @return true if it was added
+     */
+    template<typename UnderlyingType>
+    bool try_index_field(size_t index);
+
+    // maps field names to their resolved types
+    std::unordered_map<std::string, IndexedField> field_index;
+
     MainControlLoop fcp;
 
     // maps field names to indices
@@ -0,0 +1,162 @@
+/**
+ * @brief Measures the downlink bytes saved by delta flows on recorded telemetry.
+ *
+ * Reads a HOOTL telemetry log, which is any file with one telemetry dump from the Quake
+ * Manager per line, such as the raw log of a ptest state session. Each recorded snapshot is
+ * parsed with the flight flow data, and its field values are loaded into a second instance of
+ * flight software whose flows are all delta flows. That instance produces a snapshot as if
+ * every recorded snapshot had been transmitted. A third instance parses the delta snapshots,
+ * to check that they rebuild the same frames as the recorded snapshots.
+ *
+ * Usage: downlink_delta_benchmark <telemetry log> [keyframe period]
+ */
+
+#include <gsw/parsers/src/DownlinkParser.hpp>
+#include <flow_data.hpp>
+#include <json.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#ifndef UNIT_TEST
+
+using json = nlohmann::json;
+
+/**
+ * @brief Parses whole downlink frames, rather than the packets of a frame.
+ */
+class FrameParser : public DownlinkParser {
+  public:
+    FrameParser(StateFieldRegistry& r, const std::vector<DownlinkProducer::FlowData>& flow_data) :
+        DownlinkParser(r, flow_data) {}
+
+    DownlinkProducer* get_downlink_producer() { return fcp.get_downlink_producer(); }
+
+    json parse(const std::vector<char>& frame) {
+        // The parser only processes a frame once the first packet of the next frame
+        // arrives, so follow the frame with the start of an empty one.
+        process_downlink_packet(frame);
+        return json::parse(process_downlink_packet(std::vector<char>({'\x80'})));
+    }
+};
+
+/**
+ * @brief Extract the snapshot from a line of a telemetry log, or return an empty vector
+ * if the line doesn't contain one. Bytes are written as \xHH, with the backslash
+ * escaped one or more times.
+ */
+static std::vector<char> read_snapshot(const std::string& line) {
+    std::vector<char> snapshot;
+    const size_t telem_pos = line.find("\"telem\":\"");
+    if (telem_pos == std::string::npos) return snapshot;
+
+    for (size_t i = line.find("x", telem_pos); i != std::string::npos && i + 2 < line.size();
+         i = line.find("x", i + 3))
+    {
+        if (line[i - 1] != '\\') break;
+        snapshot.push_back(static_cast<char>(std::stoi(line.substr(i + 1, 2), nullptr, 16)));
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Copy the serialized value of each field in the downlink from one registry into
+ * the same field of another.
+ */
+static void copy_values(const StateFieldRegistry& src, StateFieldRegistry& dst,
+                        const std::vector<DownlinkProducer::Flow>& flows)
+{
+    auto copy = [&](const std::string& name) {
+        const Event* src_event = src.find_event(name);
+        const ReadableStateFieldBase* src_field = src_event ? src_event : src.find_readable_field(name);
+        Event* dst_event = dst.find_event(name);
+        ReadableStateFieldBase* dst_field = dst_event ? dst_event : dst.find_readable_field(name);
+
+        dst_field->set_bit_array(src_field->get_bit_array());
+        // Events are written to the snapshot as they are, but fields are serialized
+        // from their value.
+        if (!dst_event) dst_field->deserialize();
+    };
+
+    for (const DownlinkProducer::Flow& flow : flows) {
+        for (const ReadableStateFieldBase* field : flow.field_list) copy(field->name());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <telemetry log> [keyframe period]" << std::endl;
+        return 1;
+    }
+    const unsigned int keyframe_period = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::vector<DownlinkProducer::FlowData> delta_flow_data = PAN::flow_data;
+    for (DownlinkProducer::FlowData& flow : delta_flow_data) flow.keyframe_period = keyframe_period;
+
+    StateFieldRegistry recorded_registry;
+    FrameParser recorded_parser(recorded_registry, PAN::flow_data);
+
+    StateFieldRegistry delta_registry;
+    FrameParser delta_producer_fsw(delta_registry, delta_flow_data);
+    DownlinkProducer* delta_producer = delta_producer_fsw.get_downlink_producer();
+    const InternalStateField<char*>* snapshot_fp =
+        static_cast<InternalStateField<char*>*>(delta_registry.find_internal_field("downlink.ptr"));
+    const InternalStateField<size_t>* snapshot_size_fp =
+        static_cast<InternalStateField<size_t>*>(delta_registry.find_internal_field("downlink.snap_size"));
+    ReadableStateField<unsigned int>* cycle_no_fp =
+        static_cast<ReadableStateField<unsigned int>*>(delta_registry.find_readable_field("pan.cycle_no"));
+    InternalStateField<bool>* snapshot_taken_fp =
+        static_cast<InternalStateField<bool>*>(delta_registry.find_internal_field("downlink.taken"));
+
+    StateFieldRegistry rebuilt_registry;
+    FrameParser rebuilt_parser(rebuilt_registry, delta_flow_data);
+
+    std::ifstream log(argv[1]);
+    if (!log.is_open()) {
+        std::cerr << "Error: file not found." << std::endl;
+        return 1;
+    }
+
+    size_t num_frames = 0, num_mismatches = 0, recorded_bytes = 0, delta_bytes = 0;
+    for (std::string line; std::getline(log, line);) {
+        const std::vector<char> recorded = read_snapshot(line);
+        if (recorded.empty()) continue;
+
+        const json recorded_frame = recorded_parser.parse(recorded);
+        if (recorded_frame["metadata"]["error"] != false) {
+            std::cerr << "Skipping unparseable snapshot: " << recorded_frame["metadata"]["error"] << std::endl;
+            continue;
+        }
+
+        copy_values(recorded_registry, delta_registry, delta_producer->get_flows());
+        // The parser doesn't store the cycle count in its registry, since it isn't in a flow.
+        cycle_no_fp->set(recorded_frame["metadata"]["cycle_no"].get<unsigned int>());
+        delta_producer->execute();
+        snapshot_taken_fp->set(true);
+
+        const std::vector<char> delta(snapshot_fp->get(), snapshot_fp->get() + snapshot_size_fp->get());
+        const json rebuilt_frame = rebuilt_parser.parse(delta);
+
+        num_frames++;
+        recorded_bytes += recorded.size();
+        delta_bytes += delta.size();
+        if (rebuilt_frame["data"] != recorded_frame["data"]) num_mismatches++;
+    }
+
+    if (num_frames == 0) {
+        std::cerr << "Error: no telemetry found in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Snapshots: " << num_frames << ", keyframe period: " << keyframe_period << std::endl;
+    std::cout << "Recorded bytes: " << recorded_bytes << " ("
+              << static_cast<double>(recorded_bytes) / num_frames << " per snapshot)" << std::endl;
+    std::cout << "Delta bytes:    " << delta_bytes << " ("
+              << static_cast<double>(delta_bytes) / num_frames << " per snapshot)" << std::endl;
+    std::cout << "Saved: " << 100.0 * (1.0 - static_cast<double>(delta_bytes) / recorded_bytes)
+              << "%" << std::endl;
+    std::cout << "Rebuilt frames match: " << (num_mismatches == 0 ? "yes" : "no") << std::endl;
+    return num_mismatches == 0 ? 0 : 1;
+}
+
+#endif
@@ -1,11 +1,55 @@
 #include <gsw/parsers/src/DownlinkParser.hpp>
+#include <gsw/parsers/src/DownlinkBatchParser.hpp>
+#include <gsw/parsers/src/TelemetryArchive.hpp>
+#include <gsw/parsers/src/TelemetryInfoGenerator.hpp>
 #include <flow_data.hpp>
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <thread>
 
+/**
+ * With no arguments, reads one downlink packet filename per line from stdin, and prints
+ * the data in the last completed downlink frame after each packet.
+ *
+ * Given an archive, which is a directory with one downlink packet per file or a file of
+ * concatenated packets, prints the data in every frame of the archive as one JSON object
+ * per line:
+ *
+ *     downlink_parser <archive> [number of threads]
+ *
+ * or writes the data to a columnar telemetry archive in the given directory:
+ *
+ *     downlink_parser <archive> --columnar <output directory>
+ */
 #ifndef UNIT_TEST
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 3 && std::string(argv[2]) == "--columnar") {
+        TelemetryInfoGenerator gen(PAN::flow_data);
+        TelemetryArchiveWriter archive(argv[3], gen.generate_telemetry_info());
+        DownlinkBatchParser parser(PAN::flow_data, 1);
+        if (!parser.process_archive(argv[1], archive)) {
+            std::cerr << "Error: file not found." << std::endl;
+            return 1;
+        }
+        if (!archive.close()) {
+            std::cerr << "Error: couldn't write archive." << std::endl;
+            return 1;
+        }
+        std::cout << archive.num_frames() << " frames" << std::endl;
+        return 0;
+    }
+    if (argc > 1) {
+        const size_t num_threads = argc > 2 ? std::stoul(argv[2])
+            : std::max(1u, std::thread::hardware_concurrency());
+        DownlinkBatchParser parser(PAN::flow_data, num_threads);
+        if (!parser.process_archive(argv[1], std::cout)) {
+            std::cerr << "Error: file not found." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     StateFieldRegistry reg;
     DownlinkParser dp(reg, PAN::flow_data);
     std::string filename;
@@ -0,0 +1,71 @@
+/**
+ * @brief Measures the throughput of the batch downlink parser, in frames per second.
+ *
+ * The benchmark archive repeats the downlink packets in test/dat/DownlinkParser, so
+ * every frame has the same contents, and checks that the first frame is parsed into
+ * the expected output in that directory. Frames are parsed with one worker thread and
+ * then with more, up to the number of hardware threads.
+ *
+ * Usage: downlink_parser_benchmark [test data directory] [number of frames]
+ * Run from the root of the repository to use the default test data directory.
+ */
+
+#include <gsw/parsers/src/DownlinkBatchParser.hpp>
+#include <flow_data.hpp>
+#include <json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifndef UNIT_TEST
+
+using json = nlohmann::json;
+
+int main(int argc, char* argv[]) {
+    const std::string data_dir = argc > 1 ? argv[1] : "test/dat/DownlinkParser";
+    const size_t num_frames = argc > 2 ? std::atoi(argv[2]) : 100000;
+
+    std::vector<std::vector<char>> packets;
+    if (!DownlinkBatchParser::read_packets(data_dir + "/downlink1", packets)) {
+        std::cerr << "Error: file not found." << std::endl;
+        return 1;
+    }
+    const std::vector<std::vector<char>> test_frames = DownlinkBatchParser::group_frames(packets);
+    std::vector<std::vector<char>> frames;
+    while (frames.size() < num_frames) {
+        for (const std::vector<char>& frame : test_frames) frames.push_back(frame);
+    }
+    frames.resize(num_frames);
+
+    std::ifstream expected_file(data_dir + "/expected_output.json");
+    const json expected_output = json::parse(expected_file);
+
+    const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Frames: " << num_frames << std::endl;
+    for (size_t num_threads = 1; ; num_threads = std::min(2 * num_threads, max_threads)) {
+        DownlinkBatchParser parser(PAN::flow_data, num_threads);
+        std::ostringstream out;
+
+        const auto start = std::chrono::steady_clock::now();
+        parser.process_frames(frames, out);
+        const auto end = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::istringstream lines(out.str());
+        std::string first_line;
+        std::getline(lines, first_line);
+        const bool output_ok = json::parse(first_line) == expected_output;
+
+        std::cout << "Threads: " << parser.num_threads() << ", "
+                  << static_cast<size_t>(num_frames / seconds) << " frames/s"
+                  << (output_ok ? "" : " (unexpected output)") << std::endl;
+        if (num_threads == max_threads) break;
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include <gsw/parsers/src/TelemetryArchive.hpp>
+#include <common/types.hpp>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+/**
+ * Prints the values of a field in a columnar telemetry archive, written by
+ * "downlink_parser <archive> --columnar <directory>", as one "cycle,value" line per
+ * row. Vectors and quaternions are printed as comma-separated components, and
+ * serialized events as hexadecimal bytes. With no field, lists the archive's fields.
+ *
+ *     telem_archive_query <directory> [field] [first cycle] [last cycle]
+ */
+
+template<typename T>
+static void print_value(const char* value) {
+    T val;
+    std::memcpy(&val, value, sizeof(T));
+    std::cout << +val;
+}
+
+template<typename T, size_t N>
+static void print_array(const char* value) {
+    std::array<T, N> val;
+    std::memcpy(&val, value, sizeof(val));
+    for (size_t i = 0; i < N; i++) std::cout << (i > 0 ? "," : "") << val[i];
+}
+
+static void print_value(const std::string& type, const char* value, size_t width) {
+    if      (type == "unsigned int") print_value<unsigned int>(value);
+    else if (type == "signed int") print_value<signed int>(value);
+    else if (type == "unsigned char") print_value<unsigned char>(value);
+    else if (type == "signed char") print_value<signed char>(value);
+    else if (type == "float") print_value<float>(value);
+    else if (type == "double") print_value<double>(value);
+    else if (type == "float vector") print_array<float, 3>(value);
+    else if (type == "double vector") print_array<double, 3>(value);
+    else if (type == "float quaternion") print_array<float, 4>(value);
+    else if (type == "double quaternion") print_array<double, 4>(value);
+    else if (type == "bool") print_value<bool>(value);
+    else if (type == "gps_time_t") print_value<unsigned long long>(value);
+    else {
+        for (size_t i = 0; i < width; i++) {
+            std::cout << std::hex << std::setw(2) << std::setfill('0')
+                      << static_cast<unsigned int>(static_cast<unsigned char>(value[i]));
+        }
+        std::cout << std::dec;
+    }
+}
+
+#ifndef UNIT_TEST
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Need to specify an archive directory." << std::endl;
+        return 1;
+    }
+
+    TelemetryArchiveReader archive(argv[1]);
+    if (!archive.good()) {
+        std::cout << "Error: couldn't read archive schema." << std::endl;
+        return 1;
+    }
+    if (argc < 3) {
+        for (const std::string& field : archive.fields()) std::cout << field << std::endl;
+        return 0;
+    }
+
+    const std::string field = argv[2];
+    const unsigned int first_cycle = argc > 3 ? std::stoul(argv[3]) : 0;
+    const unsigned int last_cycle = argc > 4 ? std::stoul(argv[4])
+        : std::numeric_limits<unsigned int>::max();
+
+    const TelemetryArchiveReader::Column* column = archive.column(field);
+    if (!column) {
+        std::cout << "Error: no column for field: " << field << std::endl;
+        return 1;
+    }
+
+    std::cout << std::setprecision(std::numeric_limits<double>::max_digits10);
+    const std::pair<size_t, size_t> rows = column->find(first_cycle, last_cycle);
+    for (size_t i = rows.first; i < rows.second; i++) {
+        std::cout << column->cycles[i];
+        if (column->width > 0) {
+            std::cout << ",";
+            print_value(column->type, column->values + i * column->width, column->width);
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
+#endif
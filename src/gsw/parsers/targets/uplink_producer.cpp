@@ -1,12 +1,44 @@
 #include <gsw/parsers/src/UplinkProducer.h>
 #include <flow_data.hpp>
+#include <fstream>
 #include <iostream>
 
+/**
+ * Creates an uplink packet from a JSON file of field values:
+ *
+ *     uplink_producer <input JSON file> <output SBD file>
+ *
+ * or compiles a queue of JSON files into as few MT messages as possible, written to
+ * <output prefix>1.sbd, <output prefix>2.sbd, ..., and reports the unused capacity of
+ * each message:
+ *
+ *     uplink_producer --batch <output prefix> <input JSON files...>
+ */
 #ifndef UNIT_TEST
 int main(int argc, char** argv) {{
     StateFieldRegistry reg;
     UplinkProducer producer(reg);
 
+    if (argc > 3 && std::string(argv[1]) == "--batch") {
+        std::vector<nlohmann::json> command_sets;
+        for (int i = 3; i < argc; i++) {
+            std::ifstream fs(argv[i]);
+            command_sets.push_back(nlohmann::json::parse(fs));
+        }
+
+        UplinkProducer::Batch batch = producer.compile_batch(command_sets);
+        for (size_t i = 0; i < batch.messages.size(); i++) {
+            const std::string filename = std::string(argv[2]) + std::to_string(i + 1) + ".sbd";
+            std::ofstream out(filename, std::ios::out | std::ios::binary);
+            out.write(batch.messages[i].data(), batch.messages[i].size());
+            std::cout << filename << ": " << batch.messages[i].size() << " bytes, "
+                      << batch.free_bits[i] << " bits free" << std::endl;
+        }
+        std::cout << batch.messages.size() << " messages (at least " << batch.min_messages
+                  << " needed)" << std::endl;
+        return 0;
+    }
+
     if (argc < 2) {
         std::cout << "You must specify an input JSON file." << std::endl;
     }
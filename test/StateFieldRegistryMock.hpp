@@ -418,6 +418,12 @@ class StateFieldRegistryMock : public StateFieldRegistry {
         writable_fields.clear();
         faults.clear();
         events.clear();
+        internal_fields_index.clear();
+        readable_fields_index.clear();
+        writable_fields_index.clear();
+        faults_index.clear();
+        events_index.clear();
+        bound_fields.clear();
         created_internal_fields.clear();
         created_readable_fields.clear();
         created_writable_fields.clear();
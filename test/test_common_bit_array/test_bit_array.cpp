@@ -24,7 +24,17 @@ void test_bitarray_constructors() {
     bit_array arr4(arr3);
     TEST_ASSERT_EQUAL(8, arr4.size());
     TEST_ASSERT_EQUAL(1, arr4[5]);
-    TEST_ASSERT_NOT_EQUAL(&arr4, &arr3);
+    // Modifying the vector does not modify the copy
+    arr3[5] = 0;
+    TEST_ASSERT_EQUAL(1, arr4[5]);
+
+    // Sizes past the maximum are clamped to it
+    bit_array arr5(bit_array::max_size + 1);
+    TEST_ASSERT_EQUAL(bit_array::max_size, arr5.size());
+    TEST_ASSERT_FALSE(arr5.resize(bit_array::max_size + 64));
+    TEST_ASSERT_EQUAL(bit_array::max_size, arr5.size());
+    TEST_ASSERT_TRUE(arr5.resize(10));
+    TEST_ASSERT_EQUAL(10, arr5.size());
 }
 
 void test_bitarray_set_int() {
@@ -72,6 +82,66 @@ void test_bitarray_convert_to_integer() {
     TEST_ASSERT_EQUAL(6, arr.to_uint());
 }
 
+void test_bitarray_word_boundaries() {
+    // Set bits on either side of the boundary between the first two words.
+    bit_array arr(100);
+    arr[60] = 1;
+    arr[63] = 1;
+    arr[64] = 1;
+    arr[99] = 1;
+    TEST_ASSERT_EQUAL(1, arr[63]);
+    TEST_ASSERT_EQUAL(0, arr[65]);
+
+    // Read slices that do and don't straddle the boundary
+    TEST_ASSERT_EQUAL(0b11001, arr.to_ullong(60, 5));
+    TEST_ASSERT_EQUAL(0b1, arr.to_ullong(64, 1));
+    TEST_ASSERT_EQUAL((1ULL << 35) | 1, arr.to_ullong(64, 36));
+    TEST_ASSERT_EQUAL(0, arr.to_ullong(0, 60));
+    TEST_ASSERT_EQUAL(0b1001ULL << 60, arr.to_ullong(0, 64));
+    TEST_ASSERT_EQUAL(0b1001ULL << 60, arr.to_ullong());
+
+    // Set slices that do and don't straddle the boundary
+    arr.set_ullong(62, 4, 0b0111);
+    TEST_ASSERT_EQUAL(0b011101, arr.to_ullong(60, 6));
+    arr.set_ullong(64, 36, 0);
+    TEST_ASSERT_EQUAL(0, arr.to_ullong(64, 36));
+    arr.set_ullong(0, 64, ~0ULL);
+    TEST_ASSERT_EQUAL(~0ULL, arr.to_ullong(0, 64));
+    arr.set_ullong(0, 64, 0);
+    arr.set_ullong(60, 4, 0b1001);
+    arr.set_ullong(64, 36, (1ULL << 35) | 1);
+
+    // Copy slices of another array that straddle word boundaries
+    bit_array arr3(200);
+    arr3.set_bits(30, arr, 60, 40);
+    TEST_ASSERT_EQUAL(arr.to_ullong(60, 40), arr3.to_ullong(30, 40));
+    TEST_ASSERT_EQUAL(0, arr3.to_ullong(0, 30));
+    TEST_ASSERT_EQUAL(0, arr3.to_ullong(70, 64));
+    arr3.set_bits(100, arr);
+    for (size_t i = 0; i < arr.size(); i++) TEST_ASSERT_EQUAL(arr[i], arr3[100 + i]);
+    arr3.set_bits(0, bit_array(200));
+    TEST_ASSERT(arr3 == bit_array(200));
+
+    // Setting an integer clears the rest of the array
+    TEST_ASSERT(arr.set_int(0xffffffff));
+    TEST_ASSERT_EQUAL(0xffffffff, arr.to_ullong(0, 64));
+    TEST_ASSERT_EQUAL(0, arr.to_ullong(64, 36));
+
+    // Iterators visit every element in order
+    bit_array arr2(5);
+    arr2.set_int(0b10110);
+    std::vector<bool> bits(arr2.begin(), arr2.end());
+    TEST_ASSERT_EQUAL(5, bits.size());
+    for (size_t i = 0; i < bits.size(); i++) TEST_ASSERT_EQUAL(arr2[i], bits[i]);
+    std::copy(bits.begin() + 1, bits.end(), arr2.begin());
+    TEST_ASSERT_EQUAL(0b11011, arr2.to_uint());
+
+    // Shrinking the array clears the bits that were removed
+    arr2.resize(2);
+    arr2.resize(5);
+    TEST_ASSERT_EQUAL(0b11, arr2.to_uint());
+}
+
 void test_bitarray_write_to_string() {
     bit_array arr(12);
     arr.set_int(4095);  // arr = 111111111111
@@ -126,6 +196,7 @@ void test_bit_array() {
     RUN_TEST(test_bitarray_constructors);
     RUN_TEST(test_bitarray_set_int);
     RUN_TEST(test_bitarray_convert_to_integer);
+    RUN_TEST(test_bitarray_word_boundaries);
     RUN_TEST(test_bitarray_write_to_string);
     UNITY_END();
 }
@@ -0,0 +1,98 @@
+#include <unity.h>
+#include <common/bit_reader.hpp>
+#include <common/bit_writer.hpp>
+#include <cstring>
+
+void test_read_integers() {
+    // 11010000 11110000
+    const char buf[2] = {static_cast<char>(208), static_cast<char>(240)};
+    bit_reader r(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(16, r.remaining());
+
+    // Bits are read from the most significant bit of each byte, into the
+    // least significant bit of the result first.
+    TEST_ASSERT_EQUAL(0b011, r.read(3));
+    TEST_ASSERT_TRUE(r.read_bit());
+    TEST_ASSERT_EQUAL(0xf0, r.read(8));
+    TEST_ASSERT_EQUAL(4, r.remaining());
+    TEST_ASSERT_EQUAL(0, r.read(4));
+    TEST_ASSERT_EQUAL(0, r.remaining());
+}
+
+void test_read_bit_arrays() {
+    // Reading a bit array back should produce the bit array that was written.
+    bit_array arr(200);
+    for (size_t i = 0; i < arr.size(); i++) arr[i] = (i % 3 == 0) || (i % 7 == 0);
+
+    char buf[32];
+    memset(buf, 0, sizeof(buf));
+    bit_writer w(buf);
+    w.write(0b10110, 5);
+    w.write(arr);
+    TEST_ASSERT_EQUAL(26, w.flush());
+
+    bit_reader r(buf, 26);
+    TEST_ASSERT_EQUAL(0b10110, r.read(5));
+    bit_array read_arr(200);
+    r.read(read_arr);
+    TEST_ASSERT_TRUE(arr == read_arr);
+    TEST_ASSERT_EQUAL(3, r.remaining());
+}
+
+void test_read_packets() {
+    // Packet 1: 1 000011111
+    // Packet 2: 0 111111111
+    // Packet 3: 0 11, and one bit of padding
+    // 10000111 11011111 11110110
+    const char buf[3] = {static_cast<char>(135), static_cast<char>(223), static_cast<char>(246)};
+    bit_reader r(buf, sizeof(buf), 10);
+    TEST_ASSERT_EQUAL(21, r.remaining());
+
+    // Headers are skipped, including when a read straddles a packet boundary.
+    TEST_ASSERT_EQUAL(0, r.read(4));
+    TEST_ASSERT_EQUAL(0b111111, r.read(6));
+    TEST_ASSERT_EQUAL(11, r.remaining());
+    TEST_ASSERT_EQUAL(0x3ff, r.read(10));
+    TEST_ASSERT_EQUAL(1, r.remaining());
+
+    // A bit_writer and bit_reader with the same packet size agree on long frames.
+    bit_array arr(250);
+    for (size_t i = 0; i < arr.size(); i++) arr[i] = (i % 5 == 0) || (i % 11 == 0);
+    char frame[128];
+    memset(frame, 0, sizeof(frame));
+    bit_writer w(frame, 60);
+    for (int i = 0; i < 3; i++) w.write(arr);
+    const size_t frame_size = w.flush();
+
+    bit_reader r2(frame, frame_size, 60);
+    for (int i = 0; i < 3; i++) {
+        bit_array read_arr(250);
+        r2.read(read_arr);
+        TEST_ASSERT_TRUE(arr == read_arr);
+    }
+    TEST_ASSERT_LESS_THAN(8, r2.remaining());
+}
+
+void test_bit_reader() {
+    UNITY_BEGIN();
+    RUN_TEST(test_read_integers);
+    RUN_TEST(test_read_bit_arrays);
+    RUN_TEST(test_read_packets);
+    UNITY_END();
+}
+
+#ifdef DESKTOP
+int main(int argc, char *argv[]) {
+    test_bit_reader();
+    return 0;
+}
+#else
+#include <Arduino.h>
+void setup() {
+    delay(10000);
+    Serial.begin(9600);
+    test_bit_reader();
+}
+
+void loop() {}
+#endif
@@ -0,0 +1,100 @@
+#include <unity.h>
+#include <common/bit_writer.hpp>
+#include <cstring>
+
+void test_write_integers() {
+    char buf[4];
+    memset(buf, 0xff, sizeof(buf));
+    bit_writer w(buf);
+
+    // Bits are written least significant bit first, into the most
+    // significant bit of each byte.
+    w.write(0b011, 3);  // 110
+    w.write(0b1, 1);    // 1
+    w.write(0xf0, 8);   // 00001111
+    TEST_ASSERT_EQUAL(12, w.size());
+    TEST_ASSERT_EQUAL(2, w.flush());
+
+    // 11010000 11110000
+    TEST_ASSERT_EQUAL_UINT8(208, buf[0]);
+    TEST_ASSERT_EQUAL_UINT8(240, buf[1]);
+
+    // Bytes past the end of the written data are left alone.
+    TEST_ASSERT_EQUAL_UINT8(255, buf[2]);
+}
+
+void test_write_bit_arrays() {
+    // Writing a bit array should produce the same result as bit_array::to_string().
+    bit_array arr(100);
+    for (size_t i = 0; i < arr.size(); i++) arr[i] = (i % 3 == 0) || (i % 7 == 0);
+
+    char expected[16];
+    char* expected_ptr = expected;
+    memset(expected, 0, sizeof(expected));
+    arr.to_string(expected_ptr, 5);
+
+    char actual[16];
+    memset(actual, 0, sizeof(actual));
+    bit_writer w(actual);
+    w.write(0, 5);
+    w.write(arr);
+    TEST_ASSERT_EQUAL(105, w.size());
+    TEST_ASSERT_EQUAL(14, w.flush());
+    TEST_ASSERT_EQUAL_MEMORY(expected, actual, sizeof(expected));
+
+    // Write a subset of a bit array
+    bit_array arr2(4);
+    arr2.set_int(15); // arr2 = 1111
+    char buf[1];
+    bit_writer w2(buf);
+    w2.write(0, 3);
+    w2.write(arr2, 1, 3);
+    w2.flush();
+    // 00011000
+    TEST_ASSERT_EQUAL_UINT8(24, buf[0]);
+}
+
+void test_write_packets() {
+    // Use 10-bit packets so that it's easy to reason about boundaries.
+    char buf[4];
+    memset(buf, 0xff, sizeof(buf));
+    bit_writer w(buf, 10);
+
+    w.write(0, 4);
+    w.write(0b111111, 6); // Straddles the first packet boundary
+    w.write(0x3ff, 10);   // Straddles the second packet boundary
+    TEST_ASSERT_EQUAL(23, w.size());
+    TEST_ASSERT_EQUAL(3, w.flush());
+
+    // Packet 1: 1 000011111
+    // Packet 2: 0 111111111
+    // Packet 3: 0 11, and one bit of padding
+    // 10000111 11011111 11110110
+    TEST_ASSERT_EQUAL_UINT8(135, buf[0]);
+    TEST_ASSERT_EQUAL_UINT8(223, buf[1]);
+    TEST_ASSERT_EQUAL_UINT8(246, buf[2]);
+}
+
+void test_bit_writer() {
+    UNITY_BEGIN();
+    RUN_TEST(test_write_integers);
+    RUN_TEST(test_write_bit_arrays);
+    RUN_TEST(test_write_packets);
+    UNITY_END();
+}
+
+#ifdef DESKTOP
+int main(int argc, char *argv[]) {
+    test_bit_writer();
+    return 0;
+}
+#else
+#include <Arduino.h>
+void setup() {
+    delay(10000);
+    Serial.begin(9600);
+    test_bit_writer();
+}
+
+void loop() {}
+#endif
@@ -58,16 +58,44 @@ void test_cast() {
     TEST_ASSERT_EQUAL(0, static_cast<unsigned long>(t)); 
 
     gps_time_t t2(2, 2, 2);
-    const unsigned long e2 = t2.wn * nanoseconds_in_week + t2.tow * 1000000
+    const unsigned long e2 = t2.wn * nanoseconds_in_week + static_cast<unsigned long>(t2.tow) * 1000000
                              + t2.ns;
     TEST_ASSERT_EQUAL(e2, static_cast<unsigned long>(t2)); 
 
     gps_time_t t3(2075, 572522, 2000);
-    const unsigned long e3 = t3.wn * nanoseconds_in_week + t3.tow * 1000000
+    const unsigned long e3 = t3.wn * nanoseconds_in_week + static_cast<unsigned long>(t3.tow) * 1000000
                              + t3.ns;
     TEST_ASSERT_EQUAL(e3, static_cast<unsigned long>(t3)); 
 }
 
+void test_ns_conversions() {
+    // Conversions can be done at compile time.
+    constexpr gps_time_t t(2075, 572522, 2000);
+    static_assert(t.to_ns() == 2075 * nanoseconds_in_week + 572522000000LL + 2000, "");
+    static_assert(gps_time_t::from_ns(t.to_ns()) == t, "");
+    static_assert(gps_time_t(2, 2, 2) < t, "");
+
+    // Nanoseconds past the millisecond may be negative, as they are from the Piksi.
+    const gps_time_t t2(2075, 572522, -2000);
+    TEST_ASSERT_EQUAL(t.to_ns() - 4000, t2.to_ns());
+    TEST_ASSERT(t2 < t);
+    const gps_time_t t3 = gps_time_t::from_ns(t2.to_ns());
+    TEST_ASSERT(t3 == t2);
+    TEST_ASSERT_EQUAL(572521, t3.tow);
+    TEST_ASSERT_EQUAL(998000, t3.ns);
+
+    // Differences are signed, and don't depend on whether the times are set.
+    TEST_ASSERT_EQUAL(4000, t.ns_since(t2));
+    TEST_ASSERT_EQUAL(-4000, t2.ns_since(t));
+    gps_time_t t4 = t2;
+    t4.is_set = false;
+    TEST_ASSERT_EQUAL(-4000, t4.ns_since(t));
+
+    // Times of week that don't fit in 32 bits of nanoseconds are compared correctly.
+    TEST_ASSERT_FALSE(gps_time_t(2075, 5000, 0) < gps_time_t(2075, 4295, 0));
+    TEST_ASSERT(gps_time_t(2075, 4295, 0) < gps_time_t(2075, 5000, 0));
+}
+
 // Helper function for test_bool_operators.
 // Compares a GPS time to itself and verifies that the boolean assertions work correctly.
 void test_bool_operator_reflexive(gps_time_t t) {
@@ -194,6 +222,7 @@ int test_gps_time() {
     RUN_TEST(test_basic_constructors);
     RUN_TEST(test_copy_constructors_and_assignment_operators);
     RUN_TEST(test_cast);
+    RUN_TEST(test_ns_conversions);
     RUN_TEST(test_bool_operators);
     RUN_TEST(test_addition_operators);
     RUN_TEST(test_subtraction_operators);
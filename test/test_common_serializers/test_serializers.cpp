@@ -1,7 +1,11 @@
 #include <unity.h>
 #include <common/Serializer.hpp>
 #include <stdlib.h>
+#include <limits>
 #include <memory>
+#ifdef DESKTOP
+#include <thread>
+#endif
 
 #include <lin.hpp> // for cleaner inner products
 // ============================================================================================= //
@@ -450,6 +454,17 @@ void test_float_or_double_serializer() {
     test_value_float_or_double<T>(serializer, dl_deserializer,  4, 3, threshold);
     test_value_float_or_double<T>(serializer, dl_deserializer,  -2, -1, threshold);
 
+    // At 32 bits or more, the maximum encodes to the last interval even if the quotient
+    // rounds up past it, and NaNs encode to the minimum.
+    for (size_t size : {32, 40}) {
+        serializer.reset(new Serializer<T>(0, 1, size));
+        serializer->serialize(1);
+        TEST_ASSERT_EQUAL(4294967295u, serializer->get_bit_array().to_uint());
+        serializer->serialize(std::numeric_limits<T>::quiet_NaN());
+        TEST_ASSERT_EQUAL(0, serializer->get_bit_array().to_uint());
+    }
+    serializer.reset(new Serializer<T>(-1, 3, 6));
+
     // Test string-based deserialization
     T val;
     for (size_t i = 0; i < 1000; i++) {
@@ -487,6 +502,75 @@ void test_float_serializer() { test_float_or_double_serializer<float>(); }
  */
 void test_double_serializer() { test_float_or_double_serializer<double>(); }
 
+template <typename T>
+void test_fixed_width_float_or_double_serializer() {
+    Serializer<T, 6> serializer(-1, 3);
+    // Fixed-width values are decoded by ordinary serializers with the same bounds and width
+    Serializer<T> dl_deserializer(-1, 3, 6);
+    TEST_ASSERT_EQUAL(6, serializer.bitsize());
+    TEST_ASSERT_EQUAL(63, (Serializer<T, 6>::num_intervals));
+
+    T val;
+    const T threshold = 4.0 / 63;
+    for (size_t i = 0; i <= 1000; i++) {
+        T x = -1.0 + i * 4.0 / 1000;
+        serializer.serialize(x);
+        dl_deserializer.set_bit_array(serializer.get_bit_array());
+        dl_deserializer.deserialize(&val);
+        if (std::is_same<T, float>::value) {
+            TEST_ASSERT_FLOAT_WITHIN(threshold, x, val);
+        } else {
+            TEST_ASSERT_DOUBLE_WITHIN(threshold, x, val);
+        }
+    }
+
+    // Out-of-range values are clamped, and NaNs are encoded as the minimum
+    serializer.serialize(4);
+    TEST_ASSERT_EQUAL(63, serializer.get_bit_array().to_uint());
+    serializer.serialize(-2);
+    TEST_ASSERT_EQUAL(0, serializer.get_bit_array().to_uint());
+    serializer.serialize(1);
+    serializer.serialize(NAN);
+    TEST_ASSERT_EQUAL(0, serializer.get_bit_array().to_uint());
+
+    // Values serialized into an ordinary serializer with the same width land in its bit array
+    Serializer<T> dest(-1, 3, 6);
+    Serializer<T, 6>::serialize(dest, 3);
+    TEST_ASSERT_EQUAL(63, dest.get_bit_array().to_uint());
+
+    // The full 32 bits of the widest serializers are used
+    Serializer<T, 32> wide_serializer(0, 1000);
+    Serializer<T> wide_dl_deserializer(0, 1000, 32);
+    wide_serializer.serialize(1000);
+    TEST_ASSERT_EQUAL(4294967295, wide_serializer.get_bit_array().to_uint());
+    wide_serializer.serialize(250);
+    wide_dl_deserializer.set_bit_array(wide_serializer.get_bit_array());
+    wide_dl_deserializer.deserialize(&val);
+    if (std::is_same<T, float>::value) {
+        TEST_ASSERT_FLOAT_WITHIN(0.001, 250, val);
+    } else {
+        TEST_ASSERT_DOUBLE_WITHIN(0.000001, 250, val);
+    }
+
+    // Test string-based deserialization
+    TEST_ASSERT(serializer.deserialize("2.5", &val));
+    serializer.deserialize(&val);
+    if (std::is_same<T, float>::value) {
+        TEST_ASSERT_FLOAT_WITHIN(threshold, 2.5, val);
+    } else {
+        TEST_ASSERT_DOUBLE_WITHIN(threshold, 2.5, val);
+    }
+}
+
+/**
+ * @brief Verify that the fixed-width float and double serializers encode values that
+ * ordinary serializers with the same bounds and width can decode.
+ */
+void test_fixed_width_serializer() {
+    test_fixed_width_float_or_double_serializer<float>();
+    test_fixed_width_float_or_double_serializer<double>();
+}
+
 /**
  * @brief Verify that the float vector serializer properly encapsulates float vectors of various
  * sizes.
@@ -561,6 +645,21 @@ void test_vec_serializer() {
         // angle_err < 0.5 deg if no sign flips, or if error is small (across an interval)
     }
 
+    // The sign of the largest component must not carry over when a serializer is reused,
+    // and copies of a serializer must be independent of it.
+    {
+        Serializer<vector_t> reused_serializer(0, 2, vec_bitsize);
+        reused_serializer.serialize(vector_t({-1, 0, 0}));
+        Serializer<vector_t> copied_serializer(reused_serializer);
+        reused_serializer.serialize(vector_t({1, 0, 0}));
+
+        vector_t reused_result, copied_result;
+        reused_serializer.deserialize(&reused_result);
+        copied_serializer.deserialize(&copied_result);
+        TEST_ASSERT_FLOAT_WITHIN(0.01, 1, to_stdarray(reused_result)[0]);
+        TEST_ASSERT_FLOAT_WITHIN(0.01, -1, to_stdarray(copied_result)[0]);
+    }
+
     // Test deserialization from a string
     auto serializer = std::make_shared<Serializer<vector_t>>(0,2,vec_bitsize);
     vector_t result;
@@ -582,6 +681,11 @@ void test_vec_serializer() {
     // Test printing
     vector_t print_val = {2, 4, 2};
     TEST_ASSERT_EQUAL_STRING("2.000000,4.000000,2.000000,", serializer->print(print_val));
+
+    // Values too long for the shared print buffer are truncated to fit it.
+    const T big = std::numeric_limits<T>::max();
+    vector_t big_val = {big, big, big};
+    TEST_ASSERT_EQUAL(127, strlen(serializer->print(big_val)));
 }
 
 /**
@@ -734,7 +838,78 @@ void test_gpstime_serializer() {
     // Printing
     gps_time_t input4(4,4,4);
     TEST_ASSERT_EQUAL_STRING("4,4,4", gpstime_serializer->print(input4));
+
+    // Negative nanoseconds, as reported by the Piksi, and nanoseconds that need all
+    // 20 bits are preserved.
+    gps_time_t input5(2075, 572522, -2000);
+    gpstime_serializer->serialize(input5);
+    gpstime_serializer->deserialize(&result);
+    TEST_ASSERT(result == input5);
+    gps_time_t input6(2075, 604799999, 999999);
+    gpstime_serializer->serialize(input6);
+    gpstime_serializer->deserialize(&result);
+    TEST_ASSERT(result == input6);
+    TEST_ASSERT_EQUAL(999999, result.ns);
+}
+
+/**
+ * @brief Verify that the delta mode of the GPS time serializer stores times relative to
+ * its epoch, and clamps the times that it can't represent.
+ */
+void test_gpstime_delta_serializer() {
+    const gps_time_t epoch(2045, 0, 0);
+    Serializer<gps_time_t> gpstime_serializer(epoch, 56);
+    TEST_ASSERT_EQUAL(57, gpstime_serializer.bitsize());
+    gps_time_t result;
+
+    gps_time_t input;
+    gpstime_serializer.serialize(input);
+    gpstime_serializer.deserialize(&result);
+    TEST_ASSERT_FALSE(result.is_set);
+
+    gps_time_t input2(2075, 572522, -2000);
+    gpstime_serializer.serialize(input2);
+    TEST_ASSERT_EQUAL(input2.ns_since(epoch), gpstime_serializer.get_bit_array().to_ullong(1, 56));
+    gpstime_serializer.deserialize(&result);
+    TEST_ASSERT(result == input2);
+
+    // Times before the epoch or past the largest delta are clamped.
+    gpstime_serializer.serialize(gps_time_t(2000, 5, 5));
+    gpstime_serializer.deserialize(&result);
+    TEST_ASSERT(result == epoch);
+    gpstime_serializer.serialize(gps_time_t(3000, 0, 0));
+    gpstime_serializer.deserialize(&result);
+    TEST_ASSERT_EQUAL((1LL << 56) - 1, result.ns_since(epoch));
+
+    // Deserializing from a string and printing are the same as in the default mode.
+    TEST_ASSERT(gpstime_serializer.deserialize("2075,3,3", &result));
+    gpstime_serializer.deserialize(&result);
+    TEST_ASSERT(result == gps_time_t(2075, 3, 3));
+    TEST_ASSERT_EQUAL_STRING("2075,3,3", gpstime_serializer.print(result));
+}
+
+#ifdef DESKTOP
+/**
+ * @brief Verify that serializers on different threads don't print into the same buffer,
+ * since the ground software parses downlinks on several threads.
+ */
+void test_print_on_threads() {
+    std::array<bool, 2> ok{{true, true}};
+    auto print_values = [&ok](size_t t) {
+        Serializer<d_vector_t> serializer(0, 1000, 3 * 30);
+        const d_vector_t val{{t + 0.5, t + 100.25, t + 500.125}};
+        std::string expected = serializer.print(val);
+        for (unsigned int i = 0; i < 100000; i++) {
+            if (expected != serializer.print(val)) ok[t] = false;
+        }
+    };
+    std::thread other(print_values, 1);
+    print_values(0);
+    other.join();
+    TEST_ASSERT(ok[0]);
+    TEST_ASSERT(ok[1]);
 }
+#endif
 
 void test_serializers() {
     UNITY_BEGIN();
@@ -745,11 +920,16 @@ void test_serializers() {
     RUN_TEST(test_signed_char_serializer);
     RUN_TEST(test_float_serializer);
     RUN_TEST(test_double_serializer);
+    RUN_TEST(test_fixed_width_serializer);
     RUN_TEST(test_f_vec_serializer);
     RUN_TEST(test_d_vec_serializer);
     RUN_TEST(test_f_quat_serializer);
     RUN_TEST(test_d_quat_serializer);
     RUN_TEST(test_gpstime_serializer);
+    RUN_TEST(test_gpstime_delta_serializer);
+#ifdef DESKTOP
+    RUN_TEST(test_print_on_threads);
+#endif
     UNITY_END();
 }
 
@@ -0,0 +1,124 @@
+#include <unity.h>
+#include <common/spsc_ring.hpp>
+#include <cstring>
+
+#ifdef DESKTOP
+#include <thread>
+#endif
+
+void test_read_write() {
+    spsc_ring<16> ring;
+    TEST_ASSERT_EQUAL(0, ring.size());
+
+    const char msg[] = "hello";
+    TEST_ASSERT_EQUAL(5, ring.write(msg, 5));
+    TEST_ASSERT_EQUAL(5, ring.size());
+
+    // Peeking leaves the bytes in the ring.
+    char buf[16] = {0};
+    TEST_ASSERT_EQUAL(3, ring.peek(buf, 3));
+    TEST_ASSERT_EQUAL_MEMORY("hel", buf, 3);
+    TEST_ASSERT_EQUAL(5, ring.size());
+
+    // Peeking or reading more bytes than the ring has gets only what's there.
+    TEST_ASSERT_EQUAL(5, ring.peek(buf, sizeof(buf)));
+    ring.discard(2);
+    TEST_ASSERT_EQUAL(3, ring.read(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("llo", buf, 3);
+    TEST_ASSERT_EQUAL(0, ring.size());
+}
+
+void test_wraparound() {
+    spsc_ring<8> ring;
+    unsigned char in[8], out[8];
+    unsigned char next = 0, expected = 0;
+
+    // Writes and reads of sizes that don't divide the capacity wrap around the end
+    // of the ring at every offset.
+    for (size_t round = 0; round < 20; round++) {
+        for (size_t i = 0; i < 5; i++) in[i] = next++;
+        TEST_ASSERT_EQUAL(5, ring.write(in, 5));
+        TEST_ASSERT_EQUAL(5, ring.read(out, 5));
+        for (size_t i = 0; i < 5; i++) TEST_ASSERT_EQUAL(expected++, out[i]);
+    }
+}
+
+void test_full() {
+    spsc_ring<8> ring;
+    const unsigned char in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    TEST_ASSERT_EQUAL(8, ring.write(in, sizeof(in)));
+    TEST_ASSERT_EQUAL(0, ring.write(in, 1));
+
+    unsigned char* region;
+    TEST_ASSERT_EQUAL(0, ring.write_region(region));
+
+    // Freeing space makes a region available at the start of the ring.
+    ring.discard(3);
+    TEST_ASSERT_EQUAL(3, ring.write_region(region));
+    region[0] = 8;
+    region[1] = 9;
+    ring.commit(2);
+
+    unsigned char out[8];
+    TEST_ASSERT_EQUAL(7, ring.read(out, sizeof(out)));
+    for (size_t i = 0; i < 7; i++) TEST_ASSERT_EQUAL(i + 3, out[i]);
+}
+
+#ifdef DESKTOP
+void test_threads() {
+    // A producer thread writes a sequence of bytes in uneven chunks while this thread
+    // reads them, so the two are at different offsets most of the time.
+    static spsc_ring<64> ring;
+    const size_t n = 1000000;
+    std::thread producer([&] {
+        unsigned char chunk[13];
+        size_t written = 0;
+        while (written < n) {
+            const size_t len = std::min(sizeof(chunk), n - written);
+            for (size_t i = 0; i < len; i++) chunk[i] = static_cast<unsigned char>(written + i);
+            size_t done = 0;
+            while (done < len) done += ring.write(chunk + done, len - done);
+            written += len;
+        }
+    });
+
+    size_t read = 0;
+    bool ok = true;
+    unsigned char buf[7];
+    while (read < n) {
+        const size_t len = ring.read(buf, sizeof(buf));
+        for (size_t i = 0; i < len; i++) ok &= buf[i] == static_cast<unsigned char>(read + i);
+        read += len;
+    }
+    producer.join();
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL(0, ring.size());
+}
+#endif
+
+void test_spsc_ring() {
+    UNITY_BEGIN();
+    RUN_TEST(test_read_write);
+    RUN_TEST(test_wraparound);
+    RUN_TEST(test_full);
+#ifdef DESKTOP
+    RUN_TEST(test_threads);
+#endif
+    UNITY_END();
+}
+
+#ifdef DESKTOP
+int main(int argc, char *argv[]) {
+    test_spsc_ring();
+    return 0;
+}
+#else
+#include <Arduino.h>
+void setup() {
+    delay(10000);
+    Serial.begin(9600);
+    test_spsc_ring();
+}
+
+void loop() {}
+#endif
@@ -78,6 +78,32 @@ void test_writable_state_field() {
     test_serializable_state_field(&wsf);
 }
 
+// Test that a field with a fixed-width serializer serializes with it, and can be used
+// like any other readable field.
+void test_fixed_readable_state_field() {
+    FixedReadableStateField<float, 6> frsf("field", Serializer<float, 6>(-1, 3));
+    ReadableStateField<float>* rsf = &frsf;
+    TEST_ASSERT(rsf->is_readable());
+    TEST_ASSERT_FALSE(rsf->is_writable());
+    TEST_ASSERT_EQUAL(6, rsf->bitsize());
+    TEST_ASSERT_EQUAL_FLOAT(-1, rsf->get_serializer_min());
+    TEST_ASSERT_EQUAL_FLOAT(3, rsf->get_serializer_max());
+
+    rsf->set(3);
+    rsf->serialize();
+    TEST_ASSERT_EQUAL(63, rsf->get_bit_array().to_uint());
+
+    rsf->set(NAN);
+    rsf->serialize();
+    TEST_ASSERT_EQUAL(0, rsf->get_bit_array().to_uint());
+
+    rsf->set(1);
+    rsf->serialize();
+    rsf->set(0);
+    rsf->deserialize();
+    TEST_ASSERT_FLOAT_WITHIN(4.0 / 63, 1, rsf->get());
+}
+
 void test_eeprom_save_period() {
     WritableStateField<bool> sf1("field", Serializer<bool>());
     TEST_ASSERT_EQUAL(0, sf1.eeprom_save_period());
@@ -167,6 +193,7 @@ void test_state_field() {
     RUN_TEST(test_internal_state_field);
     RUN_TEST(test_readable_state_field);
     RUN_TEST(test_writable_state_field);
+    RUN_TEST(test_fixed_readable_state_field);
     RUN_TEST(test_eeprom_save_period);
     RUN_TEST(test_get_set_eeprom);
     UNITY_END();
@@ -70,11 +70,71 @@ void test_faults() {
     TEST_ASSERT_FALSE(registry.find_fault("fake_fault"));
 }
 
+void test_field_ids() {
+    StateFieldRegistry registry;
+
+    // Add enough fields that the registry's index has to grow a few times.
+    std::vector<std::unique_ptr<ReadableStateField<bool>>> fields;
+    for (size_t i = 0; i < 100; i++) {
+        fields.emplace_back(new ReadableStateField<bool>("field" + std::to_string(i), Serializer<bool>()));
+        TEST_ASSERT_TRUE(registry.add_readable_field(fields.back().get()));
+    }
+    WritableStateField<bool> writable("writable", Serializer<bool>());
+    TEST_ASSERT_TRUE(registry.add_writable_field(&writable));
+
+    // IDs are positions within the lists of fields, and lookups by ID and by
+    // name agree.
+    for (size_t i = 0; i < 100; i++) {
+        const std::string name = "field" + std::to_string(i);
+        TEST_ASSERT_EQUAL(i, registry.find_readable_field_id(name));
+        TEST_ASSERT(registry.get_readable_field(i) == fields[i].get());
+        TEST_ASSERT(registry.find_readable_field(name) == fields[i].get());
+    }
+    TEST_ASSERT_EQUAL(100, registry.find_readable_field_id("writable"));
+    TEST_ASSERT_EQUAL(0, registry.find_writable_field_id("writable"));
+    TEST_ASSERT(registry.get_writable_field(0) == &writable);
+
+    // Fields that don't exist
+    TEST_ASSERT_EQUAL(StateFieldRegistry::invalid_id, registry.find_readable_field_id("field100"));
+    TEST_ASSERT_EQUAL(StateFieldRegistry::invalid_id, registry.find_writable_field_id("field0"));
+    TEST_ASSERT_EQUAL(StateFieldRegistry::invalid_id, registry.find_internal_field_id("field0"));
+    TEST_ASSERT_NULL(registry.get_readable_field(101));
+    TEST_ASSERT_NULL(registry.get_internal_field(0));
+    TEST_ASSERT_NULL(registry.get_readable_field(StateFieldRegistry::invalid_id));
+}
+
+void test_field_handles() {
+    StateFieldRegistry registry;
+
+    constexpr field_handle<ReadableStateField<unsigned int>> readable_handle = {0, "readable", 32};
+    constexpr field_handle<InternalStateField<bool>> internal_handle = {3, "internal", 0};
+
+    // Nothing is bound yet
+    TEST_ASSERT_NULL(registry.get_field(readable_handle));
+    TEST_ASSERT_NULL(registry.get_field(internal_handle));
+
+    ReadableStateField<unsigned int> readable("readable", Serializer<unsigned int>());
+    InternalStateField<bool> internal("internal");
+    registry.bind_field(readable_handle, &readable);
+    TEST_ASSERT(registry.get_field(readable_handle) == &readable);
+    TEST_ASSERT_NULL(registry.get_field(internal_handle));
+
+    registry.bind_field(internal_handle, &internal);
+    TEST_ASSERT(registry.get_field(internal_handle) == &internal);
+    TEST_ASSERT(registry.get_field(readable_handle) == &readable);
+
+    // Handles past the end of the bound fields aren't bound to anything.
+    constexpr field_handle<InternalStateField<bool>> unbound_handle = {10, "unbound", 0};
+    TEST_ASSERT_NULL(registry.get_field(unbound_handle));
+}
+
 void test_state_field_registry() {
     UNITY_BEGIN();
     RUN_TEST(test_foo);
     RUN_TEST(test_events);
     RUN_TEST(test_faults);
+    RUN_TEST(test_field_ids);
+    RUN_TEST(test_field_handles);
     UNITY_END();
 }
 
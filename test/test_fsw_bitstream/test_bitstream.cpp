@@ -1,6 +1,12 @@
 #include <common/bitstream.h>
 #include <unity.h>
+#include <cstdio>
 #include <cstring>
+#ifdef DESKTOP
+#include <chrono>
+#else
+#include <Arduino.h>
+#endif
 using namespace std; 
 
 /**
@@ -497,6 +503,183 @@ void test17()
   TEST_ASSERT_EQUAL(0x9893, u16);
 }
 
+/**
+ * Check that words, bit arrays and unaligned reads and writes of more than 64
+ * bits move the same bits as byte-at-a-time reads
+ */
+void test18()
+{
+  char mydata[16];
+  memcpy(mydata, "\x12\x34\x56\x78\x9a\xbc\xde\xf0\x0f\xed\xcb\xa9\x87\x65\x43\x21", 16);
+  bitstream bs(mydata, 16);
+
+  // Read a word at a bit offset
+  uint64_t u64 = 0;
+  bs.seekG(4, bs_end);
+  TEST_ASSERT_EQUAL(64, bs.nextN(64, u64));
+  TEST_ASSERT_TRUE(u64 == 0xff0debc9a7856341ULL);
+  TEST_ASSERT_EQUAL(0, bs.nextN(65, u64));
+
+  // Read 72 bits at a bit offset, which reaches into a ninth byte
+  uint8_t res[9];
+  bs.reset();
+  bs.seekG(3, bs_end);
+  TEST_ASSERT_EQUAL(72, bs.nextN(72, res));
+  bitstream bs_bytes(mydata, 16);
+  bs_bytes.seekG(3, bs_end);
+  for (int i = 0; i < 9; ++i)
+  {
+    uint8_t u8 = 0;
+    bs_bytes.nextN(8, &u8);
+    TEST_ASSERT_EQUAL(u8, res[i]);
+  }
+
+  // Read into a bit array a word at a time
+  bit_array bit_arr(100);
+  bs.reset();
+  bs.seekG(5, bs_end);
+  TEST_ASSERT_EQUAL(100, bs.peekN(100, bit_arr));
+  for (size_t i = 0; i < 100; ++i)
+  {
+    uint8_t bit = 0;
+    bs.nextN(1, &bit);
+    TEST_ASSERT_EQUAL(bit, bit_arr[i]);
+  }
+
+  // Write a bit array and a word back at different offsets, and read them back
+  char copy[16];
+  memset(copy, 0, 16);
+  bitstream bs_copy(copy, 16);
+  bs_copy.seekG(7, bs_end);
+  TEST_ASSERT_EQUAL(100, bs_copy.editN(100, bit_arr));
+  bs_copy.seekG(100, bs_beg);
+  bit_array bit_arr_copy(100);
+  bs_copy.nextN(100, bit_arr_copy);
+  TEST_ASSERT_TRUE(bit_arr == bit_arr_copy);
+
+  bs_copy.reset();
+  bs_copy.seekG(1, bs_end);
+  TEST_ASSERT_EQUAL(64, bs_copy.editN(64, u64));
+  bs_copy.seekG(64, bs_beg);
+  uint64_t u64_copy = 0;
+  bs_copy.nextN(64, u64_copy);
+  TEST_ASSERT_TRUE(u64 == u64_copy);
+
+  // Writes stop at the end of the stream
+  bs_copy.reset();
+  bs_copy.seekG(8*15 + 4, bs_end);
+  TEST_ASSERT_EQUAL(4, bs_copy.editN(64, u64));
+}
+
+/**
+ * Returns a time in microseconds, for measuring throughput
+ */
+static unsigned long time_us()
+{
+#ifdef DESKTOP
+  return chrono::duration_cast<chrono::microseconds>(
+    chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return micros();
+#endif
+}
+
+/**
+ * Prints the throughput of a bitstream operation in megabits per second
+ */
+static void print_throughput(const char* name, size_t bits, unsigned long start)
+{
+  const unsigned long elapsed = time_us() - start;
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%s: %.1f Mbit/s", name, elapsed ? (double)bits/elapsed : 0.0);
+  TEST_MESSAGE(msg);
+}
+
+/**
+ * Measure the throughput of reading and writing an uplink-sized packet through
+ * each of the bitstream's interfaces, and check that they agree
+ */
+void test_throughput()
+{
+  const size_t packet_size = 340;
+#ifdef DESKTOP
+  const size_t num_iters = 20000;
+#else
+  const size_t num_iters = 200;
+#endif
+  char packet[packet_size];
+  for (size_t i = 0; i < packet_size; ++i) packet[i] = static_cast<char>(i*37 + 11);
+  char copy[packet_size];
+  uint8_t res[packet_size];
+  bitstream bs(packet, packet_size);
+  bitstream bs_copy(copy, packet_size);
+  const size_t packet_bits = 8*packet_size;
+  uint64_t checksum_words = 0, checksum_fields = 0;
+
+  unsigned long start = time_us();
+  for (size_t n = 0; n < num_iters; ++n)
+  {
+    bs.reset();
+    bs.nextN(packet_bits, res);
+  }
+  print_throughput("nextN, byte-aligned", num_iters*packet_bits, start);
+
+  start = time_us();
+  for (size_t n = 0; n < num_iters; ++n)
+  {
+    bs.reset();
+    bs.seekG(1, bs_end);
+    bs.nextN(packet_bits - 1, res);
+  }
+  print_throughput("nextN, unaligned", num_iters*(packet_bits - 1), start);
+
+  start = time_us();
+  for (size_t n = 0; n < num_iters; ++n)
+  {
+    bs.reset();
+    uint64_t u64 = 0;
+    while (bs.nextN(64, u64) == 64) checksum_words += u64;
+  }
+  print_throughput("nextN, 64-bit words", num_iters*packet_bits, start);
+
+  // Read 13-bit fields into bit arrays, like the uplink consumer does
+  bit_array field(13);
+  start = time_us();
+  for (size_t n = 0; n < num_iters; ++n)
+  {
+    bs.reset();
+    while (bs.nextN(13, field) == 13) checksum_fields += field.to_ullong();
+  }
+  print_throughput("nextN, 13-bit bit_array fields", num_iters*packet_bits, start);
+
+  start = time_us();
+  for (size_t n = 0; n < num_iters; ++n)
+  {
+    bs.reset();
+    bs_copy.reset();
+    bs_copy.seekG(3, bs_end);
+    bs_copy.editN(packet_bits, bs);
+  }
+  print_throughput("editN, unaligned bitstream copy", num_iters*packet_bits, start);
+
+  // The copy is the packet shifted by three bits
+  bs.reset();
+  bs_copy.reset();
+  bs_copy.seekG(3, bs_end);
+  bs.nextN(packet_bits - 3, res);
+  uint8_t res_copy[packet_size];
+  bs_copy.nextN(packet_bits - 3, res_copy);
+  TEST_ASSERT_EQUAL_MEMORY(res, res_copy, packet_size - 1);
+
+  // The word and field reads saw the same bits
+  bs.reset();
+  uint64_t u64 = 0;
+  uint64_t expected_words = 0;
+  while (bs.nextN(64, u64) == 64) expected_words += u64;
+  TEST_ASSERT_TRUE(checksum_words == num_iters*expected_words);
+  TEST_ASSERT_TRUE(checksum_fields > 0);
+}
+
 /**
  * Recursive helper function to print bits into little endian in order to
  * paste into python and generate testcases
@@ -529,6 +712,8 @@ int test_bitstream()
     RUN_TEST(test15);
     RUN_TEST(test16);
     RUN_TEST(test17);
+    RUN_TEST(test18);
+    RUN_TEST(test_throughput);
     return UNITY_END();
 }
 
@@ -537,7 +722,6 @@ int main() {
     return test_bitstream();
 }
 #else
-#include <Arduino.h>
 void setup() {
     delay(2000);
     Serial.begin(9600);
@@ -0,0 +1,92 @@
+#include <fsw/FCCode/CycleTrace.hpp>
+#include <unity.h>
+
+#ifdef DESKTOP
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+void test_add_tasks() {
+    TEST_ASSERT_EQUAL(0, CycleTrace::add_task("task0"));
+    TEST_ASSERT_EQUAL(1, CycleTrace::add_task("task1"));
+    TEST_ASSERT_EQUAL_STRING("task1", CycleTrace::task_name(1).c_str());
+
+    // Tasks past the maximum share the last ID.
+    for (size_t i = 2; i < CycleTrace::max_tasks; i++) CycleTrace::add_task("task");
+    TEST_ASSERT_EQUAL(CycleTrace::max_tasks - 1, CycleTrace::add_task("extra"));
+    TEST_ASSERT_EQUAL_STRING("task", CycleTrace::task_name(CycleTrace::max_tasks - 1).c_str());
+}
+
+void test_record() {
+    const unsigned int start = CycleTrace::size();
+    CycleTrace::record(7, CycleTrace::cycle_start, 100);
+    CycleTrace::record(1, CycleTrace::task_start, 101);
+    CycleTrace::record(1, CycleTrace::task_end, 105);
+    TEST_ASSERT_EQUAL(start + 3, CycleTrace::size());
+
+    const CycleTrace::Event& event = CycleTrace::get(start + 2);
+    TEST_ASSERT_EQUAL(105, event.time_us);
+    TEST_ASSERT_EQUAL(1, event.task);
+    TEST_ASSERT_EQUAL(CycleTrace::task_end, event.kind);
+
+    // The ring keeps the last capacity events.
+    for (unsigned int i = 0; i < CycleTrace::capacity; i++)
+        CycleTrace::record(0, CycleTrace::task_start, 1000 + i);
+    const unsigned int end = CycleTrace::size();
+    TEST_ASSERT_EQUAL(1000, CycleTrace::get(end - CycleTrace::capacity).time_us);
+    TEST_ASSERT_EQUAL(1000 + CycleTrace::capacity - 1, CycleTrace::get(end - 1).time_us);
+}
+
+#ifdef DESKTOP
+void test_dump() {
+    CycleTrace::dump_path = "test_cycle_trace.bin";
+    CycleTrace::record(1, CycleTrace::task_end, 0x01020304);
+    TEST_ASSERT_TRUE(CycleTrace::dump());
+
+    std::ifstream in(CycleTrace::dump_path, std::ios::binary);
+    const std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)),
+                                          std::istreambuf_iterator<char>());
+    std::remove(CycleTrace::dump_path.c_str());
+
+    // Header, then the task names, then the events.
+    const unsigned char header[] = {'P', 'T', 'R', 'C', 1, 0, 0, 0, CycleTrace::max_tasks, 0, 0, 0,
+                                    5, 0, 't', 'a', 's', 'k', '0'};
+    TEST_ASSERT_EQUAL_MEMORY(header, data.data(), sizeof(header));
+
+    const size_t names_size = 2 * (2 + 5) + (CycleTrace::max_tasks - 2) * (2 + 4);
+    const size_t events_start = 12 + names_size + 4;
+    TEST_ASSERT_EQUAL(events_start + 8 * CycleTrace::capacity, data.size());
+    TEST_ASSERT_EQUAL(CycleTrace::capacity, data[events_start - 4] | (data[events_start - 3] << 8));
+
+    // The most recent event is last.
+    const unsigned char last[] = {0x04, 0x03, 0x02, 0x01, 1, 0, CycleTrace::task_end, 0};
+    TEST_ASSERT_EQUAL_MEMORY(last, data.data() + data.size() - 8, 8);
+}
+#endif
+
+int test_cycle_trace() {
+    UNITY_BEGIN();
+    RUN_TEST(test_add_tasks);
+    RUN_TEST(test_record);
+#ifdef DESKTOP
+    RUN_TEST(test_dump);
+#endif
+    return UNITY_END();
+}
+
+#ifdef DESKTOP
+int main() {
+    return test_cycle_trace();
+}
+#else
+#include <Arduino.h>
+void setup() {
+    delay(2000);
+    Serial.begin(9600);
+    test_cycle_trace();
+}
+
+void loop() {}
+#endif
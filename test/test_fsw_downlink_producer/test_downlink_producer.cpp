@@ -14,6 +14,7 @@ struct TestFixture {
     std::shared_ptr<ReadableStateField<unsigned int>> cycle_count_fp;
     InternalStateField<char*>* snapshot_ptr_fp;
     InternalStateField<size_t>* snapshot_size_bytes_fp;
+    InternalStateField<bool>* snapshot_taken_fp;
     WritableStateField<unsigned char>* shift_flows_id1_fp;
     WritableStateField<unsigned char>* shift_flows_id2_fp;
     WritableStateField<unsigned char>* toggle_flow_id_fp;
@@ -35,6 +36,7 @@ struct TestFixture {
         snapshot_ptr_fp = registry.find_internal_field_t<char*>("downlink.ptr");
         snapshot_size_bytes_fp = registry.find_internal_field_t<size_t>(
                                     "downlink.snap_size");
+        snapshot_taken_fp = registry.find_internal_field_t<bool>("downlink.taken");
         shift_flows_id1_fp = registry.find_writable_field_t<unsigned char>("downlink.shift_id1");
         shift_flows_id2_fp = registry.find_writable_field_t<unsigned char>("downlink.shift_id2");
         toggle_flow_id_fp = registry.find_writable_field_t<unsigned char>("downlink.toggle_id");
@@ -502,6 +504,224 @@ void test_toggle() {
     TEST_ASSERT_EQUAL(0, tf.toggle_flow_id_fp->get()); 
 }
 
+/**
+ * @brief Check that the downlink plan tracks the active flows, and that events
+ * are distinguished from plain fields.
+ */
+void test_plan() {
+    TestFixture tf;
+
+    auto foo2_fp = tf.registry.create_readable_field<bool>("foo2");
+    std::vector<ReadableStateFieldBase*> event_data = {foo2_fp.get()};
+    tf.registry.create_event("event", event_data,
+        [](const unsigned int, std::vector<ReadableStateFieldBase*>&) -> const char* { return ""; });
+
+    std::vector<DownlinkProducer::FlowData> flow_data = {
+        {
+            1, true, {"foo1", "event"}
+        },
+        {
+            2, true, {"foo2"}
+        }
+    };
+    tf.init(flow_data);
+
+    using Type = DownlinkProducer::PlanEntry::Type;
+    std::vector<DownlinkProducer::PlanEntry> plan = tf.downlink_producer->get_plan();
+    TEST_ASSERT_EQUAL(6, plan.size());
+
+    // Control cycle count
+    TEST_ASSERT(plan[0].type == Type::field);
+    TEST_ASSERT(plan[0].field == tf.cycle_count_fp.get());
+    TEST_ASSERT_EQUAL(0, plan[0].offset);
+    TEST_ASSERT_EQUAL(32, plan[0].length);
+
+    // Flow 1
+    TEST_ASSERT(plan[1].type == Type::flow_id);
+    TEST_ASSERT_EQUAL(32, plan[1].offset);
+    TEST_ASSERT_EQUAL(2, plan[1].length); // Two flows, so IDs take two bits
+    TEST_ASSERT(plan[2].type == Type::field);
+    TEST_ASSERT(plan[2].field == tf.foo1_fp.get());
+    TEST_ASSERT_EQUAL(34, plan[2].offset);
+    TEST_ASSERT(plan[3].type == Type::event);
+    TEST_ASSERT_EQUAL(66, plan[3].offset);
+    TEST_ASSERT_EQUAL(33, plan[3].length);
+
+    // Flow 2
+    TEST_ASSERT(plan[4].type == Type::flow_id);
+    TEST_ASSERT_EQUAL(99, plan[4].offset);
+    TEST_ASSERT(plan[5].type == Type::field);
+    TEST_ASSERT(plan[5].field == foo2_fp.get());
+    TEST_ASSERT_EQUAL(101, plan[5].offset);
+    TEST_ASSERT_EQUAL(1, plan[5].length);
+
+    // Deactivating flow 1 removes it from the plan once the command is processed.
+    tf.toggle_flow_id_fp->set(1);
+    TEST_ASSERT_EQUAL(6, tf.downlink_producer->get_plan().size());
+    tf.downlink_producer->execute();
+    plan = tf.downlink_producer->get_plan();
+    TEST_ASSERT_EQUAL(3, plan.size());
+    TEST_ASSERT(plan[1].type == Type::flow_id);
+    TEST_ASSERT_EQUAL(32, plan[1].offset);
+    TEST_ASSERT(plan[2].field == foo2_fp.get());
+    TEST_ASSERT_EQUAL(34, plan[2].offset);
+
+    // Reordering flows reorders the plan.
+    tf.downlink_producer->toggle_flow(1);
+    tf.downlink_producer->shift_flow_priorities(2, 1);
+    plan = tf.downlink_producer->get_plan();
+    TEST_ASSERT_EQUAL(6, plan.size());
+    TEST_ASSERT(plan[2].field == foo2_fp.get());
+    TEST_ASSERT(plan[4].field == tf.foo1_fp.get());
+    TEST_ASSERT(plan[5].type == Type::event);
+}
+
+void test_delta_flows() {
+    TestFixture tf;
+
+    auto foo2_fp = tf.registry.create_readable_field<bool>("foo2");
+    foo2_fp->set(false);
+
+    // Keyframe every third transmitted snapshot
+    std::vector<DownlinkProducer::FlowData> flow_data = {
+        {
+            1, true, {"foo1", "foo2"}, 3
+        }
+    };
+    tf.init(flow_data);
+
+    // The planned size allows for a keyframe: ceil((1 + 32 + 1 + 1 + 8 + 32 + 1) / 8)
+    TEST_ASSERT_EQUAL(10, tf.snapshot_size_bytes_fp->get());
+    std::vector<DownlinkProducer::PlanEntry> plan = tf.downlink_producer->get_plan();
+    TEST_ASSERT_EQUAL(5, plan.size());
+    TEST_ASSERT(plan[2].type == DownlinkProducer::PlanEntry::Type::delta_header);
+    TEST_ASSERT_EQUAL(9, plan[2].length);
+    TEST_ASSERT_EQUAL(42, plan[3].offset);
+
+    // Until a snapshot is transmitted, the ground has nothing to compare a
+    // delta against, so the flow is always a keyframe.
+    tf.downlink_producer->execute();
+    TEST_ASSERT_EQUAL(10, tf.snapshot_size_bytes_fp->get());
+    tf.downlink_producer->execute();
+    TEST_ASSERT_EQUAL(10, tf.snapshot_size_bytes_fp->get());
+    TEST_ASSERT_EQUAL(0, tf.downlink_producer->get_flows()[0].sequence);
+
+    // Once it is, unchanged fields are left out: ceil((1 + 32 + 1 + 1 + 8 + 2) / 8)
+    tf.snapshot_taken_fp->set(true);
+    tf.downlink_producer->execute();
+    TEST_ASSERT_FALSE(tf.snapshot_taken_fp->get());
+    TEST_ASSERT_EQUAL(6, tf.snapshot_size_bytes_fp->get());
+    TEST_ASSERT_EQUAL(1, tf.downlink_producer->get_flows()[0].sequence);
+
+    // Only changed fields are sent. The fifth and sixth bytes contain the last bit
+    // of the cycle count, the flow ID, the keyframe bit, the sequence number (3),
+    // the change bitmap and foo2: 0 1 0 11000 000 01 1 00
+    tf.snapshot_taken_fp->set(true);
+    foo2_fp->set(true);
+    tf.downlink_producer->execute();
+    TEST_ASSERT_EQUAL(6, tf.snapshot_size_bytes_fp->get());
+    TEST_ASSERT_EQUAL_UINT8(0x58, tf.snapshot_ptr_fp->get()[4]);
+    TEST_ASSERT_EQUAL_UINT8(0x0c, tf.snapshot_ptr_fp->get()[5]);
+
+    // After two deltas are transmitted, a keyframe is due.
+    tf.snapshot_taken_fp->set(true);
+    tf.downlink_producer->execute();
+    TEST_ASSERT_EQUAL(10, tf.snapshot_size_bytes_fp->get());
+
+    // A delta that isn't smaller than a keyframe is sent as a keyframe.
+    tf.snapshot_taken_fp->set(true);
+    tf.foo1_fp->set(401);
+    tf.downlink_producer->execute();
+    TEST_ASSERT_EQUAL(10, tf.snapshot_size_bytes_fp->get());
+
+    // The sequence number wraps around.
+    for (unsigned int i = 0; i < 256; i++) {
+        tf.snapshot_taken_fp->set(true);
+        tf.downlink_producer->execute();
+    }
+    TEST_ASSERT_EQUAL(4, tf.downlink_producer->get_flows()[0].sequence);
+}
+
+void test_flow_scheduler() {
+    auto is_scheduled = [](TestFixture& tf) {
+        std::vector<bool> ret;
+        for (const DownlinkProducer::Flow& flow : tf.downlink_producer->get_flows())
+            ret.push_back(flow.is_scheduled);
+        return ret;
+    };
+    auto next_frame = [](TestFixture& tf) {
+        tf.snapshot_taken_fp->set(true);
+        tf.downlink_producer->execute();
+        TEST_ASSERT_LESS_OR_EQUAL(70, tf.snapshot_size_bytes_fp->get());
+    };
+
+    {
+        TestFixture tf;
+        auto foo2_fp = tf.registry.create_readable_field<bool>("foo2");
+        const std::vector<std::string> eight_foo1(8, "foo1");
+        std::vector<DownlinkProducer::FlowData> flow_data = {
+            {1, true, eight_foo1}, // Flow size: 259 bits (3 + 256)
+            {2, true, eight_foo1},
+            {3, true, eight_foo1},
+            {4, true, {"foo2"}}    // Flow size: 4 bits (3 + 1)
+        };
+        tf.init(flow_data);
+        WritableStateField<unsigned char>* frame_budget_fp =
+            tf.registry.find_writable_field_t<unsigned char>("downlink.budget");
+
+        // With no budget, every active flow is sent.
+        TEST_ASSERT_EQUAL(0, frame_budget_fp->get());
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({true, true, true, true}));
+
+        // One MO message has room for 527 bits of flows. The two highest priority
+        // flows are sent, and the space left over is filled with flow 4, even
+        // though flow 3 has a higher priority.
+        frame_budget_fp->set(1);
+        tf.downlink_producer->execute();
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({true, true, false, true}));
+        // ceil((1 + 32 + 259 + 259 + 4) / 8)
+        TEST_ASSERT_EQUAL(70, tf.snapshot_size_bytes_fp->get());
+
+        // The schedule only changes once a snapshot is taken.
+        tf.downlink_producer->execute();
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({true, true, false, true}));
+
+        // Flows 2 and 3 then take turns.
+        next_frame(tf);
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({true, false, true, true}));
+        next_frame(tf);
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({true, true, false, true}));
+        next_frame(tf);
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({true, false, true, true}));
+
+        // Removing the budget sends every active flow again.
+        frame_budget_fp->set(0);
+        tf.downlink_producer->execute();
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({true, true, true, true}));
+    }
+
+    {
+        TestFixture tf;
+        const std::vector<std::string> sixteen_foo1(16, "foo1");
+        std::vector<DownlinkProducer::FlowData> flow_data = {
+            {1, true, sixteen_foo1}, // Flow size: 514 bits (2 + 512)
+            {2, true, sixteen_foo1},
+            {3, true, sixteen_foo1, 0, 2}
+        };
+        tf.init(flow_data);
+        tf.registry.find_writable_field_t<unsigned char>("downlink.budget")->set(1);
+
+        // Only one flow fits. Flow 3 has the lowest priority, but may only be
+        // left out of two snapshots in a row.
+        tf.downlink_producer->execute();
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({true, false, false}));
+        next_frame(tf);
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({false, true, false}));
+        next_frame(tf);
+        TEST_ASSERT(is_scheduled(tf) == std::vector<bool>({false, false, true}));
+    }
+}
+
 int test_downlink_producer_task() {
     UNITY_BEGIN();
     RUN_TEST(test_task_initialization);
@@ -513,6 +733,9 @@ int test_downlink_producer_task() {
     RUN_TEST(test_shift_priorities);
     RUN_TEST(test_shift_statefield_cmd);
     RUN_TEST(test_toggle);
+    RUN_TEST(test_plan);
+    RUN_TEST(test_delta_flows);
+    RUN_TEST(test_flow_scheduler);
     return UNITY_END();
 }
 
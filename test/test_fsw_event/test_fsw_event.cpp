@@ -153,6 +153,16 @@ void test_event_storage()
     // Test that a field was added to the registry for every single sub-event.
     TEST_ASSERT_EQUAL(99, tf.registry.events.size());
 
+    // The sub-events keep their names, and their data is stored in one contiguous ring.
+    const Event* first = tf.registry.find_event_t("event.1");
+    for (unsigned int i = 0; i < 99; i++)
+    {
+        const Event* sub_event = tf.registry.events[i];
+        TEST_ASSERT_EQUAL_STRING(("event." + std::to_string(i + 1)).c_str(), sub_event->name().c_str());
+        TEST_ASSERT_EQUAL_PTR(&first->get_bit_array() + i, &sub_event->get_bit_array());
+        TEST_ASSERT_EQUAL(32 + 2, sub_event->bitsize());
+    }
+
     // Event storage should behave the same as an event.
     for (int i = 0; i < 200; i++)
     {
@@ -0,0 +1,163 @@
+#include "../StateFieldRegistryMock.hpp"
+#include <fsw/FCCode/MemoryReport.hpp>
+#include <unity.h>
+
+#ifdef DESKTOP
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#endif
+
+/**
+ * @brief A task with fields inside it, and fields that it keeps in a vector.
+ */
+class TestTask : public ControlTask<void> {
+  public:
+    ReadableStateField<unsigned int> count_f;
+    InternalStateField<double> value_f;
+    std::vector<ReadableStateField<bool>> flags_f;
+
+    TestTask(StateFieldRegistry& registry) : ControlTask<void>(registry),
+        count_f("test.count", Serializer<unsigned int>(100)),
+        value_f("test.value")
+    {
+        flags_f.reserve(2);
+        flags_f.emplace_back("test.flag1", Serializer<bool>());
+        flags_f.emplace_back("test.flag2", Serializer<bool>());
+
+        add_readable_field(count_f);
+        add_internal_field(value_f);
+        for (ReadableStateField<bool>& flag_f : flags_f) add_readable_field(flag_f);
+    }
+
+    void execute() override {}
+
+    memory_footprint heap_memory_use() const override {
+        return memory_use_of_fields(flags_f);
+    }
+};
+
+class TestFixture {
+  public:
+    StateFieldRegistryMock registry;
+    std::unique_ptr<TestTask> task;
+    std::unique_ptr<MemoryReport> report;
+
+    TestFixture() : registry() {
+        task = std::make_unique<TestTask>(registry);
+        report = std::make_unique<MemoryReport>(registry);
+        report->add_task("test_task", *task);
+    }
+};
+
+void test_field_footprints() {
+    ReadableStateField<unsigned int> readable_f("f", Serializer<unsigned int>(100));
+    memory_footprint fp = readable_f.memory_use();
+    TEST_ASSERT_EQUAL(sizeof(unsigned int), fp.values);
+    TEST_ASSERT_EQUAL(sizeof(Serializer<unsigned int>), fp.serializers);
+    TEST_ASSERT_EQUAL(sizeof(readable_f), fp.total());
+    TEST_ASSERT_EQUAL(0, fp.heap);
+
+    // Long names are stored on the heap.
+    const std::string name = "a.field.whose.name.is.too.long.to.be.stored.inline";
+    InternalStateField<double> internal_f(name);
+    fp = internal_f.memory_use();
+    TEST_ASSERT_EQUAL(sizeof(double), fp.values);
+    TEST_ASSERT_EQUAL(0, fp.serializers);
+    TEST_ASSERT_TRUE(fp.names > name.size());
+    TEST_ASSERT_EQUAL(fp.names, fp.heap);
+    TEST_ASSERT_EQUAL(sizeof(internal_f) + fp.heap, fp.total());
+
+    // Events are counted as events, including their data.
+    std::vector<ReadableStateFieldBase*> data_fields = {&readable_f};
+    Event event("e", data_fields, nullptr);
+    fp = event.memory_use();
+    TEST_ASSERT_EQUAL(sizeof(event) + sizeof(bit_array), fp.events);
+    TEST_ASSERT_EQUAL(fp.events, fp.total());
+
+    // The fields that control a fault are left out of the fault's footprint.
+    unsigned int cc = 0;
+    Fault fault("f", 1, cc);
+    fp = fault.memory_use();
+    TEST_ASSERT_EQUAL(sizeof(fault), fp.total() - fp.heap + sizeof(fault.suppress_f)
+        + sizeof(fault.override_f) + sizeof(fault.unsignal_f) + sizeof(fault.persistence_f));
+}
+
+void test_fields() {
+    TestFixture tf;
+    std::vector<MemoryReport::Entry> fields = tf.report->fields();
+
+    size_t num_found = 0;
+    memory_footprint total;
+    for (const MemoryReport::Entry& entry : fields) {
+        if (entry.name == "test.count") {
+            num_found++;
+            TEST_ASSERT_EQUAL(tf.task->count_f.memory_use().total(), entry.footprint.total());
+        }
+        if (entry.name == "test.value" || entry.name == "test.flag1") num_found++;
+        total += entry.footprint;
+    }
+    TEST_ASSERT_EQUAL(3, num_found);
+    TEST_ASSERT_EQUAL(total.total(), tf.report->fields_total().total());
+}
+
+void test_tasks() {
+    TestFixture tf;
+    std::vector<MemoryReport::Entry> tasks = tf.report->tasks();
+    TEST_ASSERT_EQUAL(1, tasks.size());
+    TEST_ASSERT_EQUAL_STRING("test_task", tasks[0].name.c_str());
+
+    // The task object is split up by the fields inside it, and the fields that it keeps
+    // in a vector are on the heap.
+    const memory_footprint& fp = tasks[0].footprint;
+    TEST_ASSERT_EQUAL(sizeof(TestTask), fp.total() - fp.heap);
+    TEST_ASSERT_EQUAL(2 * sizeof(ReadableStateField<bool>), fp.heap);
+    TEST_ASSERT_EQUAL(sizeof(unsigned int) + sizeof(double) + 2 * sizeof(bool), fp.values);
+    TEST_ASSERT_EQUAL(sizeof(Serializer<unsigned int>) + 2 * sizeof(Serializer<bool>),
+        fp.serializers);
+}
+
+#ifdef DESKTOP
+void test_write() {
+    TestFixture tf;
+    const char* path = "test_memory_report.csv";
+    TEST_ASSERT_TRUE(tf.report->write(path));
+    std::ifstream in(path);
+    std::stringstream csv;
+    csv << in.rdbuf();
+    std::remove(path);
+
+    TEST_ASSERT_EQUAL(0, csv.str().find(
+        "kind,name,values,serializers,events,flows,names,other,heap,total\n"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, csv.str().find("\nfield,test.count,"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, csv.str().find("\ntask,test_task,"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, csv.str().find("\nshared,print_buffer,"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, csv.str().find("\nshared,cycle_trace,"));
+}
+#endif
+
+int test_memory_report() {
+    UNITY_BEGIN();
+    RUN_TEST(test_field_footprints);
+    RUN_TEST(test_fields);
+    RUN_TEST(test_tasks);
+#ifdef DESKTOP
+    RUN_TEST(test_write);
+#endif
+    return UNITY_END();
+}
+
+#ifdef DESKTOP
+int main() {
+    return test_memory_report();
+}
+#else
+#include <Arduino.h>
+void setup() {
+    delay(2000);
+    Serial.begin(9600);
+    test_memory_report();
+}
+
+void loop() {}
+#endif
@@ -39,6 +39,7 @@ class TestFixture {
     // Input state fields to quake manager
     std::shared_ptr<InternalStateField<char*>> radio_mo_packet_fp;
     std::shared_ptr<InternalStateField<size_t>> snapshot_size_fp;
+    std::shared_ptr<InternalStateField<bool>> snapshot_taken_fp;
 
     // Output state fields from quake manager
     WritableStateField<unsigned int>* max_wait_cycles_fp;
@@ -57,6 +58,7 @@ class TestFixture {
         // Create external field dependencies
         snapshot_size_fp = registry.create_internal_field<size_t>("downlink.snap_size");
         radio_mo_packet_fp = registry.create_internal_field<char*>("downlink.ptr");
+        snapshot_taken_fp = registry.create_internal_field<bool>("downlink.taken");
         // Initialize external fields
         snapshot_size_fp->set(static_cast<int>(350));
         radio_mo_packet_fp->set(snap1);
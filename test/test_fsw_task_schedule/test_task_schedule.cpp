@@ -0,0 +1,210 @@
+#include "../StateFieldRegistryMock.hpp"
+#include <fsw/FCCode/TaskSchedule.hpp>
+#include <fsw/FCCode/ClockManager.hpp>
+#include <unity.h>
+
+#ifdef DESKTOP
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#endif
+
+class TestFixture {
+  public:
+    StateFieldRegistryMock registry;
+    std::shared_ptr<ReadableStateField<unsigned int>> a_exec_p99_fp;
+    std::shared_ptr<ReadableStateField<unsigned int>> b_exec_p99_fp;
+    std::shared_ptr<ReadableStateField<unsigned int>> c_exec_p99_fp;
+    std::unique_ptr<TaskSchedule> schedule;
+    ReadableStateField<unsigned int>* overbudget_fp;
+
+    /**
+     * @brief Three tasks a, b and c that start 1, 3 and 8 ms into a 10 ms control cycle.
+     */
+    TestFixture() : registry() {
+        a_exec_p99_fp = registry.create_readable_field<unsigned int>("timing.a.exec_p99");
+        b_exec_p99_fp = registry.create_readable_field<unsigned int>("timing.b.exec_p99");
+        c_exec_p99_fp = registry.create_readable_field<unsigned int>("timing.c.exec_p99");
+
+        schedule = std::make_unique<TaskSchedule>(registry, std::vector<TaskSchedule::Entry>{
+            {"a", "a_offset", 1000}, {"b", "b_offset", 3000}, {"c", "c_offset", 8000}
+        }, 10000);
+        overbudget_fp = registry.find_readable_field_t<unsigned int>("timing.schedule.overbudget");
+    }
+};
+
+void test_check() {
+    TestFixture tf;
+
+    // The tasks' budgets are 2, 5 and 2 ms.
+    tf.a_exec_p99_fp->set(2000);
+    tf.b_exec_p99_fp->set(4000);
+    tf.c_exec_p99_fp->set(1500);
+    tf.schedule->execute();
+    TEST_ASSERT_EQUAL(0, tf.overbudget_fp->get());
+
+    tf.a_exec_p99_fp->set(2001);
+    tf.c_exec_p99_fp->set(2500);
+    tf.schedule->execute();
+    TEST_ASSERT_EQUAL(2, tf.overbudget_fp->get());
+}
+
+void test_schedule_errors() {
+    TestFixture tf;
+    TEST_ASSERT_EQUAL(0, tf.registry.find_readable_field_t<unsigned int>("timing.schedule.errors")->get());
+
+    // Task b starts after c and d although it runs before them, and task e starts
+    // at the end of the control cycle, so neither has a budget. The budgets of a,
+    // c and d are 2, 1 and 6 ms.
+    StateFieldRegistryMock registry;
+    std::vector<std::shared_ptr<ReadableStateField<unsigned int>>> exec_p99_fps;
+    for (const char* task : {"a", "b", "c", "d", "e"})
+        exec_p99_fps.push_back(registry.create_readable_field<unsigned int>(
+            std::string("timing.") + task + ".exec_p99"));
+    TaskSchedule schedule(registry, {
+        {"a", "a_offset", 1000}, {"b", "b_offset", 6000}, {"c", "c_offset", 3000},
+        {"d", "d_offset", 4000}, {"e", "e_offset", 10000}
+    }, 10000);
+    TEST_ASSERT_EQUAL(2, registry.find_readable_field_t<unsigned int>("timing.schedule.errors")->get());
+
+    const unsigned int costs[] = {2000, 9000, 1000, 6000, 9000};
+    for (size_t i = 0; i < 5; i++) exec_p99_fps[i]->set(costs[i]);
+    schedule.execute();
+    ReadableStateField<unsigned int>* overbudget_fp =
+        registry.find_readable_field_t<unsigned int>("timing.schedule.overbudget");
+    TEST_ASSERT_EQUAL(0, overbudget_fp->get());
+
+    exec_p99_fps[3]->set(6001);
+    schedule.execute();
+    TEST_ASSERT_EQUAL(1, overbudget_fp->get());
+}
+
+void test_solve() {
+    // Budgets are the costs plus 25%, rounded up to 100 us, and at least 100 us.
+    TaskSchedule::Solution solution = TaskSchedule::solve({0, 80, 1000, 1001}, 10000);
+    const unsigned int expected[] = {100, 200, 300, 1600};
+    TEST_ASSERT_EQUAL(4, solution.offsets.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected, solution.offsets.data(), sizeof(expected));
+    TEST_ASSERT_EQUAL(2900, solution.end);
+    TEST_ASSERT_TRUE(solution.feasible);
+
+    TEST_ASSERT_FALSE(TaskSchedule::solve({5000, 4000}, 10000).feasible);
+
+    // A solved schedule fits the costs that it was solved for.
+    TestFixture tf;
+    tf.a_exec_p99_fp->set(5000);
+    tf.b_exec_p99_fp->set(1234);
+    tf.c_exec_p99_fp->set(10);
+    solution = tf.schedule->solve();
+    TEST_ASSERT_TRUE(solution.feasible);
+    TEST_ASSERT_EQUAL(6300, solution.offsets[1] - solution.offsets[0]);
+    TEST_ASSERT_EQUAL(1600, solution.offsets[2] - solution.offsets[1]);
+    TEST_ASSERT_EQUAL(100, solution.end - solution.offsets[2]);
+}
+
+#ifdef DESKTOP
+void test_write_header() {
+    TestFixture tf;
+    tf.a_exec_p99_fp->set(5000);
+    tf.b_exec_p99_fp->set(1234);
+    tf.c_exec_p99_fp->set(10);
+
+    const char* path = "test_task_offsets.hpp";
+    TEST_ASSERT_TRUE(tf.schedule->write_header(path, 100));
+    std::ifstream in(path);
+    std::stringstream header;
+    header << in.rdbuf();
+    std::remove(path);
+
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, header.str().find(
+        "TRACKED_CONSTANT_SC(unsigned int, a_offset, 100); // p99 execution time: 5000 us\n"
+        "TRACKED_CONSTANT_SC(unsigned int, b_offset, 6400); // p99 execution time: 1234 us\n"
+        "TRACKED_CONSTANT_SC(unsigned int, c_offset, 8000); // p99 execution time: 10 us\n"));
+
+    // Costs that don't fit in the control cycle don't produce a header.
+    tf.c_exec_p99_fp->set(5000);
+    TEST_ASSERT_FALSE(tf.schedule->write_header(path, 100));
+}
+
+/**
+ * @brief Task that takes a given time to execute, on the virtual clock.
+ */
+class CostlyTask : public TimedControlTask<void> {
+  public:
+    CostlyTask(StateFieldRegistry& registry, const std::string& name, unsigned int offset) :
+      TimedControlTask<void>(registry, name, offset) {}
+
+    unsigned int cost = 0;
+    void execute() override {
+      wait_duration(cost);
+    }
+};
+
+void test_calibration() {
+    TimedControlTaskBase::use_virtual_clock(true);
+    StateFieldRegistryMock registry;
+    ClockManager clock_manager(registry, 10000 * 1000);
+    CostlyTask a(registry, "a", 1000);
+    CostlyTask b(registry, "b", 5000);
+    TaskSchedule schedule(registry, {
+        {"a", "a_offset", 1000, &a}, {"b", "b_offset", 5000, &b}
+    }, 10000);
+    ReadableStateField<unsigned int>* a_exec_p99_fp =
+        registry.find_readable_field_t<unsigned int>("timing.a.exec_p99");
+    ReadableStateField<unsigned int>* a_exec_max_fp =
+        registry.find_readable_field_t<unsigned int>("timing.a.exec_max");
+    const auto run = [&](unsigned int cycles) {
+        for (unsigned int i = 0; i < cycles; i++) {
+            clock_manager.execute();
+            a.execute_on_time();
+            b.execute_on_time();
+        }
+    };
+
+    // Task a is slow in the first cycles, whose execution time is published.
+    a.cost = 4000;
+    b.cost = 2000;
+    run(3);
+    TEST_ASSERT_EQUAL(4000, a_exec_p99_fp->get());
+
+    // Calibration leaves those cycles out, and doesn't wait for the execution times
+    // since then to be published.
+    schedule.start_calibration();
+    TEST_ASSERT_EQUAL(0, a_exec_max_fp->get());
+    a.cost = 1000;
+    run(TimedControlTaskBase::timing_publish_period / 2);
+    const TaskSchedule::Solution solution = schedule.solve();
+    TEST_ASSERT_EQUAL(1000, a_exec_p99_fp->get());
+    TEST_ASSERT_EQUAL(1300, solution.offsets[1] - solution.offsets[0]);
+    TEST_ASSERT_EQUAL(2500, solution.end - solution.offsets[1]);
+
+    TimedControlTaskBase::use_virtual_clock(false);
+}
+#endif
+
+int test_task_schedule() {
+    UNITY_BEGIN();
+    RUN_TEST(test_check);
+    RUN_TEST(test_schedule_errors);
+    RUN_TEST(test_solve);
+#ifdef DESKTOP
+    RUN_TEST(test_write_header);
+    RUN_TEST(test_calibration);
+#endif
+    return UNITY_END();
+}
+
+#ifdef DESKTOP
+int main() {
+    return test_task_schedule();
+}
+#else
+#include <Arduino.h>
+void setup() {
+    delay(2000);
+    Serial.begin(9600);
+    test_task_schedule();
+}
+
+void loop() {}
+#endif
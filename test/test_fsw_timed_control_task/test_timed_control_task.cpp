@@ -67,6 +67,15 @@ class TestFixture {
         if(!num_lates_fp_2) assert(false);
         if(!avg_wait_fp_1) assert(false);
         if(!avg_wait_fp_2) assert(false);
+
+        for (const char* task : {"dummy1", "dummy2"}) {
+            for (const char* stat : {"jitter", "exec"}) {
+                for (const char* suffix : {"_p50", "_p99", "_max"}) {
+                    const std::string name = std::string("timing.") + task + "." + stat + suffix;
+                    TEST_ASSERT_NOT_NULL(registry.find_readable_field_t<unsigned int>(name));
+                }
+            }
+        }
     }
 
     /**
@@ -149,10 +158,27 @@ void test_task_execute() {
     TEST_ASSERT_LESS_OR_EQUAL(4000, t_delta - expected_duration);
 }
 
+void test_task_timing_statistics() {
+    TestFixture tf;
+    for(int i = 0; i < 10; i++) tf.execute();
+
+    // Percentiles are ordered, and the tasks start on time.
+    for (const char* stat : {"jitter", "exec"}) {
+        const std::string prefix = std::string("timing.dummy1.") + stat;
+        const unsigned int p50 = tf.registry.find_readable_field_t<unsigned int>(prefix + "_p50")->get();
+        const unsigned int p99 = tf.registry.find_readable_field_t<unsigned int>(prefix + "_p99")->get();
+        const unsigned int max = tf.registry.find_readable_field_t<unsigned int>(prefix + "_max")->get();
+        TEST_ASSERT_LESS_OR_EQUAL(p99, p50);
+        TEST_ASSERT_LESS_OR_EQUAL(max, p99);
+        TEST_ASSERT_LESS_OR_EQUAL(1000, max);
+    }
+}
+
 int test_timed_control_task() {
     UNITY_BEGIN();
     RUN_TEST(test_task_initialization);
     RUN_TEST(test_task_execute);
+    RUN_TEST(test_task_timing_statistics);
     return UNITY_END();
 }
 
@@ -0,0 +1,100 @@
+#include <fsw/FCCode/TimingHistogram.hpp>
+#include <unity.h>
+
+void test_buckets() {
+    // Small durations each get their own bucket.
+    for (unsigned int us = 0; us < TimingHistogram::sub_buckets; us++) {
+        TEST_ASSERT_EQUAL(us, TimingHistogram::bucket(us));
+        TEST_ASSERT_EQUAL(us, TimingHistogram::bucket_upper_bound(us));
+    }
+
+    // Buckets are contiguous, and each covers at most 1/sub_buckets of its durations.
+    size_t prev = TimingHistogram::bucket(TimingHistogram::sub_buckets - 1);
+    for (unsigned int us = TimingHistogram::sub_buckets; us < (1u << TimingHistogram::max_value_bits); us++) {
+        const size_t b = TimingHistogram::bucket(us);
+        TEST_ASSERT_TRUE(b == prev || b == prev + 1);
+        if (b != prev) TEST_ASSERT_EQUAL(us - 1, TimingHistogram::bucket_upper_bound(prev));
+        TEST_ASSERT_TRUE(us <= TimingHistogram::bucket_upper_bound(b));
+        TEST_ASSERT_TRUE(TimingHistogram::bucket_upper_bound(b) - us < us / TimingHistogram::sub_buckets + 1);
+        prev = b;
+    }
+    TEST_ASSERT_EQUAL(TimingHistogram::num_buckets - 1, prev);
+
+    // Large durations go in the last bucket.
+    TEST_ASSERT_EQUAL(TimingHistogram::num_buckets - 1, TimingHistogram::bucket(0xffffffff));
+}
+
+void test_percentiles() {
+    TimingHistogram h;
+    TEST_ASSERT_EQUAL(0, h.count());
+    TEST_ASSERT_EQUAL(0, h.percentile(50));
+    TEST_ASSERT_EQUAL(0, h.max());
+
+    // 1, 2, ..., 100 microseconds.
+    for (unsigned int us = 1; us <= 100; us++) h.record(us);
+    TEST_ASSERT_EQUAL(100, h.count());
+    TEST_ASSERT_EQUAL(100, h.max());
+    TEST_ASSERT_EQUAL(1, h.percentile(0));
+    TEST_ASSERT_EQUAL(TimingHistogram::bucket_upper_bound(TimingHistogram::bucket(50)), h.percentile(50));
+    TEST_ASSERT_UINT32_WITHIN(50 / TimingHistogram::sub_buckets, 50, h.percentile(50));
+    TEST_ASSERT_UINT32_WITHIN(99 / TimingHistogram::sub_buckets, 99, h.percentile(99));
+    TEST_ASSERT_EQUAL(100, h.percentile(100));
+
+    // A single slow outlier shows up in the maximum but not in the median.
+    h.record(5000000);
+    TEST_ASSERT_EQUAL(5000000, h.max());
+    TEST_ASSERT_UINT32_WITHIN(50 / TimingHistogram::sub_buckets, 50, h.percentile(50));
+    TEST_ASSERT_EQUAL(5000000, h.percentile(100));
+}
+
+void test_multiple_percentiles() {
+    TimingHistogram h;
+    const unsigned int pcts[4] = {0, 50, 99, 100};
+    unsigned int values[4];
+    h.percentiles(pcts, values, 4);
+    for (unsigned int value : values) TEST_ASSERT_EQUAL(0, value);
+
+    // A single scan gives the same percentiles as one scan per percentile.
+    for (unsigned int us = 1; us <= 1000; us += 7) h.record(us);
+    h.record(300000);
+    h.percentiles(pcts, values, 4);
+    for (size_t i = 0; i < 4; i++) TEST_ASSERT_EQUAL(h.percentile(pcts[i]), values[i]);
+}
+
+void test_full_bucket() {
+    // Filling a bucket halves every count, which keeps the percentiles.
+    TimingHistogram h;
+    for (unsigned int i = 0; i < 3 * 65535u; i++) {
+        h.record(10);
+        if (i % 3 == 0) h.record(1000);
+    }
+    TEST_ASSERT_LESS_THAN(65536 + 65536 / 3 + 1, h.count());
+    TEST_ASSERT_GREATER_THAN(65535 / 2, h.count());
+    TEST_ASSERT_EQUAL(TimingHistogram::bucket_upper_bound(TimingHistogram::bucket(10)), h.percentile(50));
+    TEST_ASSERT_EQUAL(1000, h.percentile(99));
+    TEST_ASSERT_EQUAL(1000, h.max());
+}
+
+int test_timing_histogram() {
+    UNITY_BEGIN();
+    RUN_TEST(test_buckets);
+    RUN_TEST(test_percentiles);
+    RUN_TEST(test_multiple_percentiles);
+    RUN_TEST(test_full_bucket);
+    return UNITY_END();
+}
+
+#ifdef DESKTOP
+int main() {
+    return test_timing_histogram();
+}
+#else
+#include <Arduino.h>
+void setup() {
+    delay(2000);
+    Serial.begin(9600);
+    test_timing_histogram();
+}
+
+void loop() {}
+#endif
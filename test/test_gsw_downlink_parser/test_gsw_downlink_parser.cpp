@@ -1,6 +1,11 @@
 #include "DownlinkParserMock.hpp"
+#include <gsw/parsers/src/DownlinkBatchParser.hpp>
+#include <gsw/parsers/src/TelemetryArchive.hpp>
+#include <gsw/parsers/src/TelemetryInfoGenerator.hpp>
+#include <flow_data.hpp>
 #include <unity.h>
 #include <fstream>
+#include <sstream>
 #include "../StateFieldRegistryMock.hpp"
 
 // This print function is used to instantiate an event. The event will be used for testing reading
@@ -21,6 +26,7 @@ class TestFixture {
     std::unique_ptr<DownlinkParserMock> parser;
     ReadableStateField<unsigned int>* cycle_count_fp;
     static const std::vector<DownlinkProducer::FlowData> flow_data;
+    static const std::vector<DownlinkProducer::FlowData> delta_flow_data;
     DownlinkProducer* producer;
 
     // Flow field inputs
@@ -34,8 +40,9 @@ class TestFixture {
     // Parsing outputs
     InternalStateField<char*>* snapshot_fp;
     InternalStateField<size_t>* snapshot_size_bytes_fp;
+    InternalStateField<bool>* snapshot_taken_fp;
 
-    TestFixture() : reg(),
+    TestFixture(const std::vector<DownlinkProducer::FlowData>& fd = flow_data) : reg(),
         data1_f("data1", Serializer<bool>()),
         event_data({&data1_f}),
         event("event", event_data, print_fn)
@@ -48,7 +55,7 @@ class TestFixture {
         reg.add_readable_field(static_cast<ReadableStateFieldBase*>(&data1_f));
         reg.add_event(&event);
 
-        parser = std::make_unique<DownlinkParserMock>(reg, flow_data);
+        parser = std::make_unique<DownlinkParserMock>(reg, fd);
         producer = parser->get_downlink_producer();
         cycle_count_fp = reg.find_readable_field_t<unsigned int>("pan.cycle_no");
         assert(cycle_count_fp);
@@ -60,6 +67,7 @@ class TestFixture {
 
         snapshot_fp = reg.find_internal_field_t<char*>("downlink.ptr");
         snapshot_size_bytes_fp = reg.find_internal_field_t<size_t>("downlink.snap_size");
+        snapshot_taken_fp = reg.find_internal_field_t<bool>("downlink.taken");
         assert(snapshot_fp);
         assert(snapshot_size_bytes_fp);
     }
@@ -76,6 +84,18 @@ const std::vector<DownlinkProducer::FlowData> TestFixture::flow_data = {
     }
 };
 
+const std::vector<DownlinkProducer::FlowData> TestFixture::delta_flow_data = {
+    {
+        1,
+        true,
+        {
+            "foo1",
+            "event"
+        },
+        4
+    }
+};
+
 void test_task_initialization() {
     TestFixture tf;
 }
@@ -105,9 +125,217 @@ void test_task_execute() {
 }
 
 
+void test_delta_flows() {
+    TestFixture tf(TestFixture::delta_flow_data);
+
+    // Simulates transmitting a snapshot to the ground.
+    auto downlink = [&]() {
+        tf.producer->execute();
+        tf.snapshot_taken_fp->set(true);
+        return tf.parser->process_downlink(
+            tf.snapshot_fp->get(), tf.snapshot_size_bytes_fp->get());
+    };
+
+    // The first snapshot is a keyframe.
+    json keyframe = downlink();
+    TEST_ASSERT_FALSE(keyframe["metadata"]["error"]);
+    const size_t keyframe_size = tf.snapshot_size_bytes_fp->get();
+
+    // Nothing but the cycle count changed, so the next snapshot is smaller. The
+    // parser rebuilds the full flow from the keyframe.
+    tf.cycle_count_fp->set(41);
+    json delta = downlink();
+    TEST_ASSERT_LESS_THAN(keyframe_size, tf.snapshot_size_bytes_fp->get());
+    TEST_ASSERT_FALSE(delta["metadata"]["error"]);
+    TEST_ASSERT_EQUAL_STRING("41", delta["data"]["pan.cycle_no"].get<std::string>().c_str());
+    keyframe["data"]["pan.cycle_no"] = "41";
+    keyframe["metadata"]["cycle_no"] = 41;
+    TEST_ASSERT_TRUE(keyframe == delta);
+
+    // A changed field is sent and parsed.
+    tf.foo1_fp->set(500);
+    delta = downlink();
+    TEST_ASSERT_LESS_THAN(keyframe_size, tf.snapshot_size_bytes_fp->get());
+    TEST_ASSERT_EQUAL_STRING("500", delta["data"]["foo1"].get<std::string>().c_str());
+    TEST_ASSERT_EQUAL(20, delta["data"]["event"]["control_cycle_number"]);
+
+    // A parser that missed the keyframe reports it, and still parses the
+    // fields that are in the frame.
+    TestFixture tf2(TestFixture::delta_flow_data);
+    tf2.producer->execute();
+    tf2.snapshot_taken_fp->set(true);
+    tf2.foo1_fp->set(500);
+    tf2.producer->execute();
+    const json missed = tf2.parser->process_downlink(
+        tf2.snapshot_fp->get(), tf2.snapshot_size_bytes_fp->get());
+    TEST_ASSERT_EQUAL_STRING("no keyframe for flow ID: 1",
+        missed["metadata"]["error"].get<std::string>().c_str());
+    TEST_ASSERT_EQUAL_STRING("500", missed["data"]["foo1"].get<std::string>().c_str());
+    TEST_ASSERT_EQUAL(0, missed["data"].count("event"));
+
+    // The keyframe period runs out after one more delta.
+    downlink();
+    TEST_ASSERT_FALSE(downlink()["metadata"]["error"]);
+    TEST_ASSERT_EQUAL(keyframe_size, tf.snapshot_size_bytes_fp->get());
+
+    // A delta based on a snapshot that the Quake Manager took but that never reached
+    // the ground is rejected, rather than filled in with stale values.
+    tf.foo1_fp->set(600);
+    tf.producer->execute();
+    tf.snapshot_taken_fp->set(true);
+    tf.foo1_fp->set(700);
+    json mismatch = downlink();
+    TEST_ASSERT_LESS_THAN(keyframe_size, tf.snapshot_size_bytes_fp->get());
+    TEST_ASSERT_EQUAL_STRING("delta reference mismatch for flow ID: 1",
+        mismatch["metadata"]["error"].get<std::string>().c_str());
+    TEST_ASSERT_EQUAL_STRING("700", mismatch["data"]["foo1"].get<std::string>().c_str());
+    TEST_ASSERT_EQUAL(0, mismatch["data"].count("event"));
+
+    // Later deltas are rejected too, until the next keyframe.
+    tf.foo1_fp->set(800);
+    mismatch = downlink();
+    TEST_ASSERT_EQUAL_STRING("no keyframe for flow ID: 1",
+        mismatch["metadata"]["error"].get<std::string>().c_str());
+    TEST_ASSERT_EQUAL(0, mismatch["data"].count("event"));
+}
+
+void test_invalid_flow_id() {
+    // With two flows, flow IDs take two bits, so the frame can name a flow ID of 3.
+    const std::vector<DownlinkProducer::FlowData> two_flows = {
+        {1, true, {"foo1"}},
+        {2, false, {"event"}}
+    };
+    TestFixture tf(two_flows);
+    tf.producer->execute();
+    std::vector<char> snapshot(tf.snapshot_fp->get(),
+        tf.snapshot_fp->get() + tf.snapshot_size_bytes_fp->get());
+
+    // The flow ID follows the packet header bit and the cycle count. Change it from
+    // 1 to 3.
+    snapshot[4] |= 0x20;
+    const json downlink = tf.parser->process_downlink(snapshot.data(), snapshot.size());
+    TEST_ASSERT_EQUAL_STRING("flow ID invalid: 3",
+        downlink["metadata"]["error"].get<std::string>().c_str());
+}
+
+void test_batch_parser() {
+    // Packets are grouped into frames by their first bit, and the last frame
+    // ends with the packets. Empty packets are skipped.
+    const std::vector<std::vector<char>> packets = {
+        {}, {'\x80', '\x01'}, {'\x00', '\x02'}, {}, {'\x80', '\x03'}, {'\x00'}};
+    const std::vector<std::vector<char>> frames = DownlinkBatchParser::group_frames(packets);
+    TEST_ASSERT_EQUAL(2, frames.size());
+    TEST_ASSERT(frames[0] == std::vector<char>({'\x80', '\x01', '\x00', '\x02'}));
+    TEST_ASSERT(frames[1] == std::vector<char>({'\x80', '\x03', '\x00'}));
+
+    // Frames parsed on several threads are written in order, and match the
+    // output of a single parser.
+    StateFieldRegistryMock reg;
+    DownlinkParserMock parser(reg, PAN::flow_data);
+    DownlinkProducer* producer = parser.get_downlink_producer();
+    ReadableStateField<unsigned int>* cycle_count_fp =
+        reg.find_readable_field_t<unsigned int>("pan.cycle_no");
+    InternalStateField<char*>* snapshot_fp = reg.find_internal_field_t<char*>("downlink.ptr");
+    InternalStateField<size_t>* snapshot_size_bytes_fp =
+        reg.find_internal_field_t<size_t>("downlink.snap_size");
+
+    std::vector<std::vector<char>> snapshots;
+    std::string expected_output;
+    for (unsigned int i = 0; i < 1000; i++) {
+        cycle_count_fp->set(i);
+        producer->execute();
+        snapshots.emplace_back(snapshot_fp->get(),
+            snapshot_fp->get() + snapshot_size_bytes_fp->get());
+        expected_output += parser.process_downlink(
+            snapshot_fp->get(), snapshot_size_bytes_fp->get()).dump() + "\n";
+    }
+
+    DownlinkBatchParser batch_parser(PAN::flow_data, 3);
+    TEST_ASSERT_EQUAL(3, batch_parser.num_threads());
+    std::ostringstream output;
+    TEST_ASSERT_EQUAL(1000, batch_parser.process_frames(
+        DownlinkBatchParser::group_frames(snapshots), output));
+    TEST_ASSERT_TRUE(expected_output == output.str());
+
+    // Delta flows are parsed on one thread.
+    std::vector<DownlinkProducer::FlowData> delta_flow_data = PAN::flow_data;
+    delta_flow_data[0].keyframe_period = 2;
+    TEST_ASSERT_EQUAL(1, DownlinkBatchParser(delta_flow_data, 3).num_threads());
+}
+
+void test_telemetry_archive() {
+    StateFieldRegistryMock reg;
+    DownlinkParserMock parser(reg, PAN::flow_data);
+    DownlinkProducer* producer = parser.get_downlink_producer();
+    ReadableStateField<unsigned int>* cycle_count_fp =
+        reg.find_readable_field_t<unsigned int>("pan.cycle_no");
+    WritableStateField<unsigned char>* state_fp =
+        reg.find_writable_field_t<unsigned char>("pan.state");
+    ReadableStateField<bool>* docked_fp = reg.find_readable_field_t<bool>("docksys.docked");
+    InternalStateField<char*>* snapshot_fp = reg.find_internal_field_t<char*>("downlink.ptr");
+    InternalStateField<size_t>* snapshot_size_bytes_fp =
+        reg.find_internal_field_t<size_t>("downlink.snap_size");
+
+    std::vector<std::vector<char>> snapshots;
+    for (unsigned int i = 0; i < 100; i++) {
+        cycle_count_fp->set(1000 + i);
+        state_fp->set(i % 12);
+        docked_fp->set(i % 3 == 0);
+        producer->execute();
+        snapshots.emplace_back(snapshot_fp->get(),
+            snapshot_fp->get() + snapshot_size_bytes_fp->get());
+    }
+
+    // Write the frames to an archive.
+    const std::string directory = "/tmp/test_telemetry_archive";
+    {
+        TelemetryInfoGenerator gen(PAN::flow_data);
+        TelemetryArchiveWriter archive(directory, gen.generate_telemetry_info());
+        DownlinkBatchParser batch_parser(PAN::flow_data, 1);
+        TEST_ASSERT_EQUAL(100, batch_parser.process_frames(
+            DownlinkBatchParser::group_frames(snapshots), archive));
+        TEST_ASSERT_TRUE(archive.close());
+        TEST_ASSERT_EQUAL(100, archive.num_frames());
+    }
+
+    // Columns are typed by the telemetry info, and range queries return only the
+    // rows in the range.
+    TelemetryArchiveReader archive(directory);
+    TEST_ASSERT_TRUE(archive.good());
+    TEST_ASSERT_EQUAL(100, archive.column("frames")->rows);
+    TEST_ASSERT_EQUAL_STRING("unsigned char", archive.column("pan.state")->type.c_str());
+    const std::string pos_type = archive.schema()["fields"]["orbit.pos"]["type"];
+    TEST_ASSERT_EQUAL_STRING("double vector", pos_type.c_str());
+
+    std::vector<unsigned int> cycles;
+    std::vector<unsigned char> states;
+    TEST_ASSERT_TRUE(archive.read("pan.state", 1010, 1019, cycles, states));
+    TEST_ASSERT_EQUAL(10, cycles.size());
+    for (unsigned int i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL(1010 + i, cycles[i]);
+        TEST_ASSERT_EQUAL((10 + i) % 12, states[i]);
+    }
+
+    std::vector<char> docked_bytes;
+    TEST_ASSERT_TRUE(archive.read("docksys.docked", 0, 1002, cycles, docked_bytes));
+    TEST_ASSERT_EQUAL(3, docked_bytes.size());
+    TEST_ASSERT_EQUAL(1, docked_bytes[0]);
+    TEST_ASSERT_EQUAL(0, docked_bytes[1]);
+
+    // Reads fail for fields without a column and for values of the wrong type.
+    std::vector<unsigned int> wide_states;
+    TEST_ASSERT_FALSE(archive.read("pan.state", 0, 2000, cycles, wide_states));
+    TEST_ASSERT_NULL(archive.column("pan.not_a_field"));
+
+}
+
 int main() {
     UNITY_BEGIN();
     RUN_TEST(test_task_initialization);
     RUN_TEST(test_task_execute);
+    RUN_TEST(test_delta_flows);
+    RUN_TEST(test_invalid_flow_id);
+    RUN_TEST(test_batch_parser);
+    RUN_TEST(test_telemetry_archive);
     return UNITY_END();
 }
@@ -102,6 +102,44 @@ void test_invalid_values()
     TEST_ASSERT_THROW(tf.uplink_producer->create_from_json(bs, "test/test_gsw_uplink_producer/test_3.json"));
 }
 
+// Test that batches of command sets are compiled into valid messages
+void test_compile_batch()
+{
+    using json = nlohmann::json;
+    TestFixture tf;
+    json j1, j2;
+    std::ifstream fs1 ("test/test_gsw_uplink_producer/test_1.json");
+    std::ifstream fs2 ("test/test_gsw_uplink_producer/test_2.json");
+    fs1 >> j1;
+    fs2 >> j2;
+
+    // The second command set overrides the first, so one message is enough
+    UplinkProducer::Batch batch = tf.uplink_producer->compile_batch({j1, j2});
+    TEST_ASSERT_EQUAL(1, batch.messages.size());
+    TEST_ASSERT_EQUAL(1, batch.min_messages);
+
+    // Overwrite the fields so that the check only passes if the message sets them
+    tf.uplink_producer->compile_batch({j1});
+    bitstream bs(batch.messages[0].data(), batch.messages[0].size());
+    tf.uplink_producer->_update_fields(bs);
+    tf.check_json_registry("test/test_gsw_uplink_producer/test_2.json");
+
+    // Commands that don't fit into one message are split across messages
+    batch = tf.uplink_producer->compile_batch({j1}, 2);
+    TEST_ASSERT_TRUE(batch.messages.size() > 1);
+    TEST_ASSERT_TRUE(batch.messages.size() >= batch.min_messages);
+    tf.uplink_producer->compile_batch({j2});
+    for (size_t i = 0; i < batch.messages.size(); ++i) {
+        TEST_ASSERT_EQUAL((16 - batch.free_bits[i] + 7) / 8, batch.messages[i].size());
+        bitstream bs_i(batch.messages[i].data(), batch.messages[i].size());
+        tf.uplink_producer->_update_fields(bs_i);
+    }
+    tf.check_json_registry("test/test_gsw_uplink_producer/test_1.json");
+
+    // Unknown fields are rejected
+    TEST_ASSERT_THROW(tf.uplink_producer->compile_batch({json{{"not.a.field", 1}}}));
+}
+
 int main() {
     UNITY_BEGIN();
     RUN_TEST(test_task_initialization);
@@ -110,5 +148,6 @@ int main() {
     RUN_TEST(test_to_file_invalid);
     RUN_TEST(test_create_sbd_from_json);
     RUN_TEST(test_invalid_values);
+    RUN_TEST(test_compile_batch);
     return UNITY_END();
 }
@@ -0,0 +1,80 @@
+"""
+Converts a cycle trace written by the flight software (see src/fsw/FCCode/CycleTrace.hpp)
+into a Chrome trace, which can be opened in chrome://tracing or https://ui.perfetto.dev.
+
+    python tools/cycle_trace_to_chrome.py cycle_trace.bin cycle_trace.json
+"""
+import json
+import struct
+import sys
+
+TASK_START, TASK_END, CYCLE_START = 0, 1, 2
+
+
+def read_trace(path):
+    """Returns the task names and the (time_us, task, kind) events of a cycle trace."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    magic, version, num_tasks = struct.unpack_from('<4sII', data, 0)
+    if magic != b'PTRC' or version != 1:
+        raise ValueError(f"{path} is not a version 1 cycle trace")
+    offset = 12
+
+    names = []
+    for _ in range(num_tasks):
+        (length,) = struct.unpack_from('<H', data, offset)
+        names.append(data[offset + 2:offset + 2 + length].decode())
+        offset += 2 + length
+
+    (num_events,) = struct.unpack_from('<I', data, offset)
+    offset += 4
+    events = [struct.unpack_from('<IHBx', data, offset + 8 * i) for i in range(num_events)]
+    return names, events
+
+
+def to_chrome_trace(names, events):
+    """Converts the events of a cycle trace into Chrome trace events."""
+    trace_events = []
+    open_tasks = set()
+    time_offset = 0
+    prev_time = None
+    cycle = None
+
+    for time_us, task, kind in events:
+        # Timestamps wrap around every 2^32 microseconds.
+        if prev_time is not None and time_us < prev_time:
+            time_offset += 1 << 32
+        prev_time = time_us
+        ts = time_us + time_offset
+
+        if kind == CYCLE_START:
+            # Only the low 16 bits of the cycle count are recorded.
+            if cycle is None:
+                cycle = task
+            else:
+                cycle += (task - cycle) & 0xffff
+            trace_events.append({"name": f"cycle {cycle}", "ph": "i", "s": "g",
+                                 "ts": ts, "pid": 1, "tid": 1})
+            continue
+
+        name = names[task] if task < len(names) else f"task {task}"
+        if kind == TASK_START:
+            open_tasks.add(task)
+            trace_events.append({"name": name, "ph": "B", "ts": ts, "pid": 1, "tid": 1})
+        elif kind == TASK_END and task in open_tasks:
+            # Ends whose starts were overwritten in the ring are dropped.
+            open_tasks.remove(task)
+            trace_events.append({"name": name, "ph": "E", "ts": ts, "pid": 1, "tid": 1})
+
+    return {"traceEvents": trace_events, "displayTimeUnit": "ms"}
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+
+    names, events = read_trace(sys.argv[1])
+    with open(sys.argv[2], 'w') as f:
+        json.dump(to_chrome_trace(names, events), f)
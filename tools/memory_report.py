@@ -0,0 +1,13 @@
+"""
+PlatformIO script that writes a report of the memory used by each state field and
+control task after the desktop flight software is built. The native binary is run with
+--memory-report, which writes the report to memory_report.csv in the build directory
+and exits. See src/fsw/FCCode/MemoryReport.hpp.
+"""
+Import("env")
+
+env.AddPostAction(
+    "$BUILD_DIR/${PROGNAME}$PROGSUFFIX",
+    env.VerboseAction(
+        '"$BUILD_DIR/${PROGNAME}$PROGSUFFIX" --memory-report "$BUILD_DIR/memory_report.csv"',
+        "Writing memory report to $BUILD_DIR/memory_report.csv"))